@@ -0,0 +1,748 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+#include "intent_recognizer/stdafx.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <ajv.h>
+#include <intentapi_cxx.h>
+
+#include "catch2/catch_amalgamated.hpp"
+
+#include "integer_entity.h"
+#include "intent_match_result.h"
+#include "intent_recognizer.h"
+#include "list_entity.h"
+#include "pattern_matching_intent.h"
+#include "pattern_matching_model.h"
+#include "substrings_matcher.h"
+
+using namespace Microsoft::SpeechSDK::Standalone::Intent::Impl;
+
+// These are hidden from the default run, use "[benchmark]" on the command line to run them. Build in Release.
+
+namespace {
+
+const std::vector<std::string> BenchmarkVerbs = { "open", "close", "start", "stop", "show", "hide", "play", "pause" };
+const std::vector<std::string> BenchmarkObjects = { "the window", "the door", "the settings", "the music", "my calendar", "the lights", "the oven", "the garage" };
+
+std::shared_ptr<CSpxPatternMatchingModel> CreateBenchmarkModel()
+{
+    auto model = std::make_shared<CSpxPatternMatchingModel>("benchmark");
+    model->Init("en-US");
+
+    int index = 0;
+    for (auto& verb : BenchmarkVerbs)
+    {
+        for (auto& object : BenchmarkObjects)
+        {
+            auto intentId = verb + std::to_string(index++);
+            auto intent = std::make_shared<CSpxPatternMatchingIntent>();
+            intent->Init(intentId, 0, "en");
+            intent->AddPhrase(verb + " " + object + " [please]");
+            intent->AddPhrase(verb + " " + object + " in {room}");
+            intent->AddPhrase("please " + verb + " " + object + " at {time}");
+            intent->AddPhrase("(can|could|would) you " + verb + " {thing} [for me]");
+            model->AddIntent(intent, intentId);
+        }
+    }
+    return model;
+}
+
+std::vector<std::string> CreateBenchmarkUtterances()
+{
+    std::vector<std::string> utterances;
+    for (auto& verb : BenchmarkVerbs)
+    {
+        for (auto& object : BenchmarkObjects)
+        {
+            utterances.push_back(verb + " " + object + " please");
+            utterances.push_back(verb + " " + object + " in the living room");
+            utterances.push_back("could you " + verb + " " + object + " for me");
+            utterances.push_back("something else entirely");
+        }
+    }
+    return utterances;
+}
+
+// Runs FindMatches over all utterances on the given number of threads and returns the matches per second.
+double MeasureFindMatches(CSpxPatternMatchingModel& model, const std::vector<std::string>& utterances, unsigned int threadCount, size_t iterations)
+{
+    std::atomic<size_t> matchCount{ 0 };
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&]()
+            {
+                size_t localCount = 0;
+                for (size_t i = 0; i < iterations; i++)
+                {
+                    for (auto& utterance : utterances)
+                    {
+                        localCount += model.FindMatches(utterance).size();
+                    }
+                }
+                matchCount += localCount;
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matchCount > 0);
+    return (threadCount * iterations * utterances.size()) / elapsed;
+}
+
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::FindMatches thread scaling", "[.][benchmark]")
+{
+    auto model = CreateBenchmarkModel();
+    auto utterances = CreateBenchmarkUtterances();
+    const size_t iterations = 50;
+
+    auto maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    SECTION("Readers only")
+    {
+        double singleThreaded = 0;
+        for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+        {
+            auto throughput = MeasureFindMatches(*model, utterances, threadCount, iterations);
+            if (threadCount == 1)
+            {
+                singleThreaded = throughput;
+            }
+            std::cout << std::fixed << std::setprecision(0)
+                << "FindMatches, " << threadCount << " thread(s): " << throughput << " utterances/s"
+                << std::setprecision(2) << ", speedup " << throughput / singleThreaded << "x\n";
+        }
+    }
+
+    SECTION("Readers with a concurrent writer")
+    {
+        // Readers keep going on their snapshot while intents are added.
+        std::atomic<bool> done{ false };
+        std::thread writer([&]()
+            {
+                int index = 0;
+                while (!done)
+                {
+                    auto intentId = "added" + std::to_string(index++);
+                    auto intent = std::make_shared<CSpxPatternMatchingIntent>();
+                    intent->Init(intentId, 0, "en");
+                    intent->AddPhrase("turn " + std::to_string(index) + " {thing}");
+                    model->AddIntent(intent, intentId);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            });
+
+        auto throughput = MeasureFindMatches(*model, utterances, maxThreads, iterations);
+        done = true;
+        writer.join();
+
+        std::cout << std::fixed << std::setprecision(0)
+            << "FindMatches with writer, " << maxThreads << " thread(s): " << throughput << " utterances/s\n";
+    }
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::SubstringsMatcher lookup", "[.][benchmark]")
+{
+    // The same substrings the French punctuation handling looks for.
+    const SubstringsMatcher punctuation{
+        "!", "?", ";", ":", "\u2236", "%", "\u066A", "\uFE6A", "\uFF05", "\u0609", "\u2030", "$", "\uFE69", "\uFF04",
+        "\u00A3", "\u20A4", "\u00A5", "\uFFE5", "\u20A9", "\uFFE6", "\u20A8", "\u20B9", "#", "\u00AB", "\u00BB" };
+
+    const std::vector<std::string> inputs = {
+        "quelle heure est-il \u00E0 Paris ?",
+        "ouvre la fen\u00EAtre de la cuisine s'il te pla\u00EEt",
+        "r\u00E8gle le thermostat \u00E0 vingt et un degr\u00E9s",
+        "combien co\u00FBte un billet : 25 \u20AC ou 30 $ ?",
+        "\u00AB bonjour \u00BB dit-il ; puis il est parti !" };
+
+    const size_t iterations = 200000;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& input : inputs)
+        {
+            // Walk the whole input the way AddLeadingPunctuationSpaceFR does.
+            std::string found;
+            size_t index = 0;
+            while ((index = punctuation.Find(input, index, &found)) != SubstringsMatcher::NO_MATCH)
+            {
+                index += found.length();
+                matches++;
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matches == iterations * 8);
+    std::cout << std::fixed << std::setprecision(1)
+        << "SubstringsMatcher: " << elapsed / (iterations * inputs.size()) << " ns per input\n";
+
+    // A long transcript, searched with repeated calls to Find and with a single FindAll scan.
+    std::string transcript;
+    for (size_t i = 0; i < 2000; i++)
+    {
+        transcript += inputs[i % inputs.size()] + " ";
+    }
+
+    const size_t transcriptIterations = 200;
+    size_t findMatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < transcriptIterations; i++)
+    {
+        std::string found;
+        size_t index = 0;
+        while ((index = punctuation.Find(transcript, index, &found)) != SubstringsMatcher::NO_MATCH)
+        {
+            index += found.length();
+            findMatches++;
+        }
+    }
+    auto findElapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    size_t findAllMatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < transcriptIterations; i++)
+    {
+        punctuation.FindAll(transcript, [&](size_t, size_t, const std::string&) { findAllMatches++; return true; });
+    }
+    auto findAllElapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(findMatches == findAllMatches);
+    std::cout << std::fixed << std::setprecision(1)
+        << "SubstringsMatcher, " << transcript.length() << " byte transcript: Find " << findElapsed / transcriptIterations
+        << " us, FindAll " << findAllElapsed / transcriptIterations << " us\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Strict list entity", "[.][benchmark]")
+{
+    auto model = std::make_shared<CSpxPatternMatchingModel>("benchmark");
+    model->Init("en-US");
+
+    auto intent = std::make_shared<CSpxPatternMatchingIntent>();
+    intent->Init("Call", 0, "en");
+    intent->AddPhrase("call {contact} [please]");
+    intent->AddPhrase("call {contact} on {device}");
+    model->AddIntent(intent, "Call");
+
+    const size_t phraseCount = 100000;
+    auto contact = std::make_shared<CSpxListEntity>();
+    contact->Init("contact", model->GetOrthographyInfo());
+    contact->SetMode(Microsoft::SpeechSDK::Standalone::Intent::EntityMatchMode::Strict);
+    for (size_t i = 0; i < phraseCount; i++)
+    {
+        contact->AddPhrase("contact number " + std::to_string(i) + " at work");
+    }
+    model->AddEntity(contact);
+
+    const std::vector<std::string> utterances = {
+        "call contact number 99999 at work please",
+        "call contact number 5 at work on my phone",
+        "call someone who is not in the list please" };
+
+    const size_t iterations = 200;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& utterance : utterances)
+        {
+            matches += model->FindMatches(utterance).size();
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matches == iterations * 2);
+    std::cout << std::fixed << std::setprecision(1)
+        << "Strict list of " << phraseCount << " phrases: " << elapsed / (iterations * utterances.size()) << " us per utterance\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Patterns sharing entities", "[.][benchmark]")
+{
+    auto model = std::make_shared<CSpxPatternMatchingModel>("benchmark");
+    model->Init("en-US");
+
+    auto number = std::make_shared<CSpxIntegerEntity>();
+    number->Init("number", model->GetOrthographyInfo());
+    model->AddEntity(number);
+
+    auto contact = std::make_shared<CSpxListEntity>();
+    contact->Init("contact", model->GetOrthographyInfo());
+    contact->SetMode(Microsoft::SpeechSDK::Standalone::Intent::EntityMatchMode::Strict);
+    for (size_t i = 0; i < 1000; i++)
+    {
+        contact->AddPhrase("contact " + std::to_string(i));
+    }
+    model->AddEntity(contact);
+
+    // Every pattern starts with an entity, so all of them try the same spans of the utterance.
+    const size_t intentCount = 200;
+    for (size_t i = 0; i < intentCount; i++)
+    {
+        auto intentId = "Intent" + std::to_string(i);
+        auto intent = std::make_shared<CSpxPatternMatchingIntent>();
+        intent->Init(intentId, 0, "en");
+        intent->AddPhrase("{number} {contact} word" + std::to_string(i));
+        intent->AddPhrase("{contact} {number} word" + std::to_string(i));
+        model->AddIntent(intent, intentId);
+    }
+
+    const std::vector<std::string> utterances = {
+        "three hundred and twenty one contact 42 word7",
+        "contact 999 one thousand two hundred word199",
+        "contact 5 seven nothing matches this" };
+
+    const size_t iterations = 20;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& utterance : utterances)
+        {
+            matches += model->FindMatches(utterance).size();
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matches == iterations * 2);
+    std::cout << std::fixed << std::setprecision(1)
+        << intentCount * 2 << " patterns sharing entities: " << elapsed / (iterations * utterances.size()) << " us per utterance\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Long utterances", "[.][benchmark]")
+{
+    auto model = std::make_shared<CSpxPatternMatchingModel>("benchmark");
+    model->Init("en-US");
+
+    // Patterns starting with an any entity have no literal prefix, each of them walks the whole utterance.
+    const size_t intentCount = 300;
+    for (size_t i = 0; i < intentCount; i++)
+    {
+        auto intentId = "Intent" + std::to_string(i);
+        auto intent = std::make_shared<CSpxPatternMatchingIntent>();
+        intent->Init(intentId, 0, "en");
+        intent->AddPhrase("{thing}, [please] send it to word" + std::to_string(i) + " right now");
+        model->AddIntent(intent, intentId);
+    }
+
+    const std::vector<std::string> utterances = {
+        "take the long report about the quarterly numbers, the short summary and the charts please send it to word42 right now.",
+        "well, I think that the meeting tomorrow morning should be moved to the afternoon because nobody is available before noon",
+        "\xe2\x80\x9cquoted\xe2\x80\x9d text with some caf\xc3\xa9 and na\xc3\xafve words, send it to word299 right now!" };
+
+    const size_t iterations = 20;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& utterance : utterances)
+        {
+            matches += model->FindMatches(utterance).size();
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matches == iterations * 2);
+    std::cout << std::fixed << std::setprecision(1)
+        << intentCount << " patterns over long utterances: " << elapsed / (iterations * utterances.size()) << " us per utterance\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Integer slots", "[.][benchmark]")
+{
+    auto model = std::make_shared<CSpxPatternMatchingModel>("benchmark");
+    model->Init("en-US");
+
+    auto number = std::make_shared<CSpxIntegerEntity>();
+    number->Init("number", model->GetOrthographyInfo());
+    model->AddEntity(number);
+
+    // The number takes the rest of the utterance at first, then gives it back a word at a time.
+    const size_t intentCount = 100;
+    for (size_t i = 0; i < intentCount; i++)
+    {
+        auto intentId = "Intent" + std::to_string(i);
+        auto intent = std::make_shared<CSpxPatternMatchingIntent>();
+        intent->Init(intentId, 0, "en");
+        intent->AddPhrase("send {number} copies of the report to word" + std::to_string(i) + " [please]");
+        model->AddIntent(intent, intentId);
+    }
+
+    const std::vector<std::string> utterances = {
+        "send twenty five copies of the report to word42 please",
+        "send three hundred and twelve copies of the report to word99",
+        "send more copies of the long quarterly report about the numbers to word7 as soon as you can" };
+
+    const size_t iterations = 20;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& utterance : utterances)
+        {
+            matches += model->FindMatches(utterance).size();
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matches == iterations * 2);
+    std::cout << std::fixed << std::setprecision(1)
+        << intentCount << " patterns with an integer slot: " << elapsed / (iterations * utterances.size()) << " us per utterance\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Integer parsing", "[.][benchmark]")
+{
+    const std::vector<std::pair<std::string, std::vector<std::string>>> languages = {
+        { "en-US", { "three hundred and twenty one", "twenty-first", "minus 1,250", "contact forty two please", "a dozen" } },
+        { "zh-CN", { u8"三百二十一", u8"一千零五", "1250", u8"四十二个", u8"两千 三百" } } };
+
+    for (const auto& language : languages)
+    {
+        auto model = std::make_shared<CSpxPatternMatchingModel>("benchmark");
+        model->Init(language.first);
+        auto number = std::make_shared<CSpxIntegerEntity>();
+        number->Init("number", model->GetOrthographyInfo());
+
+        const size_t iterations = 200;
+        size_t parsed = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            for (auto& input : language.second)
+            {
+                parsed += number->Parse(input) ? 1 : 0;
+            }
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        REQUIRE(parsed == iterations * (language.second.size() - 1));
+        std::cout << std::fixed << std::setprecision(2)
+            << language.first << " integer parsing: " << elapsed / (iterations * language.second.size()) << " us per parse\n";
+    }
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Compiled model load", "[.][benchmark]")
+{
+    using namespace Microsoft::SpeechSDK::Standalone::Intent;
+
+    const std::string compiledFile = "benchmark_model.bin";
+    const size_t phraseCount = 200000;
+
+    auto model = PatternMatchingModel::FromModelId("benchmark");
+    model->Intents.push_back({ {"call {contact} [please]"}, "Call" });
+    std::vector<std::string> phrases;
+    for (size_t i = 0; i < phraseCount; i++)
+    {
+        phrases.push_back("contact number " + std::to_string(i) + " at work");
+    }
+    model->Entities.push_back({ "contact", EntityType::List, EntityMatchMode::Strict, phrases });
+
+    // Time to the first recognition, which is when the model is built.
+    auto timeToFirstResult = [](std::function<std::shared_ptr<PatternMatchingModel>()> loadModel)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto recognizer = IntentRecognizer::FromLanguage();
+        recognizer->ApplyLanguageModels({ loadModel() });
+        auto result = recognizer->RecognizeOnceAsync("call contact number 12345 at work").get();
+        REQUIRE(result->IntentId == "Call");
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto fromPhrases = timeToFirstResult([&]() { return model; });
+
+    auto start = std::chrono::steady_clock::now();
+    model->SaveCompiledFile(compiledFile);
+    auto compileTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto fromCompiled = timeToFirstResult([&]() { return PatternMatchingModel::FromCompiledFile(compiledFile); });
+    std::remove(compiledFile.c_str());
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "List of " << phraseCount << " phrases, time to first result: from phrases " << fromPhrases
+        << " ms, from compiled file " << fromCompiled << " ms (compiling took " << compileTime << " ms)\n";
+}
+
+namespace {
+
+// Writes a LUIS export shaped model: a few patterns and a closed list with many synonyms, the part that makes real
+// model files large. The indent is empty for minified output.
+std::string CreateBenchmarkModelJson(size_t subListCount, const std::string& synonymPrefix, const std::string& indent)
+{
+    auto newLine = indent.empty() ? std::string() : std::string("\n");
+    auto space = indent.empty() ? std::string() : std::string(" ");
+    auto at = [&](int depth) { std::string s = newLine; for (int i = 0; i < depth; i++) s += indent; return s; };
+
+    std::string json = "{" + at(1) + "\"luis_schema_version\":" + space + "\"7.0.0\"," + at(1) + "\"name\":" + space + "\"benchmark\",";
+    json += at(1) + "\"patterns\":" + space + "[";
+    for (size_t i = 0; i < BenchmarkVerbs.size(); i++)
+    {
+        json += (i ? "," : "") + at(2) + "{" + at(3) + "\"pattern\":" + space + "\"" + BenchmarkVerbs[i] + " {contact} [please]\","
+            + at(3) + "\"intent\":" + space + "\"" + BenchmarkVerbs[i] + "\"" + at(2) + "}";
+    }
+    json += at(1) + "]," + at(1) + "\"closedLists\":" + space + "[" + at(2) + "{" + at(3) + "\"name\":" + space + "\"contact\","
+        + at(3) + "\"subLists\":" + space + "[";
+    for (size_t i = 0; i < subListCount; i++)
+    {
+        auto number = std::to_string(i);
+        json += (i ? "," : "") + at(4) + "{" + at(5) + "\"canonicalForm\":" + space + "\"" + synonymPrefix + " " + number + "\","
+            + at(5) + "\"list\":" + space + "[" + at(6) + "\"" + synonymPrefix + " number " + number + " at work\","
+            + at(6) + "\"" + synonymPrefix + " \\\"" + number + "\\\" at home\"" + at(5) + "]" + at(4) + "}";
+    }
+    json += at(3) + "]" + at(2) + "}" + at(1) + "]" + newLine + "}";
+    return json;
+}
+
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::JSON parse throughput", "[.][benchmark]")
+{
+    const size_t subListCount = 50000;
+    const std::vector<std::pair<std::string, std::string>> inputs = {
+        { "Pretty-printed model", CreateBenchmarkModelJson(subListCount, "contact", "    ") },
+        { "Minified model", CreateBenchmarkModelJson(subListCount, "contact", "") },
+        { "Minified model (zh)", CreateBenchmarkModelJson(subListCount, u8"\u8054\u7CFB\u4EBA\u5F20\u4E09", "") } };
+
+    for (auto& input : inputs)
+    {
+        auto& json = input.second;
+        std::istringstream stream(json);
+        auto model = Microsoft::SpeechSDK::Standalone::Intent::PatternMatchingModel::FromJSONFileStream(stream);
+        REQUIRE(model->Entities.front().Phrases.size() == subListCount * 3);
+
+        const size_t iterations = 20;
+        size_t items = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            auto parser = ajv::json::Parse(json);
+            items += parser.Reader()["closedLists"][0]["subLists"].ValueCount();
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        REQUIRE(items == iterations * subListCount);
+        std::cout << std::fixed << std::setprecision(1)
+            << input.first << ", " << json.size() / 1024 << " KB: " << iterations * json.size() / elapsed / (1024 * 1024) << " MB/s\n";
+    }
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Detailed result rendering", "[.][benchmark]")
+{
+    auto model = CreateBenchmarkModel();
+    auto utterances = CreateBenchmarkUtterances();
+
+    std::vector<std::vector<std::shared_ptr<CSpxIntentMatchResult>>> matches;
+    for (auto& utterance : utterances)
+    {
+        auto found = model->FindMatches(utterance);
+        if (!found.empty())
+        {
+            matches.emplace_back(found.begin(), found.end());
+        }
+    }
+    REQUIRE(!matches.empty());
+
+    const size_t iterations = 2000;
+    size_t size = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& match : matches)
+        {
+            size += CSpxIntentRecognizer::RenderDetailedJsonResult(match).length();
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(size > 0);
+    std::cout << std::fixed << std::setprecision(2)
+        << "Detailed result JSON: " << elapsed / (iterations * matches.size()) << " us per result\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Model load thread scaling", "[.][benchmark]")
+{
+    using namespace Microsoft::SpeechSDK::Standalone::Intent;
+
+    // Several large lists and many patterns, so there is work for every worker.
+    auto model = PatternMatchingModel::FromModelId("benchmark");
+    for (size_t list = 0; list < 8; list++)
+    {
+        std::vector<std::string> phrases;
+        for (size_t i = 0; i < 50000; i++)
+        {
+            phrases.push_back("Contact  Number " + std::to_string(list) + " " + std::to_string(i) + "  at work");
+        }
+        model->Entities.push_back({ "contact" + std::to_string(list), EntityType::List, EntityMatchMode::Strict, phrases });
+    }
+    for (size_t i = 0; i < 2000; i++)
+    {
+        auto verb = BenchmarkVerbs[i % BenchmarkVerbs.size()];
+        model->Intents.push_back({ { verb + " {contact" + std::to_string(i % 8) + "} " + std::to_string(i) + " [please]" }, verb + std::to_string(i) });
+    }
+
+    std::vector<size_t> threadCounts = { 1, 2, 4 };
+    auto hardwareThreads = (size_t)std::max(1u, std::thread::hardware_concurrency());
+    if (hardwareThreads > 4)
+    {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    for (auto threads : threadCounts)
+    {
+        auto recognizer = IntentRecognizer::FromLanguage("en-US", threads);
+        auto start = std::chrono::steady_clock::now();
+        recognizer->ApplyLanguageModels({ model });
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        auto result = recognizer->RecognizeOnceAsync("open contact number 0 12345 at work 0").get();
+        REQUIRE(result->IntentId == "open0");
+        std::cout << std::fixed << std::setprecision(1) << threads << " worker threads: model applied in " << elapsed << " ms\n";
+    }
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::List entity update", "[.][benchmark]")
+{
+    using namespace Microsoft::SpeechSDK::Standalone::Intent;
+
+    const size_t phraseCount = 500000;
+    auto model = PatternMatchingModel::FromModelId("benchmark");
+    model->Intents.push_back({ {"call {contact} [please]"}, "Call" });
+    std::vector<std::string> phrases;
+    for (size_t i = 0; i < phraseCount; i++)
+    {
+        phrases.push_back("contact number " + std::to_string(i) + " at work");
+    }
+    model->Entities.push_back({ "contact", EntityType::List, EntityMatchMode::Strict, phrases });
+
+    auto recognizer = IntentRecognizer::FromLanguage();
+    auto start = std::chrono::steady_clock::now();
+    recognizer->ApplyLanguageModels({ model });
+    auto applyTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Each update replaces 100 phrases, the first one also freezes the list loaded above.
+    const size_t updates = 100;
+    double firstUpdateTime = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t update = 0; update < updates; update++)
+    {
+        std::vector<std::string> removed, added;
+        for (size_t i = 0; i < 100; i++)
+        {
+            removed.push_back(phrases[update * 100 + i]);
+            added.push_back("new contact " + std::to_string(update * 100 + i));
+        }
+        REQUIRE(recognizer->UpdateListEntity("benchmark", "contact", removed, added));
+        if (update == 0)
+        {
+            firstUpdateTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    auto updateTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / (updates - 1);
+
+    auto result = recognizer->RecognizeOnceAsync("call new contact 9999 please").get();
+    REQUIRE(result->IntentId == "Call");
+    std::cout << std::fixed << std::setprecision(2) << "List of " << phraseCount << " phrases: applied in " << applyTime
+        << " ms, first update " << firstUpdateTime << " ms, then " << updateTime << " ms per update of 100 phrases\n";
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Parallel model matching", "[.][benchmark]")
+{
+    using namespace Microsoft::SpeechSDK::Standalone::Intent;
+
+    // A dozen domain models of the same size, one utterance at a time as a caller waiting for each result would.
+    const size_t modelCount = 12;
+    std::vector<std::shared_ptr<LanguageUnderstandingModel>> models;
+    for (size_t i = 0; i < modelCount; i++)
+    {
+        auto model = PatternMatchingModel::FromModelId("domain" + std::to_string(i));
+        for (auto& verb : BenchmarkVerbs)
+        {
+            for (auto& object : BenchmarkObjects)
+            {
+                auto intentId = verb + std::to_string(i);
+                model->Intents.push_back({ { verb + " " + object + " " + std::to_string(i) + " [please]", verb + " {thing} in {room}",
+                    "(can|could|would) you " + verb + " {thing} [for me]" }, intentId });
+            }
+        }
+        models.push_back(model);
+    }
+
+    auto recognizer = IntentRecognizer::FromLanguage("en-US", 4);
+    recognizer->ApplyLanguageModels(models);
+    auto utterances = CreateBenchmarkUtterances();
+
+    const size_t iterations = 5;
+    for (auto parallel : { false, true })
+    {
+        recognizer->SetParallelModelMatching(parallel);
+        size_t matches = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            for (auto& utterance : utterances)
+            {
+                matches += recognizer->RecognizeOnceAsync(utterance).get()->IntentId.empty() ? 0 : 1;
+            }
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        REQUIRE(matches > 0);
+        std::cout << std::fixed << std::setprecision(1) << modelCount << " models, " << (parallel ? "concurrently" : "one after the other")
+            << " on 4 worker threads: " << elapsed / (iterations * utterances.size()) << " us per utterance\n";
+    }
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Ranking many matches", "[.][benchmark]")
+{
+    using namespace Microsoft::SpeechSDK::Standalone::Intent;
+
+    // Every intent matches every utterance, in a few ways that rank differently, so ranking is most of the work.
+    const size_t intentCount = 200;
+    auto model = PatternMatchingModel::FromModelId("benchmark");
+    model->Entities.push_back({ "count", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
+    model->Entities.push_back({ "color", EntityType::List, EntityMatchMode::Basic, { "red", "green", "blue" } });
+    for (size_t i = 0; i < intentCount; i++)
+    {
+        model->Intents.push_back({ { "paint {thing}", "paint {count} {thing}", "paint {count} {color} {thing}", "paint {thing} " + std::to_string(i) },
+            "Paint" + std::to_string(i) });
+    }
+
+    auto intentRecognizer = IntentRecognizer::FromLanguage();
+    intentRecognizer->ApplyLanguageModels({ model });
+
+    const std::vector<std::string> utterances = { "paint three red chairs", "paint the fence 42", "paint seven walls" };
+    const size_t iterations = 300;
+    size_t matches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        for (auto& utterance : utterances)
+        {
+            matches += intentRecognizer->RecognizeOnceAsync(utterance).get()->IntentId.empty() ? 0 : 1;
+        }
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(matches == iterations * utterances.size());
+    std::cout << std::fixed << std::setprecision(1)
+        << intentCount << " intents matching every utterance: " << elapsed / (iterations * utterances.size()) << " us per utterance\n";
+}
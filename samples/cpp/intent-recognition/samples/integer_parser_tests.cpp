@@ -0,0 +1,2056 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+#include "intent_recognizer/stdafx.h"
+
+#include <cmath>
+#include <codecvt>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch2/catch_amalgamated.hpp"
+
+#include "en_integer_parser.h"
+#include "es_integer_parser.h"
+#include "fr_integer_parser.h"
+#include "ja_integer_parser.h"
+#include "string_utils.h"
+#include "zh_integer_parser.h"
+
+using namespace Microsoft::SpeechSDK::Standalone::Intent::Impl;
+
+// The integer parsers used to split their input with regular expressions and wide strings and to look their words up in
+// std::map tables. Those versions are kept here as they were, the parsers must give the same results for anything.
+
+namespace {
+
+namespace RegexEN {
+
+class CSpxRegexENIntegerParser
+{
+public:
+    Maybe<std::string> Parse(const std::string& input) const;
+
+private:
+    std::vector<uint64_t> ConvertMatchesToNumVector(const std::vector<std::string>& matched) const;
+    std::string ConvertVectorToNum(const std::vector<uint64_t>& nums) const;
+};
+
+// Must use this so the maps will compare the values and not the pointers.
+struct cmp_str
+{
+    bool operator()(char const* a, char const* b) const
+    {
+        return std::strcmp(a, b) < 0;
+    }
+};
+
+const std::map<const char*, int64_t, cmp_str> CardinalNumberMap
+{
+    { "a", 1L },
+    { "zero", 0L },
+    { "oh", 0L },
+    { "an", 1L },
+    { "one", 1L },
+    { "two", 2L },
+    { "too", 2L },
+    { "to", 2L },
+    { "three", 3L },
+    { "four", 4L },
+    { "for", 4L },
+    { "fore", 4L },
+    { "five", 5L },
+    { "six", 6L },
+    { "seven", 7L },
+    { "eight", 8L },
+    { "nine", 9L },
+    { "ten", 10L },
+    { "eleven", 11L },
+    { "twelve", 12L },
+    { "dozen", 12L },
+    { "dozens", 12L },
+    { "thirteen", 13L },
+    { "fourteen", 14L },
+    { "fifteen", 15L },
+    { "sixteen", 16L },
+    { "seventeen", 17L },
+    { "eighteen", 18L },
+    { "nineteen", 19L },
+    { "twenty", 20L },
+    { "thirty", 30L },
+    { "forty", 40L },
+    { "fifty", 50L },
+    { "sixty", 60L },
+    { "seventy", 70L },
+    { "eighty", 80L },
+    { "ninety", 90L },
+    { "hundred", 100L },
+    { "thousand", 1000L },
+    { "million", 1000000L },
+    { "mln", 1000000L },
+    { "billion", 1000000000L },
+    { "bln", 1000000000L },
+    { "trillion", 1000000000000L },
+    { "tln", 1000000000000L },
+    { "lakh", 100000L },
+    { "crore", 10000000L },
+    { "score", 20L }
+};
+
+const std::map<const char*, int64_t, cmp_str> OrdinalNumberMap
+{
+    { "first", 1L },
+    { "second", 2L },
+    { "secondary", 2L },
+    { "half", 2L },
+    { "third", 3L },
+    { "fourth", 4L },
+    { "quarter", 4L },
+    { "fifth", 5L },
+    { "sixth", 6L },
+    { "seventh", 7L },
+    { "eighth", 8L },
+    { "ninth", 9L },
+    { "nineth", 9L },
+    { "tenth", 10L },
+    { "eleventh", 11L },
+    { "twelfth", 12L },
+    { "thirteenth", 13L },
+    { "fourteenth", 14L },
+    { "fifteenth", 15L },
+    { "sixteenth", 16L },
+    { "seventeenth", 17L },
+    { "eighteenth", 18L },
+    { "nineteenth", 19L },
+    { "twentieth", 20L },
+    { "thirtieth", 30L },
+    { "fortieth", 40L },
+    { "fiftieth", 50L },
+    { "sixtieth", 60L },
+    { "seventieth", 70L },
+    { "eightieth", 80L },
+    { "ninetieth", 90L },
+    { "hundredth", 100L },
+    { "thousandth", 1000L },
+    { "millionth", 1000000L },
+    { "billionth", 1000000000L },
+    { "trillionth", 1000000000000L }
+};
+
+const char* NegativeRegex = "(-|minus|negative).*";
+const char* NumberPatternRegex = R"(\b(\d+|\d+(rd|st|th|nd)|and| -|negative|minus|seventeen|eighteen|thousand|trillion|nineteen|thirteen|fourteen|sixteen|seventy|fifteen|hundred|billion|million|twenty|ninety|twelve|dozens|thirty|eighty|eleven|forty|seven|crore|sixty|eight|three|fifty|dozen|lakh|nine|zero|five|four|bln|two|mln|one|tln|ten|six|an|a|seventeenths|seventieths|nineteenths|thousandths|seventeenth|trillionths|thirteenths|fourteenths|eighteenths|eightieths|seventieth|sixteenths|trillionth|thousandth|fourteenth|fifteenths|thirtieths|twentieths|millionths|eighteenth|nineteenth|hundredths|ninetieths|billionths|thirteenth|elevenths|thirtieth|sixteenth|twentieth|fiftieths|eightieth|ninetieth|fortieths|fifteenth|secondary|billionth|millionth|hundredth|sixtieths|fortieth|sixtieth|twelfths|eleventh|fiftieth|sevenths|quarters|eighths|twelfth|seventh|quarter|fourths|nineths|tenths|fourth|thirds|sixths|halves|ninths|firsts|second|nineth|fifths|eighth|third|ninth|first|tenth|fifth|sixth|half|oh|for|too|to|fore)\b)";
+
+// Note: The number parsing from this section is based on the open source project and converted from the C# code there.
+// https://github.com/microsoft/Recognizers-Text
+Maybe<std::string> CSpxRegexENIntegerParser::Parse(const std::string& input) const
+{
+    try
+    {
+        std::regex numberPatternRegex(NumberPatternRegex, std::regex_constants::icase);
+        std::smatch sm;
+        std::string stringToProcess = input;
+        int64_t result = 0;
+        bool found = false;
+
+        // Remove locale number punctuation.
+        stringToProcess.erase(std::remove(stringToProcess.begin(), stringToProcess.end(), ','), stringToProcess.end());
+
+        auto matchBegin = std::sregex_iterator(stringToProcess.begin(), stringToProcess.end(), numberPatternRegex);
+        auto matchEnd = std::sregex_iterator();
+        std::vector<std::string> matches;
+
+        for (std::sregex_iterator iter = matchBegin; iter != matchEnd; ++iter)
+        {
+            auto match = *iter;
+
+            // If there is ever a prefix or suffix not containing a number, then there are words captured that are not numbers.
+            // In this case we should empty matches and break. This means we are returning no number.
+
+            //trim the strings of spaces and '-'s
+            auto prefix = match.prefix().str();
+            prefix.erase(0, prefix.find_first_not_of(' '));
+            prefix.erase(0, prefix.find_first_not_of('-'));
+            prefix.erase(prefix.find_last_not_of(' ') + 1);
+            prefix.erase(prefix.find_last_not_of('-') + 1);
+            auto suffix = match.suffix().str();
+            suffix.erase(0, suffix.find_first_not_of(' '));
+            suffix.erase(0, suffix.find_first_not_of('-'));
+            suffix.erase(suffix.find_last_not_of(' ') + 1);
+            suffix.erase(suffix.find_last_not_of('-') + 1);
+
+            if ((!prefix.empty() && !std::regex_search(prefix, sm, numberPatternRegex))
+                || (!suffix.empty() && !std::regex_search(suffix, sm, numberPatternRegex)))
+            {
+                matches.clear();
+                break;
+            }
+
+            // If we matched, we want the group not the whole string or the beginning word boundary group so we get match[1].
+            matches.push_back(match[1].str());
+        }
+
+        if (matches.size() != 0)
+        {
+            bool isNegative = false;
+            // Check for negatives
+            std::regex negativeRegex(NegativeRegex);
+            std::cmatch cm;
+            if (std::regex_match(input.c_str(), cm, negativeRegex))
+            {
+                isNegative = true;
+            }
+
+            auto nums = ConvertMatchesToNumVector(matches);
+
+            if (!nums.empty())
+            {
+                auto strResult = ConvertVectorToNum(nums);
+                char* endptr = NULL;
+                // errno can be set to any non-zero value by a library function call
+                // regardless of whether there was an error, so it needs to be cleared
+                // in order to check the error set by strtol
+                errno = 0;
+                auto numResult = strtol(strResult.c_str(), &endptr, 10);
+                if (endptr != strResult.c_str() && errno == 0)
+                {
+                    isNegative ?
+                        result -= numResult :
+                        result += numResult;
+                    found = true;
+                }
+            }
+        }
+
+        return found ? Maybe<std::string>(std::to_string(result)) : Maybe<std::string>();;
+    }
+    catch (const std::regex_error& ex)
+    {
+        SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+        UNUSED(ex);
+        return Maybe<std::string>();
+    }
+}
+
+std::vector<uint64_t> CSpxRegexENIntegerParser::ConvertMatchesToNumVector(const std::vector<std::string>& matches) const
+{
+    std::vector<uint64_t> results;
+
+    for (auto& match : matches)
+    {
+        auto cardinal = CardinalNumberMap.find(match.c_str());
+        if (cardinal != CardinalNumberMap.end())
+        {
+            results.push_back(cardinal->second);
+            continue;
+        }
+        auto ordinal = OrdinalNumberMap.find(match.c_str());
+        if (ordinal != OrdinalNumberMap.end())
+        {
+            results.push_back(ordinal->second);
+            continue;
+        }
+
+        auto pullOutDigitNum = [&](auto& regex, const auto& str)
+        {
+            std::cmatch cm;
+            if (std::regex_match(str.c_str(), cm, regex))
+            {
+                // errno can be set to any non-zero value by a library function call
+                // regardless of whether there was an error, so it needs to be cleared
+                // in order to check the error set by strtol
+                errno = 0;
+                char* endptr = NULL;
+                auto digitNum = strtol(str.c_str(), &endptr, 10);
+                if (endptr != str.c_str() && errno == 0)
+                {
+                    results.push_back(digitNum);
+                }
+            }
+        };
+
+        try
+        {
+            std::regex digitOrdinalRegex("\\d+(nd|st|rd|th)");
+            pullOutDigitNum(digitOrdinalRegex, match);
+
+            std::regex digitRegex("\\d+");
+            pullOutDigitNum(digitRegex, match);
+        }
+        catch (const std::regex_error& ex)
+        {
+            SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+            UNUSED(ex);
+        }
+    }
+
+    return results;
+}
+
+struct ValueStruct
+{
+    uint64_t Value;
+    // Digit mask is a bit mask to show what digits are figured. "1040" = 1010
+    uint32_t DigitMask;
+    // Cover mask is a convenience mask to show how big the number is in digits. "1040" = 1111
+    uint32_t CoverMask;
+
+    explicit ValueStruct(uint64_t value)
+    {
+        Value = value;
+        auto c{ 0 };
+        uint32_t mask{ 0 };
+        uint32_t coverMask{ 0 };
+        coverMask = ~coverMask;
+        do
+        {
+            mask |= ((value % 10) != 0) << c++;
+            coverMask <<= 1;
+        } while ((value /= 10) != 0);
+        CoverMask = ~coverMask;
+        DigitMask = mask;
+    }
+
+    ValueStruct& operator<<(unsigned int digits)
+    {
+        auto order = static_cast<unsigned int>(std::pow(10, digits));
+        Value *= order;
+        DigitMask <<= digits;
+        auto updatedCoverMask = ~CoverMask;
+        updatedCoverMask <<= digits;
+        CoverMask = ~updatedCoverMask;
+        return *this;
+    }
+
+    ValueStruct operator+(ValueStruct& other)
+    {
+        return ValueStruct{ Value + other.Value };
+    }
+
+    ValueStruct operator*(ValueStruct& other)
+    {
+        return ValueStruct{ Value * other.Value };
+    }
+
+    ValueStruct operator*(uint64_t other)
+    {
+        return ValueStruct{ Value * other };
+    }
+};
+
+std::string CSpxRegexENIntegerParser::ConvertVectorToNum(const std::vector<uint64_t>& nums) const
+{
+    std::vector<ValueStruct> valueStructs{};
+
+    for (auto num : nums)
+    {
+        valueStructs.push_back(ValueStruct(num));
+    }
+
+    ValueStruct incompleteResult{ 0 };
+
+    std::deque<ValueStruct> resultStack{};
+
+    bool previousZero = false;
+    for (auto& currentStruct : valueStructs)
+    {
+        if (resultStack.size() == 0)
+        {
+            resultStack.push_back(currentStruct);
+        }
+        // Someone has said "2 0 4"
+        else if (currentStruct.Value == 0 || previousZero)
+        {
+            incompleteResult = resultStack.back();
+            resultStack.pop_back();
+            incompleteResult = incompleteResult * 10;
+            resultStack.push_back(incompleteResult);
+            if (previousZero && currentStruct.Value != 0)
+            {
+                previousZero = false;
+                resultStack.push_back(currentStruct);
+            }
+            else
+            {
+                previousZero = true;
+            }
+        }
+        // Current struct is separate and covers some of the same digits. Might be a different number.
+        // Could also be a common expression such as 19 80 5
+        else if ((currentStruct.DigitMask & resultStack.back().DigitMask) != 0)
+        {
+            resultStack.push_back(currentStruct);
+        }
+        // This means the new one 'currentStruct' is lower order of magnitude "100 20 5"
+        // currentStruct does not cover same digits as result
+        else if ((currentStruct.DigitMask < resultStack.back().DigitMask) && ((currentStruct.CoverMask & resultStack.back().DigitMask) == 0))
+        {
+            resultStack.push_back(currentStruct);
+        }
+        // Someone has said "0-99 hundred" and lets shift mask by 2
+        else if ((currentStruct.Value == 100) && (resultStack.back().DigitMask < 4))
+        {
+            incompleteResult = resultStack.back();
+            resultStack.pop_back();
+            resultStack.push_back(incompleteResult * currentStruct);
+        }
+        // handle "round" numbers that are 100 or greater.
+        else if ((currentStruct.Value > 99) && (currentStruct.Value % 10 == 0))
+        {
+            // we are the first element and we should just push
+            if (resultStack.size() == 0)
+            {
+                resultStack.push_back(currentStruct);
+            }
+            // the last number in the stack is larger than this one so don't combine
+            else if (resultStack.back().CoverMask > currentStruct.CoverMask)
+            {
+                resultStack.push_back(currentStruct);
+            }
+            // they are the same and should be multiplied. 1 100 100
+            else if (resultStack.back().CoverMask == currentStruct.CoverMask)
+            {
+                auto last = resultStack.back();
+                resultStack.pop_back();
+                last = last * currentStruct;
+
+            }
+            // The resultStack number is smaller and they should be combined until this isn't true, then multiplied.
+            // Example: 2 100 30 5 1000 | s = 1000, resultStack = {200, 35}
+            else
+            {
+                while ((resultStack.size() != 0) && (resultStack.back().CoverMask < currentStruct.CoverMask))
+                {
+                    incompleteResult = resultStack.back();
+                    resultStack.pop_back();
+                    // This was the last one
+                    if (resultStack.size() == 0 || resultStack.back().CoverMask >= currentStruct.CoverMask)
+                    {
+                        incompleteResult = incompleteResult * currentStruct;
+
+                    }
+                    // There are more results and we should keep adding them up.
+                    else
+                    {
+                        auto stackTop = resultStack.back();
+                        resultStack.pop_back();
+                        resultStack.push_back(incompleteResult + stackTop);
+                    }
+                }
+
+                // Now that we have collapsed and multiplied, figure out if we should add to the result.
+                // 1 million 234 thousand.
+                if (resultStack.size() != 0 && incompleteResult.CoverMask < resultStack.back().CoverMask)
+                {
+                    auto stackTop = resultStack.back();
+                    resultStack.pop_back();
+                    incompleteResult = incompleteResult + stackTop;
+                }
+                resultStack.push_back(incompleteResult);
+            }
+        }
+        else
+        {
+            resultStack.push_back(currentStruct);
+        }
+    }
+    std::vector<uint64_t> numbers{};
+    incompleteResult = ValueStruct{ 0 };
+    // Collapse any numbers possible 1234000 500 60 7 can be collapsed and added.
+    // Also handle common expressions such as 15 hundred
+    for (auto& currentStruct : resultStack)
+    {
+        if (incompleteResult.DigitMask == 0)
+        {
+            incompleteResult = currentStruct;
+        }
+        // Result is less than 100 and currentStruct is 10'currentStruct
+        else if ((incompleteResult.DigitMask <= 3) && (currentStruct.DigitMask & 2))
+        {
+            incompleteResult.Value = incompleteResult.Value * 100 + currentStruct.Value;
+            incompleteResult.DigitMask = (incompleteResult.DigitMask << 2) + currentStruct.DigitMask;
+        }
+        // CurrentStruct is smaller without conflicting digits and therefore we can add.
+        else if (((incompleteResult.DigitMask & currentStruct.DigitMask) == 0) && (incompleteResult.Value > currentStruct.Value))
+        {
+            incompleteResult.Value = incompleteResult.Value + currentStruct.Value;
+            incompleteResult.DigitMask |= currentStruct.DigitMask;
+        }
+        else
+        {
+            numbers.push_back(incompleteResult.Value);
+            incompleteResult = currentStruct;
+        }
+    }
+
+    numbers.push_back(incompleteResult.Value);
+
+    std::ostringstream resultStringStream;
+    for (auto& num : numbers)
+    {
+        resultStringStream << num;
+    }
+    return resultStringStream.str();
+}
+
+}
+
+namespace RegexZH {
+
+class CSpxRegexZHIntegerParser
+{
+public:
+    Maybe<std::string> Parse(const std::string& input) const;
+
+private:
+    std::vector<uint64_t> ConvertMatchesToNumVector(const std::vector<std::string>& matched) const;
+    std::string ConvertVectorToNum(const std::vector<uint64_t>& nums) const;
+    std::vector<uint64_t> ConvertToMultiplicativeAdditive(const std::vector<uint64_t> matches) const;
+    std::vector<uint64_t> NormalizeNumbers(std::vector<uint64_t> matches) const;
+    bool IsPowerOfTen(const uint64_t number) const;
+    bool IsPowerOfTenThousand(const uint64_t number) const;
+    bool IsContinuousNum(const std::vector<uint64_t> matches) const;
+};
+
+// Must use this so the maps will compare the values && not the pointers.
+struct cmp_str
+{
+    bool operator()(char const* a, char const* b) const
+    {
+        return std::strcmp(a, b) < 0;
+    }
+};
+
+const std::map<const char*, int64_t, cmp_str> CardinalNumberMap
+{
+    { u8"零", 0L },
+    { u8"一", 1L },
+    { u8"幺", 1L },
+    { u8"二", 2L },
+    { u8"两", 2L },
+    { u8"俩", 2L },
+    { u8"三", 3L },
+    { u8"仨", 3L },
+    { u8"四", 4L },
+    { u8"五", 5L },
+    { u8"六", 6L },
+    { u8"七", 7L },
+    { u8"八", 8L },
+    { u8"九", 9L },
+    { u8"十", 10L },
+    { u8"百", 100L },
+    { u8"千", 1000L },
+    { u8"k", 1000L },
+    { u8"〇", 0L },
+    { u8"壹", 1L },
+    { u8"贰", 2L },
+    { u8"兩", 2L },
+    { u8"倆", 2L },
+    { u8"叁", 3L },
+    { u8"肆", 4L },
+    { u8"伍", 5L },
+    { u8"陆", 6L },
+    { u8"陸", 6L },
+    { u8"柒", 7L },
+    { u8"捌", 8L },
+    { u8"玖", 9L },
+    { u8"拾", 10L },
+    { u8"佰", 100L },
+    { u8"仟", 1000L },
+};
+
+const char* NumberPatternRegexZhSim = u8"(\\d+|\\s|零|一|幺|二|两|俩|三|仨|四|五|六|七|八|九|十|百|千|〇|壹|贰|兩|倆|叁|肆|伍|陆|陸|柒|捌|玖|拾|佰|仟|k)";
+
+Maybe<std::string> CSpxRegexZHIntegerParser::Parse(const std::string& input) const
+{
+    std::string stringToProcess = input;
+    try
+    {
+        std::regex numberPatternRegexZhSim(NumberPatternRegexZhSim, std::regex_constants::icase);
+        std::regex addBlankZh(u8"([\u4e00-\u9fa5]{3})");
+        std::smatch sm;
+        int64_t result = 0;
+        bool found = false;
+
+        // Separate into Chinese chracters && numbers.
+        stringToProcess = std::regex_replace(stringToProcess, addBlankZh, u8" \\1 ", std::regex_constants::format_sed);
+        stringToProcess = std::regex_replace(stringToProcess, std::regex(u8"\\s+"), u8" ");
+        stringToProcess = std::regex_replace(stringToProcess, std::regex(u8"^\\s+|\\s+$"), u8"");
+
+        auto matchBegin = std::sregex_iterator(stringToProcess.begin(), stringToProcess.end(), numberPatternRegexZhSim);
+        auto matchEnd = std::sregex_iterator();
+        std::vector<std::string> matches;
+
+        for (std::sregex_iterator iter = matchBegin; iter != matchEnd; ++iter)
+        {
+            auto match = *iter;
+
+            auto prefix = match.prefix().str();
+            auto suffix = match.suffix().str();
+
+            if ((!prefix.empty() && !std::regex_search(prefix, sm, numberPatternRegexZhSim))
+                || (!suffix.empty() && !std::regex_search(suffix, sm, numberPatternRegexZhSim)))
+            {
+                matches.clear();
+                break;
+            }
+
+            if (match[1].str() != u8" ")
+                matches.push_back(match[1].str());
+        }
+
+        if (matches.size() != 0)
+        {
+            auto numVector = ConvertMatchesToNumVector(matches);
+            if (numVector.size() != 0)
+            {
+                auto num = ConvertToMultiplicativeAdditive(numVector);
+                if (num.size() != 0)
+                {
+                    auto numNorm = NormalizeNumbers(num);
+                    if (!numNorm.empty())
+                    {
+                        auto strResult = ConvertVectorToNum(numNorm);
+                        char* endptr = NULL;
+                        // errno can be set to any non-zero value by a library function call
+                        // regardless of whether there was an error, so it needs to be cleared
+                        // in order to check the error set by strtol
+                        errno = 0;
+                        auto numResult = strtoull(strResult.c_str(), &endptr, 10);
+                        if (endptr != strResult.c_str() && errno == 0)
+                        {
+                            result = numResult;
+                            found = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        return found ? std::string(std::to_string(result)) : Maybe<std::string>();;
+    }
+    catch (const std::regex_error& ex)
+    {
+        // warning gets trigger from not using ex outside of macro.
+        UNUSED(ex);
+        SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+        return Maybe<std::string>();
+    }
+}
+
+std::vector<uint64_t> CSpxRegexZHIntegerParser::ConvertMatchesToNumVector(const std::vector<std::string>& matches) const
+{
+    std::vector<uint64_t> results;
+
+    for (auto& match : matches)
+    {
+        auto cardinal = CardinalNumberMap.find(match.c_str());
+        if (cardinal != CardinalNumberMap.end())
+        {
+            results.push_back(cardinal->second);
+            continue;
+        }
+
+        auto pullOutDigitNum = [&](auto& regex, const auto& str)
+            {
+                std::cmatch cm;
+                if (std::regex_match(str.c_str(), cm, regex))
+                {
+                    // errno can be set to any non-zero value by a library function call
+                    // regardless of whether there was an error, so it needs to be cleared
+                    // in order to check the error set by strtol
+                    errno = 0;
+                    char* endptr = NULL;
+                    auto digitNum = strtol(str.c_str(), &endptr, 10);
+                    if (endptr != str.c_str() && errno == 0)
+                    {
+                        if (str[0] == '0' && str.size() > 1)
+                            results.push_back(0);
+                        results.push_back(digitNum);
+                    }
+                }
+            };
+
+        try
+        {
+            std::regex digitRegex(u8"\\d+");
+            pullOutDigitNum(digitRegex, match);
+        }
+        catch (const std::regex_error& ex)
+        {
+            // warning gets trigger from not using ex outside of macro.
+            UNUSED(ex);
+            SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+        }
+    }
+
+    return results;
+}
+
+std::string CSpxRegexZHIntegerParser::ConvertVectorToNum(const std::vector<uint64_t>& nums) const
+{
+    uint64_t result = 0;
+
+    try
+    {
+        if (CSpxRegexZHIntegerParser::IsContinuousNum(nums) || (nums.size() == 1 && nums[0] == 10))
+        {
+            for (auto& num : nums)
+                result = result * 10 + num;
+        }
+        else
+        {
+            for (auto iter = nums.begin(); iter != nums.end();)
+            {
+                auto number = *iter++;
+                auto unit = *iter++;
+                result += number * unit;
+            }
+        }
+    }
+    catch (const std::regex_error& ex)
+    {
+        // warning gets trigger from not using ex outside of macro.
+        UNUSED(ex);
+        SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+        return std::string();
+    }
+
+
+    return std::to_string(result);
+}
+
+std::vector<uint64_t> CSpxRegexZHIntegerParser::ConvertToMultiplicativeAdditive(const std::vector<uint64_t> matches) const
+{
+    std::vector<uint64_t> results;
+
+    if ((matches.size() == 1 && matches[0] <= 10) || CSpxRegexZHIntegerParser::IsContinuousNum(matches))
+        results = matches;
+    else
+    {
+        try
+        {
+            bool highUnit = true;
+            for (auto& match : matches)
+            {
+                std::vector<uint64_t> result;
+
+                // if it is at highest unit, we should not push it directly.
+                // the definition of highest unit is it "does" at highest unit, or after unit 10^4, 10^8, 10^12 or 0.
+                // otherwise, if this number is less than 10 or the power of 10, then we push it directly.
+                // for example,
+                // [1000, 2, 100] should be [1, 1000, 2, 100], "1000" split into "1" && "1000";
+                // [2, 1000, 1, 100] should still be [2, 1000, 1, 100], keep "100" unchanged.
+                if (!highUnit && (match < 10 || CSpxRegexZHIntegerParser::IsPowerOfTen(match)))
+                {
+                    if (results.size() > 0 && CSpxRegexZHIntegerParser::IsPowerOfTen(match) && !CSpxRegexZHIntegerParser::IsPowerOfTenThousand(match) && CSpxRegexZHIntegerParser::IsPowerOfTen(results.back()) && results.back() != 1)
+                        result.push_back(1);
+                    result.push_back(match);
+                }
+                else if (results.size() > 0 && CSpxRegexZHIntegerParser::IsPowerOfTenThousand(results.back()) && results.back() != 1 && CSpxRegexZHIntegerParser::IsPowerOfTenThousand(match) && match != 1)
+                {
+                    result.push_back(match);
+                }
+                else if (results.size() == 0 && CSpxRegexZHIntegerParser::IsPowerOfTen(match) && match != 1)
+                {
+                    result.push_back(1);
+                    result.push_back(match);
+                }
+                else
+                {
+                    std::string numberStr = std::to_string(match);
+                    uint64_t length = numberStr.length();
+                    for (unsigned int i = 0; i < length; i++)
+                    {
+                        uint64_t digit = numberStr[i] - (uint64_t)'0';
+                        uint64_t power = length - i - 1;
+
+                        if (digit != 0)
+                        {
+                            if (power > 0)
+                            {
+                                if (result.size() > 0 && result.back() == 0)
+                                    result.pop_back();
+                                if (results.size() < 1 || (results.size() > 0 && !(match >= 10 && match < 20 && power == 1 && results.back() < 10)))
+                                    result.push_back(digit);
+                                result.push_back(uint64_t(pow(10, power)));
+                            }
+                            else
+                                result.push_back(digit);
+                        }
+                        else
+                            if (result.size() > 0 && result.back() != 0)
+                                result.push_back(0);
+                            else
+                                result.push_back(0);
+                    }
+
+                    while (result.size() > 1 && result.back() == 0)
+                        result.pop_back();
+                }
+                results.insert(std::end(results), std::begin(result), std::end(result));
+
+                if (result.size() == 1 && (result.back() == 0 || (result.back() != 1 && CSpxRegexZHIntegerParser::IsPowerOfTenThousand(result.back()))))
+                    highUnit = true;
+                else
+                    highUnit = false;
+            }
+        }
+        catch (const std::regex_error& ex)
+        {
+            // warning gets trigger from not using ex outside of macro.
+            UNUSED(ex);
+            SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+        }
+    }
+    return results;
+}
+
+std::vector<uint64_t> CSpxRegexZHIntegerParser::NormalizeNumbers(std::vector<uint64_t> matches) const
+{
+    std::vector<uint64_t> results = matches;
+    std::wstring resultString;
+
+    try
+    {
+        // if all numbers are less than 10, we serve it as continuous number, for example,
+        // [3, 2, 0, 5, 8, 2], we keep it unchanged && return it directly.
+        if (results.size() > 1 && !CSpxRegexZHIntegerParser::IsContinuousNum(results))
+        {
+            // need to have a check here,
+            // it is not legal if the occurance of 10 is larger than 1 && the distance is not larger than 2, since it brings ambiguous.
+            // for example [10, 2, 10],
+            // the lexical format is 十二十, both "10 20" or "12 10" are the correct one.
+            int64_t count = -1;
+            for (auto& result : results)
+            {
+                if (result == 10)
+                {
+                    if (count > 0)
+                    {
+                        results.clear();
+                        break;
+                    }
+                    else
+                        count = 2;
+                }
+                else
+                    --count;
+            }
+
+            if (results.empty())
+                return results;
+
+            // normalize abbreviatory numbers
+            // [1, 100, 3] will be normalized to [1, 100, 3, 10]
+            // [1, 100, 0, 3] will not be normalized
+            uint64_t lastNum = *(results.rbegin());
+            uint64_t secondLastNum = *(results.rbegin() + 1);
+            if (lastNum > 0 && lastNum < 10 && secondLastNum > 10 && CSpxRegexZHIntegerParser::IsPowerOfTen(secondLastNum))
+            {
+                uint64_t unit = uint64_t(secondLastNum / 10);
+                results.push_back(unit);
+            }
+
+            // merge the adjencent units
+            // [4, 10, 10000, 10000] will be normalized to [4, 1000000000]
+            for (auto iter = results.begin(); iter + 1 != results.end();)
+            {
+                if (*iter != 1 && *(iter + 1) != 1 && CSpxRegexZHIntegerParser::IsPowerOfTen(*iter) && CSpxRegexZHIntegerParser::IsPowerOfTen(*(iter + 1)))
+                {
+                    *(iter + 1) *= *iter;
+                    iter = results.erase(iter);
+                }
+                else
+                    ++iter;
+            }
+
+            // if there are adjencent single numbers, add the unit.
+            if (results.size() > 1)
+            {
+                bool hasZero = false;
+                uint64_t preUnit = 10;
+                for (auto iter = results.begin(); iter != results.end(); iter++)
+                {
+                    if (*iter == 0)
+                        hasZero = true;
+                    if (*iter != 1 && CSpxRegexZHIntegerParser::IsPowerOfTen(*iter))
+                    {
+                        preUnit = *iter;
+                        hasZero = false;
+                    }
+                    if (iter > results.begin() && *iter < 10 && *(iter - 1) > 0 && *(iter - 1) < 10)
+                    {
+                        if (hasZero)
+                            iter = results.insert(iter, 1);
+                        else
+                            iter = results.insert(iter, uint64_t(preUnit / 10));
+                        iter++;
+                    }
+                }
+            }
+
+            // remove all irrelevant 0 elements
+            // [1, 100, 0, 3] will be normalized to [1, 100, 3]
+            for (auto iter = results.begin(); iter != results.end();)
+            {
+                if (*iter == 0 && iter > results.begin())
+                {
+                    if (*(iter - 1) > 10 && CSpxRegexZHIntegerParser::IsPowerOfTen(*(iter - 1)))
+                        iter = results.erase(iter);
+                    else if (*(iter - 1) < 9)
+                    {
+                        if (*(iter - 1) == 1 && iter > results.begin() + 1 && *(iter - 2) < 9) // (iter-1) is a unit
+                        {
+                            iter++;
+                            if (CSpxRegexZHIntegerParser::IsPowerOfTen(*(iter - 2)) && *(iter - 2) != 1)
+                                iter = results.insert(iter, 10);
+                            else
+                                iter = results.insert(iter, 1);
+                            iter++;
+                        }
+                        else // (iter-1) is not a unit
+                        {
+                            *iter = 10;
+                            ++iter;
+                        }
+                    }
+                    else // (iter-1) is a unit
+                    {
+                        iter++;
+                        if (CSpxRegexZHIntegerParser::IsPowerOfTen(*(iter - 2)) && *(iter - 2) != 1)
+                            iter = results.insert(iter, 10);
+                        else
+                            iter = results.insert(iter, 1);
+                        iter++;
+                    }
+                }
+                else
+                {
+                    ++iter;
+                }
+            }
+
+            if (results.empty())
+                return results;
+
+            // check whether the numbers are legal after nomalization
+            // it should follow the rules that,
+            // 1. the size of the vector is even
+            // 2. the even unit should be the number ranges 0-9, the odd unit should be the power of 10
+            if (results.size() % 2 == 1)
+                results.push_back(1);
+            bool hasErr = false;
+            for (auto iter = results.begin(); iter != results.end();)
+            {
+                if (*iter > 9)
+                {
+                    hasErr = true;
+                    break;
+                }
+                iter++;
+
+                if (!CSpxRegexZHIntegerParser::IsPowerOfTen(*iter))
+                {
+                    hasErr = true;
+                    break;
+                }
+                iter++;
+            }
+            if (hasErr)
+                results.clear();
+
+            if (results.empty())
+                return results;
+
+            // update all locations unit
+            // [2, 10, 4, 10000] will be normalized to [2, 100000, 4, 10000]
+            auto resultsCopy = results;
+            auto iterCopy = resultsCopy.begin();
+
+            for (auto iterStart = results.begin(); iterStart != results.end();)
+            {
+                uint64_t maxUnit = 0;
+                iterCopy = resultsCopy.begin() + (iterStart - results.begin());
+                for (auto iter = iterStart; iter != results.end() - 1;)
+                {
+                    if (iter == iterStart)
+                    {
+                        iter++;
+                        iterCopy++;
+                    }
+                    else
+                    {
+                        iter += 2;
+                        iterCopy += 2;
+                    }
+                    if (CSpxRegexZHIntegerParser::IsPowerOfTen(*iter) && *iter >= maxUnit)
+                    {
+                        maxUnit = *iter;
+                        if ((iter - iterStart) > 1)
+                        {
+                            for (auto unitIndex = iter; unitIndex != results.begin() + 1;)
+                            {
+                                unitIndex -= 2;
+                                if (CSpxRegexZHIntegerParser::IsPowerOfTen(*unitIndex))
+                                {
+                                    *unitIndex *= *iterCopy;
+                                    if ((!CSpxRegexZHIntegerParser::IsPowerOfTenThousand(*iterCopy) || *iterCopy == 1) && !(*iterCopy == 10 && *(iterCopy - 2) == 10))
+                                        *unitIndex *= 10;
+                                }
+                            }
+                        }
+                    }
+                }
+                iterStart += 2;
+            }
+        }
+    }
+    catch (const std::regex_error& ex)
+    {
+        // warning gets trigger from not using ex outside of macro.
+        UNUSED(ex);
+        SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
+    }
+
+    return results;
+}
+
+bool CSpxRegexZHIntegerParser::IsPowerOfTen(const uint64_t inputNumber) const
+{
+    if (!inputNumber)
+        return false;
+    auto number = inputNumber;
+    if (number == 0)
+        return false;
+    while (number % 10 == 0)
+        number /= 10;
+    return number == 1;
+}
+
+bool CSpxRegexZHIntegerParser::IsPowerOfTenThousand(const uint64_t inputNumber) const
+{
+    if (!inputNumber)
+        return false;
+    auto number = inputNumber;
+    if (number == 0)
+        return false;
+    while (number % 10000 == 0)
+        number /= 10000;
+    return number == 1;
+}
+
+bool CSpxRegexZHIntegerParser::IsContinuousNum(const std::vector<uint64_t> matches) const
+{
+    if (matches.empty())
+        return true;
+    for (auto& match : matches)
+        if (match > 9)
+            return false;
+    return true;
+}
+
+}
+
+namespace RegexES {
+
+class CSpxRegexESIntegerParser
+{
+public:
+    Maybe<std::string> Parse(const std::string& input) const;
+
+private:
+    static Maybe<std::vector<Token>> FromString(const std::string& input);
+    static Maybe<Token> GetNumericValue(std::string& input);
+    static std::vector<std::vector<Token>> Segment(std::vector<Token> input);
+    static Maybe<std::string> Aggregate(const std::vector<std::vector<Token>>& numbers);
+    static Maybe<uint64_t> AsInteger(const std::vector<Token>& numbers);
+    constexpr static bool IsMultiplier(const uint64_t& input);
+};
+
+struct comparator
+{
+    bool operator()(const char* lhs, const char* rhs) const
+    {
+        return std::strcmp(lhs, rhs) < 0;
+    }
+};
+
+// Beginning of Parser section
+const static std::map<const char*, const Token, comparator> NUMBERS
+{
+    // 0b1 mask
+    {"cero", Token(0 , 0x1)},
+        {"uno", Token(1, 0x1)}, {"un", Token(1, 0x1)}, {"una", Token(1, 0x1)},
+        {"dos", Token(2, 0b1)}, {"tres", Token(3, 0b1)}, {"cuatro", Token(4, 0b1)}, {"cinco", Token(5, 0b1)},
+        {"seis", Token(6, 0b1)}, {"siete", Token(7, 0b1)}, {"ocho", Token(8, 0b1)}, {"nueve", Token(9, 0b1)},
+    // 0b11 mask
+    {"diez", Token(10, 0b11)}, {"once", Token(11, 0b11)}, {"doce", Token(12, 0b11)}, {"trece", Token(13, 0b11)},
+        {"catorce", Token(14, 0b11)}, {"quince", Token(15, 0b11)}, {"dieciseis", Token(16, 0b11)}, {"diecisiete", Token(17, 0b11)},
+        {"dieciocho", Token(18, 0b11)}, {"diecinueve", Token(19, 0b11)},
+        {"veinte", Token(20, 0b11)}, {"veintiuno", Token(21, 0b11)}, {"veintidos", Token(22, 0b11)}, {"veintitres", Token(23, 0b11)},
+        {"veinticuatro", Token(24, 0b11)}, {"veinticinco", Token(25, 0b11)}, {"veintiseis", Token(26, 0b11)}, {"veintisiete", Token(27, 0b11)},
+        {"veintiocho", Token(28, 0b11)}, {"vientinueve", Token(29, 0b11)},
+    // 0b10 mask
+    {"treinta", Token(30, 0b10)}, {"cuarenta", Token(40, 0b10)}, {"cincuenta", Token(50, 0b10)}, {"sesenta", Token(60, 0b10)},
+        {"setenta", Token(70, 0b10)},{"ochenta", Token(80, 0b10)}, {"noventa", Token(90, 0b10)},
+    // 0b111 (single exception) and 0b100
+    {"cien", Token(100, 0b111)}, {"ciento", Token(100, 0b100)}, {"doscientos", Token(200, 0b100)}, {"trescientos", Token(300, 0b100)},
+        {"cuatrocientos", Token(400, 0b100)}, {"quinientos", Token(500, 0b100)}, {"seiscientos", Token(600, 0b100)},
+        {"setecientos", Token(700, 0b100)}, {"ochocientos", Token(800, 0b100)}, {"novecientos", Token(900, 0b100)},
+    // 0b1000
+    {"mil", Token (1'000, 0b1000)},
+    // 0b1000000
+    {"millon", Token(1'000'000, 0b1000000)}, {"millones", Token(1'000'000, 0b1000000)},
+    // 0b1000000000000
+    {"billon", Token(1'000'000'000'000, 0b1000000000000)}, {"billones", Token(1'000'000'000'000, 0b1000000000000)}
+};
+
+Maybe<Token> CSpxRegexESIntegerParser::GetNumericValue(std::string& input)
+{
+    auto result = NUMBERS.find(input.c_str());
+    if (result == NUMBERS.end())
+    {
+        return nullptr;
+    }
+    else
+    {
+        return result->second;
+    }
+}
+
+inline void NormalizeChar(std::string& input, const std::string& target, const std::string& value)
+{
+    auto pos = input.find(target);
+    if (pos != std::string::npos)
+    {
+        input.replace(pos, target.size(), value);
+    }
+}
+
+Maybe<std::vector<Token>> CSpxRegexESIntegerParser::FromString(const std::string& input)
+{
+    std::vector<Token> output;
+    auto lowerCase = PAL::StringUtils::ToLower(input);
+
+    NormalizeChar(lowerCase, "á", "a");
+    NormalizeChar(lowerCase, "é", "e");
+    NormalizeChar(lowerCase, "í", "i");
+    NormalizeChar(lowerCase, "ó", "o");
+    NormalizeChar(lowerCase, "ú", "u");
+
+    // this filters out spaces and any punctuation that may appear
+    auto delimiters = "(\\w+)";
+    std::regex regex(delimiters);
+
+    // We scan from right to left
+    std::vector<std::string> vector{};
+    std::copy(
+        std::sregex_token_iterator(lowerCase.cbegin(), lowerCase.cend(), regex),
+        std::sregex_token_iterator(),
+        std::back_inserter(vector));
+
+    for (auto& token : vector)
+    {
+        // if the token is a connector type
+        if (token == "y")
+        {
+            output.push_back(Token{});
+            continue;
+        }
+        // if the token is found in the map of hardocded entities
+        auto numericValue = GetNumericValue(token);
+        if (numericValue)
+        {
+            output.push_back(numericValue.Get());
+        }
+        else
+        {
+            // if the token can be casted to a number
+            try
+            {
+                uint64_t value = std::stol(token);
+                auto explicitToken = Token
+                {
+                    value,
+                    0b1111111111111111,
+                    Tag::Explicit
+                };
+                output.push_back(explicitToken);
+            }
+            catch (std::invalid_argument&)
+            {
+                SPX_TRACE_ERROR("Error parsing number in pattern matched", token.c_str());
+                return nullptr;
+            }
+            catch (std::out_of_range&)
+            {
+                SPX_TRACE_ERROR("Error parsing number in pattern matched", token.c_str());
+                return nullptr;
+            }
+        }
+    }
+
+    return output;
+}
+// End of Parser section
+
+// Beginning of segmentation section
+std::vector<std::vector<Token>> CSpxRegexESIntegerParser::Segment(std::vector<Token> input)
+{
+    // the segmenter needs to read the tokens from right to left
+    std::reverse(input.begin(), input.end());
+
+    std::vector<std::vector<Token>> output;
+    std::deque<Token> acc;
+
+    // uint16_t cummulative_mask = 0b1;
+
+    for (auto token : input)
+    {
+        // we always want to push numbers if we are just starting, never start with "y"
+        if (token.Type != Tag::Connector && acc.empty())
+        {
+            acc.push_front(token);
+        }
+        // The front of "acc" is a connector and the token has a valid mask to follow up numbers between [1 and 9]
+        // We verify that there is a connector token afterwards
+        else if (token.DigitMask == 0b10
+            && token.Type != Tag::Connector
+            && !acc.empty()
+            && acc.front().Type == Tag::Connector)
+        {
+            acc.push_front(token);
+        }
+        // is the current token not "y" and has non-overlapping masks with the latest "acc"
+        // Numbers with masks higher than 0b10 don't use a connector
+        else if (token.Type != Tag::Connector
+            && token.DigitMask > 0b10
+            && !acc.empty()
+            && (acc.front().Type != Tag::Connector)
+            && (token.DigitMask & acc.front().DigitMask) == 0
+            && (token.Value > acc.front().Value))
+        {
+            acc.push_front(token);
+        }
+        // We only add connector tokens if they come after numbers with a mask that allows it e.g. [1 - 9]
+        else if (token.Type == Tag::Connector
+            && !acc.empty()
+            && acc.front().Value != 0
+            && acc.front().DigitMask == 0b1)
+        {
+            acc.push_front(token);
+        }
+        else
+        {
+            // we commit contents of the accumulator to the output
+            // while reversing the order as the "parser" expects it
+            std::vector<Token> as_vector(
+                std::make_move_iterator(acc.begin()),
+                std::make_move_iterator(acc.end()));
+
+            output.push_back(as_vector);
+
+            // we clear the accumulator
+            acc = std::deque<Token>{};
+            acc.push_front(token);
+        }
+    }
+
+    if (!acc.empty())
+    {
+        std::vector<Token> as_vector(
+            std::make_move_iterator(acc.begin()),
+            std::make_move_iterator(acc.end()));
+
+        output.push_back(as_vector);
+    }
+
+    return output;
+}
+// End of segmentation section
+
+// Beginning of aggregation section
+inline uint64_t AggregateAcc(std::deque<uint64_t> numbers)
+{
+    auto accumulator = 0LL;
+    while (!numbers.empty())
+    {
+        auto value = numbers.front();
+        numbers.pop_front();
+        accumulator += value;
+    }
+
+    return accumulator;
+}
+
+constexpr bool CSpxRegexESIntegerParser::IsMultiplier(const uint64_t& input)
+{
+    return input % 1000 == 0;
+}
+
+Maybe<uint64_t> CSpxRegexESIntegerParser::AsInteger(const std::vector<Token>& numbers)
+{
+    // if the number is only a connector we fail as we don't want to return `0`
+    if (numbers.size() == 1 && numbers.front().Type == Tag::Connector)
+    {
+        return nullptr;
+    }
+
+    std::deque<uint64_t> total;
+
+    uint64_t acc = 0LL;
+    bool wasLastIterationMultiplication = false;
+    for (auto& token : numbers)
+    {
+        if (token.Type == Tag::Connector)
+        {
+            continue;
+        }
+        uint64_t input = token.Value;
+
+        // we only start operating on an accumalator that has been initialised
+        if (acc > 0)
+        {
+            // multipliers are numbers divisible by 1000
+            auto isMulti = IsMultiplier(input);
+
+            // accumulator are groups of numbers of length at most xxx
+            // namely up to the hundreds digit
+            if (isMulti && acc < input)
+            {
+                wasLastIterationMultiplication = true;
+                acc *= input;
+            }
+            // if did not multiply the accumulator in the previous iteration
+            // it means that we are still working in an xxx number group
+            // that will be eventually multiplied (unless is the last one)
+            else if (!isMulti && acc > input && !wasLastIterationMultiplication)
+            {
+                wasLastIterationMultiplication = false;
+                acc += input;
+            }
+            // If we have reached a number where that is bigger than the latest
+            // accumulator, it means that we commit the result to the accumulator
+            // and we start the next group of xxx
+            else
+            {
+                wasLastIterationMultiplication = false;
+                total.push_front(acc);
+                acc = input;
+            }
+        }
+        // We initialise te accumulator
+        else
+        {
+            acc = input;
+        }
+    }
+
+    // we break off the for loop before we are able to commit the last bit
+    total.push_front(acc);
+
+    // we collapse the deque by adding all its elements
+    return AggregateAcc(total);
+}
+
+Maybe<std::string> CSpxRegexESIntegerParser::Aggregate(const std::vector<std::vector<Token>>& numbers)
+{
+    std::ostringstream output;
+    auto it = numbers.rbegin();
+    auto end = numbers.rend();
+
+    while (it != end)
+    {
+        const auto& number = *it;
+        auto result = AsInteger(number);
+        if (result)
+        {
+            output << result.Get();
+        }
+        else
+        {
+            return nullptr;
+        }
+        it++;
+    }
+    return output.str();
+}
+
+// End of aggregation section
+
+ // --- ISpxIntegerParser ---
+Maybe<std::string> CSpxRegexESIntegerParser::Parse(const std::string& input) const
+{
+    auto parsed = FromString(input);
+    if (parsed)
+    {
+        auto segmented = Segment(parsed.Get());
+        auto result = Aggregate(segmented);
+        return result;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+}
+
+namespace WideStringJA {
+
+class CSpxWideStringJAIntegerParser
+{
+public:
+    Maybe<std::string> Parse(const std::string& input) const;
+
+private:
+    static Maybe<std::vector<Token>> FromString(const std::string& input);
+    static Maybe<Token> GetNumericValue(std::string& input);
+    static std::vector<std::vector<Token>> Segment(std::vector<Token> input);
+    constexpr static bool IsMultiplier(const uint64_t& input);
+    static Maybe<std::string> Aggregate(std::vector<std::vector<Token>> numbers);
+    static Maybe<uint64_t> AsInteger(std::vector<Token> input);
+};
+
+struct comparator
+{
+    bool operator()(const char* lhs, const char* rhs) const
+    {
+        return std::strcmp(lhs, rhs) < 0;
+    }
+};
+
+const static std::map<const char*, Token, comparator> NUMBERS
+{
+    // 0b1 mask
+    {"れい", Token(0, 0b1)},
+    {"レイ", Token(0, 0b1)},
+    {"まる", Token(0, 0b1)},
+    {"マル", Token(0, 0b1)},
+    {"零", Token(0, 0b1)},
+    {"０", Token(0, 0b1)},
+    {"0", Token(0, 0b1)},
+
+    {"いち", Token(1, 0b1)},
+    {"イチ", Token(1, 0b1)},
+    {"一", Token(1, 0b1)},
+    {"１", Token(1, 0b1)},
+    {"1", Token(1, 0b1)},
+
+    {"に", Token(2, 0b1)},
+    {"ニ", Token(2, 0b1)},
+    {"二", Token(2, 0b1)},
+    {"２", Token(2, 0b1)},
+    {"2", Token(2, 0b1)},
+
+    {"さん", Token(3, 0b1)},
+    {"サン", Token(3, 0b1)},
+    {"三", Token(3, 0b1)},
+    {"３", Token(3, 0b1)},
+    {"3", Token(3, 0b1)},
+
+    // should I account also for し ?
+    {"よん", Token(4, 0b1)},
+    {"ヨン", Token(4, 0b1)},
+    {"四", Token(4, 0b1)},
+    {"し", Token(4, 0b1)},
+    {"シ", Token(4, 0b1)},
+    {"４", Token(4, 0b1)},
+    {"4", Token(4, 0b1)},
+
+    {"ご", Token(5, 0b1)},
+    {"ゴ", Token(5, 0b1)},
+    {"五", Token(5, 0b1)},
+    {"五つ", Token(5, 0b1)},
+    {"５", Token(5, 0b1)},
+    {"5", Token(5, 0b1)},
+
+    {"ろく", Token(6, 0b1)},
+    {"ろっ", Token(6, 0b1)},
+    {"ロク", Token(6, 0b1)},
+    {"ロッ", Token(6, 0b1)},
+    {"六", Token(6, 0b1)},
+    {"６", Token(6, 0b1)},
+    {"6", Token(6, 0b1)},
+
+    {"なな", Token(7, 0b1)},
+    {"ナナ", Token(7, 0b1)},
+    {"七", Token(7, 0b1)},
+    {"しち", Token(7, 0b1)},
+    {"シチ", Token(7, 0b1)},
+    {"７", Token(7, 0b1)},
+    {"7", Token(7, 0b1)},
+
+    {"はち", Token(8, 0b1)},
+    {"はっ", Token(8, 0b1)},
+    {"ハチ", Token(8, 0b1)},
+    {"ハッ", Token(8, 0b1)},
+    {"八", Token(8, 0b1)},
+    {"８", Token(8, 0b1)},
+    {"8", Token(8, 0b1)},
+
+    {"きゅう", Token(9, 0b1)},
+    {"キュウ", Token(9, 0b1)},
+    {"九", Token(9, 0b1)},
+    {"く", Token(9, 0b1)},
+    {"ク", Token(9, 0b1)},
+    {"９", Token(9, 0b1)},
+    {"9", Token(9, 0b1)},
+
+    // 0b11 mask
+    {"じゅう", Token(10, 0b10)},
+    {"ジュウ", Token(10, 0b10)},
+    {"十", Token(10, 0b10)},
+
+    // 0b111
+    {"ひゃく", Token(100, 0b100)},
+    {"ヒャク", Token(100, 0b100)},
+    {"びゃく", Token(100, 0b100)},
+    {"ビャク", Token(100, 0b100)},
+    {"ぴゃく", Token(100, 0b100)},
+    {"ピャク", Token(100, 0b100)},
+    {"百", Token(100, 0b100)}
+};
+
+// Section start: Parser
+Maybe<Token> CSpxWideStringJAIntegerParser::GetNumericValue(std::string& input)
+{
+    auto result = NUMBERS.find(input.c_str());
+    if (result == NUMBERS.end())
+    {
+        return nullptr;
+    }
+    else
+    {
+        return result->second;
+    }
+}
+
+Maybe<std::vector<Token>> CSpxWideStringJAIntegerParser::FromString(const std::string& input)
+{
+    std::vector<Token> output;
+
+    // Convert the input string to a wide string
+    std::wstring winput = PAL::ToWString(input);
+
+    std::vector<wchar_t> accumulator = {};
+
+    // Iterate over the wide string from beginning to end appending characters to the
+    // accumulator until we get a match
+    for (auto it = winput.begin(); it != winput.end(); ++it)
+    {
+        // Print each wide character as a UTF-8 encoded string
+        accumulator.push_back(*it);
+        std::wstring w_accumulated(accumulator.begin(), accumulator.end());
+        std::string accumulated = PAL::ToString(w_accumulated);
+
+        auto token = GetNumericValue(accumulated);
+        if (token)
+        {
+            // std::cout << token.Get().value << std::endl;
+            output.push_back(token.Get());
+            accumulator = {};
+        }
+    }
+    return output;
+}
+//Section end: Parser
+
+// Section start: Segmenter
+std::vector<std::vector<Token>> CSpxWideStringJAIntegerParser::Segment(std::vector<Token> input)
+{
+    std::vector<std::vector<Token>> output;
+    std::deque<Token> acc;
+
+    uint16_t cummulative_mask = 0b0;
+
+    for (auto token : input)
+    {
+        // update cumulative_mask
+        // we adjust the new cummulative mask accoding to whether in new one is a multiplier or not
+        uint16_t new_digit_mask = 0b0;
+        if (cummulative_mask == 0b0)
+        {
+            new_digit_mask = token.DigitMask;
+        }
+        else if (IsMultiplier(token.Value))
+        {
+            // Our current smallest digit needs to be conflated with the incoming multiplier
+            // therefore we take the value, using the mask, to see if present
+            // and subtract it from the current cummulative mas
+            new_digit_mask = (cummulative_mask & 0b1) * token.DigitMask;
+            cummulative_mask -= 1;
+            // this means that we have set a multiplier earlier that is greater than the current one
+            // therefore we need to restore that information
+            if (cummulative_mask > new_digit_mask)
+            {
+                new_digit_mask += cummulative_mask;
+            }
+            // TODO for multipliers that would multiply each other we need to add logic here
+            // support for 十万 for example (10x10000)
+        }
+        else
+        {
+            new_digit_mask = cummulative_mask | token.DigitMask;
+        }
+
+        // add token to new group or append to existing group
+        if (new_digit_mask > cummulative_mask)
+        {
+            acc.push_back(token);
+            cummulative_mask = new_digit_mask;
+        }
+        else
+        {
+            std::vector<Token> as_vector(
+                std::make_move_iterator(acc.begin()),
+                std::make_move_iterator(acc.end()));
+
+            output.push_back(as_vector);
+
+            // we clear the accumulator
+            acc = std::deque<Token>{};
+            // We reset the cummulative mask to the carry token added to the accumulator
+            // starting the new number
+            cummulative_mask = token.DigitMask;
+            acc.push_back(token);
+        }
+    }
+
+    // Residual unaddressed last value in the accumulator
+    if (!acc.empty())
+    {
+        std::vector<Token> as_vector(
+            std::make_move_iterator(acc.begin()),
+            std::make_move_iterator(acc.end()));
+
+        output.push_back(as_vector);
+    }
+    return output;
+}
+
+constexpr bool CSpxWideStringJAIntegerParser::IsMultiplier(const uint64_t& input)
+{
+    return input == 10 || input == 100;
+}
+// Section end: Segmenter
+
+// Section start: Aggregator
+inline uint64_t AggregateAcc(std::deque<uint64_t> numbers)
+{
+    uint64_t accumulator = 0;
+    while (!numbers.empty())
+    {
+        auto value = numbers.front();
+        numbers.pop_front();
+        accumulator += value;
+    }
+
+    return accumulator;
+}
+
+Maybe<std::string> CSpxWideStringJAIntegerParser::Aggregate(std::vector<std::vector<Token>> numbers)
+{
+    std::ostringstream output;
+    auto it = numbers.begin();
+    auto end = numbers.end();
+
+    while (it != end) {
+        const auto& number = *it;
+        auto result = AsInteger(number);
+        if (result) {
+            output << result.Get();
+        } else {
+            // TODO do we ignore or abort on failure?
+            // return nullptr;
+        }
+        it++;
+    }
+    return output.str();
+}
+
+Maybe<uint64_t> CSpxWideStringJAIntegerParser::AsInteger(std::vector<Token> numbers)
+{
+    // if the number is only a connector we fail as we don't want to return `0`
+    if (numbers.size() == 1 && numbers.front().Type == Tag::Connector)
+    {
+        return nullptr;
+    }
+
+    std::deque<uint64_t> total;
+
+    uint64_t acc = 0LL;
+    bool wasLastIterationMultiplication = false;
+    for (auto& token : numbers)
+    {
+        if (token.Type == Tag::Connector)
+        {
+            continue;
+        }
+        uint64_t input = token.Value;
+
+        // we only start operating on an accumalator that has been initialised
+        if (acc > 0)
+        {
+            // multipliers are numbers divisible by 1000
+            auto isMulti = IsMultiplier(input);
+
+            // accumulator are groups of numbers of length at most xxx
+            // namely up to the hundreds digit
+            if (isMulti && acc < input)
+            {
+                wasLastIterationMultiplication = true;
+                acc *= input;
+            }
+            // if did not multiply the accumulator in the previous iteration
+            // it means that we are still working in an xxx number group
+            // that will be eventually multiplied (unless is the last one)
+            else if (!isMulti && acc > input && !wasLastIterationMultiplication)
+            {
+                wasLastIterationMultiplication = false;
+                acc += input;
+            }
+            // If we have reached a number where that is bigger than the latest
+            // accumulator, it means that we commit the result to the accumulator
+            // and we start the next group of xxx
+            else
+            {
+                wasLastIterationMultiplication = false;
+                total.push_front(acc);
+                acc = input;
+            }
+        }
+        // We initialise te accumulator
+        else
+        {
+            acc = input;
+        }
+    }
+
+    // we break off the for loop before we are able to commit the last bit
+    total.push_front(acc);
+
+    // we collapse the deque by adding all its elements
+    return AggregateAcc(total);
+}
+// Section end: Aggregator
+
+ // --- ISpxIntegerParser ---
+Maybe<std::string> CSpxWideStringJAIntegerParser::Parse(const std::string& input) const
+{
+    auto parsed = FromString(input);
+    if (parsed && !parsed.Get().empty())
+    {
+        auto segmented = Segment(parsed.Get());
+        auto result = Aggregate(segmented);
+        return result;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+}
+
+std::string Describe(const Maybe<std::string>& value)
+{
+    return value ? value.Get() : "<no number>";
+}
+
+std::string Pick(std::mt19937& random, const std::vector<std::string>& choices)
+{
+    return choices[std::uniform_int_distribution<size_t>(0, choices.size() - 1)(random)];
+}
+
+std::string SpellEN(uint64_t number)
+{
+    static const std::vector<std::string> Ones = { "zero", "one", "two", "three", "four", "five", "six", "seven", "eight",
+        "nine", "ten", "eleven", "twelve", "thirteen", "fourteen", "fifteen", "sixteen", "seventeen", "eighteen", "nineteen" };
+    static const std::vector<std::string> Tens = { "", "", "twenty", "thirty", "forty", "fifty", "sixty", "seventy", "eighty", "ninety" };
+    static const std::vector<std::pair<uint64_t, std::string>> Scales = {
+        { 1000000000000, "trillion" }, { 1000000000, "billion" }, { 1000000, "million" }, { 1000, "thousand" }, { 100, "hundred" } };
+
+    if (number < 20)
+    {
+        return Ones[number];
+    }
+    if (number < 100)
+    {
+        return Tens[number / 10] + (number % 10 != 0 ? "-" + Ones[number % 10] : "");
+    }
+    for (const auto& scale : Scales)
+    {
+        if (number >= scale.first)
+        {
+            auto spelled = SpellEN(number / scale.first) + " " + scale.second;
+            return number % scale.first != 0 ? spelled + " " + SpellEN(number % scale.first) : spelled;
+        }
+    }
+    return std::string();
+}
+
+std::string SpellZH(uint64_t number)
+{
+    static const std::vector<std::string> Digits = { u8"零", u8"一", u8"二", u8"三", u8"四", u8"五", u8"六", u8"七", u8"八", u8"九" };
+    static const std::vector<std::string> Units = { "", u8"十", u8"百", u8"千" };
+
+    if (number == 0)
+    {
+        return Digits[0];
+    }
+    std::string spelled;
+    bool zero = false;
+    for (int unit = 3; unit >= 0; unit--)
+    {
+        auto digit = (number / static_cast<uint64_t>(std::pow(10, unit))) % 10;
+        if (digit == 0)
+        {
+            zero = !spelled.empty();
+            continue;
+        }
+        if (zero)
+        {
+            spelled += Digits[0];
+            zero = false;
+        }
+        if (!(digit == 1 && unit == 1 && spelled.empty()))
+        {
+            spelled += Digits[digit];
+        }
+        spelled += Units[unit];
+    }
+    return spelled;
+}
+
+std::vector<std::string> ENCorpus()
+{
+    const std::vector<std::string> words = {
+        "a", "an", "and", "zero", "oh", "one", "two", "too", "to", "three", "four", "for", "fore", "five", "six", "seven",
+        "eight", "nine", "ten", "eleven", "twelve", "dozen", "dozens", "thirteen", "fifteen", "nineteen", "twenty", "forty",
+        "ninety", "hundred", "thousand", "million", "mln", "billion", "bln", "trillion", "tln", "lakh", "crore", "score",
+        "first", "second", "secondary", "half", "halves", "third", "quarter", "quarters", "fifth", "nineth", "twelfth",
+        "twentieth", "hundredth", "hundredths", "thousandth", "millionths", "minus", "negative",
+        "One", "TWENTY", "Hundred", "First", "A", "AND", "Minus",
+        "0", "7", "42", "007", "1000", "123456789", "99999999999999999999", "1st", "2nd", "3rd", "4th", "21st", "1ST", "2Nd",
+        "the", "apples", "Bob", "x", "_", "one_two", "1a", "12and", "oneself", u8"é", "k", "m" };
+    const std::vector<std::string> separators = { " ", " ", " ", " ", "-", " - ", " -", "- ", ",", ", ", "  ", "\t", "\n", "." };
+    const std::vector<std::string> prefixes = { "", "", "", "", "-", "minus ", "negative ", " ", "Minus ", "--" };
+    const std::vector<std::string> suffixes = { "", "", "", " ", "-", "\r", "," };
+
+    std::vector<std::string> corpus;
+    std::mt19937 random(2021);
+    for (int i = 0; i < 3000; i++)
+    {
+        auto input = Pick(random, prefixes) + Pick(random, words);
+        auto count = std::uniform_int_distribution<int>(0, 5)(random);
+        for (int word = 0; word < count; word++)
+        {
+            input += Pick(random, separators) + Pick(random, words);
+        }
+        corpus.push_back(input + Pick(random, suffixes));
+    }
+    for (uint64_t number = 0; number <= 1100; number += number < 130 ? 1 : 37)
+    {
+        corpus.push_back(SpellEN(number));
+    }
+    std::uniform_int_distribution<uint64_t> large(0, 999999999999999);
+    for (int i = 0; i < 500; i++)
+    {
+        auto number = large(random) >> std::uniform_int_distribution<int>(0, 48)(random);
+        corpus.push_back(SpellEN(number));
+        corpus.push_back(Pick(random, prefixes) + SpellEN(number));
+        corpus.push_back(std::to_string(number % 1000) + " " + SpellEN(number));
+    }
+    return corpus;
+}
+
+std::vector<std::string> ZHCorpus()
+{
+    const std::vector<std::string> pieces = {
+        u8"零", u8"一", u8"幺", u8"二", u8"两", u8"俩", u8"三", u8"仨", u8"四", u8"五", u8"六", u8"七", u8"八", u8"九", u8"十",
+        u8"百", u8"千", u8"〇", u8"壹", u8"贰", u8"兩", u8"倆", u8"叁", u8"肆", u8"伍", u8"陆", u8"陸", u8"柒", u8"捌", u8"玖",
+        u8"拾", u8"佰", u8"仟", "k", "K", "0", "1", "05", "10", "123", "99999999999999999999",
+        u8"万", u8"亿", u8"个", u8"号", u8"é", u8"，", "a", " ", " ", "\t", "  " };
+
+    std::vector<std::string> corpus;
+    std::mt19937 random(2021);
+    for (int i = 0; i < 3000; i++)
+    {
+        std::string input;
+        auto count = std::uniform_int_distribution<int>(1, 8)(random);
+        for (int piece = 0; piece < count; piece++)
+        {
+            input += Pick(random, pieces);
+        }
+        corpus.push_back(input);
+    }
+    for (uint64_t number = 0; number <= 9999; number += number < 130 ? 1 : 37)
+    {
+        corpus.push_back(SpellZH(number));
+        corpus.push_back(" " + SpellZH(number) + u8"个");
+    }
+    return corpus;
+}
+
+std::vector<std::string> ESCorpus()
+{
+    const std::vector<std::string> words = {
+        "cero", "uno", "un", "una", "dos", "tres", "cuatro", "cinco", "seis", "siete", "ocho", "nueve", "diez", "once",
+        "quince", "dieciseis", u8"dieciséis", "diecinueve", "veinte", "veintiuno", "veintidos", u8"veintidós", u8"veintitrés",
+        "vientinueve", "treinta", "cuarenta", "noventa", "cien", "ciento", "doscientos", "quinientos", "novecientos", "mil",
+        "millon", u8"millón", "millones", "billon", u8"billón", "billones", "y", "y", "y", "Y", "DOS", "Mil", u8"MILLÓN",
+        "0", "7", "42", "1000", "99999999999999999999", "12abc", "_5", "hola", u8"niño", u8"años", u8"á", u8"é" };
+    const std::vector<std::string> separators = { " ", " ", " ", " ", ",", ", ", "-", ".", "  ", "\t" };
+
+    std::vector<std::string> corpus;
+    std::mt19937 random(2022);
+    for (int i = 0; i < 3000; i++)
+    {
+        auto input = Pick(random, words);
+        auto count = std::uniform_int_distribution<int>(0, 5)(random);
+        for (int word = 0; word < count; word++)
+        {
+            input += Pick(random, separators) + Pick(random, words);
+        }
+        corpus.push_back(input);
+    }
+    return corpus;
+}
+
+std::vector<std::string> FRCorpus()
+{
+    const std::vector<std::string> words = {
+        "zéro", "un", "une", "deux", "trois", "quatre", "cinq", "six", "sept", "huit", "neuf", "dix", "onze", "douze",
+        "seize", "vingt", "vingts", "trente", "soixante", "cent", "cents", "mille", "et", "premier", "1er", "er",
+        "dix-sept", "quatre-vingt", "soixante-et-onze", "moins", "négatif", "douzaine", "0", "7", "42", "1.000", "3,5",
+        "bonjour", "pommes", "Un", "x", "é" };
+    const std::vector<std::string> separators = { " ", " ", " ", " ", "-", "  ", ",", ".", "\t" };
+
+    std::vector<std::string> corpus;
+    std::mt19937 random(2023);
+    for (int i = 0; i < 3000; i++)
+    {
+        auto input = Pick(random, words);
+        auto count = std::uniform_int_distribution<int>(0, 5)(random);
+        for (int word = 0; word < count; word++)
+        {
+            input += Pick(random, separators) + Pick(random, words);
+        }
+        corpus.push_back(input);
+    }
+    return corpus;
+}
+
+// Every word of an input the parser reads as a number must be one the parser may have in a number.
+template<typename TParser>
+void CheckWordsOfNumbers(const TParser& parser, const std::vector<std::string>& corpus)
+{
+    for (const auto& input : corpus)
+    {
+        if (!parser.Parse(input))
+        {
+            continue;
+        }
+        CAPTURE(input);
+        size_t start = 0;
+        while (start < input.length())
+        {
+            auto end = input.find(' ', start);
+            end = end == std::string::npos ? input.length() : end;
+            if (end > start)
+            {
+                auto word = input.substr(start, end - start);
+                CAPTURE(word);
+                CHECK(parser.MayContainWord(word));
+            }
+            start = end + 1;
+        }
+    }
+}
+
+std::vector<std::string> JACorpus()
+{
+    const std::vector<std::string> pieces = {
+        u8"れい", u8"レイ", u8"まる", u8"零", u8"０", "0", u8"いち", u8"一", u8"１", "1", u8"に", u8"二", "2", u8"さん",
+        u8"サン", u8"三", u8"よん", u8"四", u8"し", u8"シ", u8"４", u8"ご", u8"五", u8"五つ", "5", u8"ろく", u8"ろっ", u8"ロク",
+        u8"六", u8"なな", u8"七", u8"しち", u8"シチ", u8"はち", u8"はっ", u8"八", u8"きゅう", u8"九", u8"く", u8"９",
+        u8"じゅう", u8"ジュウ", u8"十", u8"ひゃく", u8"びゃく", u8"ぴゃく", u8"百", u8"個", u8"円", u8"つ", u8"ち", u8"ゅ",
+        "a", " ", u8"、" };
+
+    std::vector<std::string> corpus;
+    std::mt19937 random(2022);
+    for (int i = 0; i < 3000; i++)
+    {
+        std::string input;
+        auto count = std::uniform_int_distribution<int>(1, 6)(random);
+        for (int piece = 0; piece < count; piece++)
+        {
+            input += Pick(random, pieces);
+        }
+        corpus.push_back(input);
+    }
+    return corpus;
+}
+
+}
+
+TEST_CASE("IntentRecognizer::IntegerParsers::EN parser matches the regex parser", "[en]")
+{
+    CSpxENIntegerParser parser;
+    RegexEN::CSpxRegexENIntegerParser reference;
+    for (const auto& input : ENCorpus())
+    {
+        CAPTURE(input);
+        CHECK(Describe(parser.Parse(input)) == Describe(reference.Parse(input)));
+    }
+}
+
+TEST_CASE("IntentRecognizer::IntegerParsers::ZH parser matches the regex parser", "[zh]")
+{
+    CSpxZHIntegerParser parser;
+    RegexZH::CSpxRegexZHIntegerParser reference;
+    for (const auto& input : ZHCorpus())
+    {
+        CAPTURE(input);
+        CHECK(Describe(parser.Parse(input)) == Describe(reference.Parse(input)));
+    }
+}
+
+TEST_CASE("IntentRecognizer::IntegerParsers::ES parser matches the regex parser", "[es]")
+{
+    CSpxESIntegerParser parser;
+    RegexES::CSpxRegexESIntegerParser reference;
+    for (const auto& input : ESCorpus())
+    {
+        CAPTURE(input);
+        CHECK(Describe(parser.Parse(input)) == Describe(reference.Parse(input)));
+    }
+}
+
+TEST_CASE("IntentRecognizer::IntegerParsers::JA parser matches the wide string parser", "[ja]")
+{
+    CSpxJPIntegerParser parser;
+    WideStringJA::CSpxWideStringJAIntegerParser reference;
+    for (const auto& input : JACorpus())
+    {
+        CAPTURE(input);
+        CHECK(Describe(parser.Parse(input)) == Describe(reference.Parse(input)));
+    }
+}
+
+TEST_CASE("IntentRecognizer::IntegerParsers::Words of numbers may be in numbers", "[words]")
+{
+    CheckWordsOfNumbers(CSpxENIntegerParser{}, ENCorpus());
+    CheckWordsOfNumbers(CSpxZHIntegerParser{}, ZHCorpus());
+    CheckWordsOfNumbers(CSpxESIntegerParser{}, ESCorpus());
+    CheckWordsOfNumbers(CSpxFRIntegerParser{}, FRCorpus());
+    CheckWordsOfNumbers(CSpxJPIntegerParser{}, JACorpus());
+}
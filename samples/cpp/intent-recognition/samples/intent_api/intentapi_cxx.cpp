@@ -7,6 +7,11 @@
 
 #include <intentapi_cxx.h>
 
+#include <compiled_model.h>
+#include <list_entity.h>
+
+#include <algorithm>
+#include <atomic>
 #include <future>
 #include <sstream>
 #include <stdexcept>
@@ -18,23 +23,54 @@ IntentRecognitionResult::IntentRecognitionResult(std::string& intentId, std::str
 {
     m_storage->intentId = intentId;
     m_storage->detailedJsonResult = detailedJsonResult;
+    std::call_once(m_storage->detailedJsonResultRendered, []() {});
     PopulateIntentFields(jsonResult);
 }
 
+IntentRecognitionResult::IntentRecognitionResult(const Impl::IntentRecognitionOutput& output)
+    : m_storage(new Storage()), IntentId(m_storage->intentId)
+{
+    m_storage->intentId = output.IntentId;
+    m_storage->matches = output.Matches;
+
+    // Same as parsing the simple result JSON, without building it: the entities of the best match that have a value.
+    if (!output.Matches.empty())
+    {
+        for (auto& entity : output.Matches.front()->GetEntities())
+        {
+            if (!entity.second.Value.empty())
+            {
+                m_storage->entities[entity.first] = entity.second.Value;
+            }
+        }
+    }
+}
+
 IntentRecognitionResult::IntentRecognitionResult(const IntentRecognitionResult& other)
-    : m_storage(new Storage(*other.m_storage)), IntentId(m_storage->intentId)
+    : m_storage(new Storage()), IntentId(m_storage->intentId)
 {
+    CopyFrom(other);
 }
 
 IntentRecognitionResult& IntentRecognitionResult::operator=(const IntentRecognitionResult& other)
 {
     if (this != &other)
     {
-        *m_storage = *other.m_storage;
+        CopyFrom(other);
     }
     return *this;
 }
 
+void IntentRecognitionResult::CopyFrom(const IntentRecognitionResult& other)
+{
+    // once_flag cannot be copied, so render the other result and copy the JSON.
+    m_storage->intentId = other.m_storage->intentId;
+    m_storage->entities = other.m_storage->entities;
+    m_storage->matches = other.m_storage->matches;
+    m_storage->detailedJsonResult = other.GetDetailedResult();
+    std::call_once(m_storage->detailedJsonResultRendered, []() {});
+}
+
 const std::map<std::string, std::string>& IntentRecognitionResult::GetEntities() const
 {
     return m_storage->entities;
@@ -42,6 +78,10 @@ const std::map<std::string, std::string>& IntentRecognitionResult::GetEntities()
 
 const std::string& IntentRecognitionResult::GetDetailedResult() const
 {
+    auto storage = m_storage;
+    std::call_once(storage->detailedJsonResultRendered, [storage]() {
+        storage->detailedJsonResult = CSpxIntentRecognizer::RenderDetailedJsonResult(storage->matches);
+    });
     return m_storage->detailedJsonResult;
 }
 
@@ -54,36 +94,115 @@ void IntentRecognitionResult::PopulateIntentFields(std::string& jsonResult)
 {
     auto parser = ajv::json::Parse(jsonResult);
     auto reader = parser.Reader();
+    // The lookup key is the name as written, reused across members; values and names are only copied once they are
+    // stored, and only decoded if they have escapes.
+    std::string key, valueScratch, nameScratch;
     for (auto name = reader.FirstName(); name.IsOk(); name++)
     {
-        auto key = name.AsString(false);
-        auto item = reader[key.c_str()];
-        auto value = item.AsString();
-        if (!value.empty())
+        size_t keySize = 0;
+        auto keyPtr = name.AsStringPtr(&keySize);
+        key.assign(keyPtr, keySize);
+
+        size_t valueSize = 0;
+        auto value = reader[key.c_str()].AsStringView(&valueSize, valueScratch);
+        if (valueSize > 0)
         {
-            key = name.AsString();
-            m_storage->entities[key] = value;
+            size_t nameSize = 0;
+            auto decodedName = name.AsStringView(&nameSize, nameScratch);
+            m_storage->entities[std::string(decodedName, nameSize)].assign(value, valueSize);
         }
     }
 }
 
+std::shared_ptr<PatternMatchingModel> PatternMatchingModel::FromCompiledFile(const std::string& filepath)
+{
+    std::shared_ptr<const Impl::CSpxCompiledModel> compiled;
+    try
+    {
+        compiled = Impl::CSpxCompiledModel::Load(filepath);
+    }
+    catch (const std::runtime_error&)
+    {
+        // Attempt to load the compiled model failed.
+        return nullptr;
+    }
+
+    auto model = std::shared_ptr<PatternMatchingModel>(new PatternMatchingModel(compiled->GetModelId()));
+    for (const auto& intent : compiled->GetIntents())
+    {
+        model->Intents.push_back({ intent.Phrases, intent.Id });
+    }
+    for (const auto& entity : compiled->GetEntities())
+    {
+        model->Entities.push_back({ entity.Id, entity.Type, entity.Mode, {} });
+    }
+    model->m_storage->compiled = compiled;
+    return model;
+}
+
+void PatternMatchingModel::SaveCompiledFile(const std::string& filepath) const
+{
+    Impl::CSpxCompiledModelWriter writer(m_storage->modelId);
+    for (const auto& intent : m_storage->intents)
+    {
+        writer.AddIntent(intent.Id, intent.Phrases);
+    }
+    for (const auto& entity : m_storage->entities)
+    {
+        // Lists of a loaded image keep their compiled phrases first, like they are matched.
+        auto compiledList = m_storage->compiled != nullptr && entity.Type == EntityType::List
+            ? m_storage->compiled->FindList(entity.Id)
+            : nullptr;
+        if (compiledList != nullptr)
+        {
+            std::vector<std::string> phrases;
+            phrases.reserve(compiledList->GetPhraseCount() + entity.Phrases.size());
+            for (size_t i = 0; i < compiledList->GetPhraseCount(); i++)
+            {
+                phrases.push_back(compiledList->GetPhrase(i));
+            }
+            phrases.insert(phrases.end(), entity.Phrases.begin(), entity.Phrases.end());
+            writer.AddEntity(entity.Id, entity.Type, entity.Mode, phrases);
+        }
+        else
+        {
+            writer.AddEntity(entity.Id, entity.Type, entity.Mode, entity.Phrases);
+        }
+    }
+    writer.Write(filepath);
+}
+
 std::shared_ptr<IntentRecognizer> IntentRecognizer::FromLanguage(const std::string& language)
 {
     return std::make_shared<IntentRecognizer>(language);
 }
 
+std::shared_ptr<IntentRecognizer> IntentRecognizer::FromLanguage(const std::string& language, size_t workerThreads)
+{
+    return std::make_shared<IntentRecognizer>(language, workerThreads);
+}
+
 IntentRecognizer::IntentRecognizer(const std::string& language)
     : m_state(new State())
 {
     m_state->language = language;
     m_state->recognizer = std::make_shared<CSpxIntentRecognizer>(language);
     m_state->recognizer->Init();
+    m_state->threadPool = CSpxThreadPool::Default();
+}
+
+IntentRecognizer::IntentRecognizer(const std::string& language, size_t workerThreads)
+    : IntentRecognizer(language)
+{
+    m_state->threadPool = std::make_shared<CSpxThreadPool>(workerThreads);
 }
 
 IntentRecognizer::~IntentRecognizer()
 {
     if (m_state != nullptr)
     {
+        // Let a pool of our own finish pending recognitions before terminating the recognizer.
+        m_state->threadPool.reset();
         if (m_state->recognizer)
         {
             m_state->recognizer->Term();
@@ -96,17 +215,97 @@ IntentRecognizer::~IntentRecognizer()
 std::future<std::shared_ptr<IntentRecognitionResult>> IntentRecognizer::RecognizeOnceAsync(std::string text)
 {
     auto recognizer = m_state->recognizer;
-    auto future = std::async(std::launch::async, [recognizer, text]() -> std::shared_ptr<IntentRecognitionResult> {
-        std::string intentId;
-        std::string jsonResult;
-        std::string detailedJsonResult;
-        recognizer->ProcessText(text, intentId, jsonResult, detailedJsonResult);
-
-        return std::make_shared<IntentRecognitionResult>(intentId, jsonResult, detailedJsonResult);
+    auto options = GetModelMatchingOptions();
+    auto future = m_state->threadPool->Submit([recognizer, text, options]() -> std::shared_ptr<IntentRecognitionResult> {
+        return std::make_shared<IntentRecognitionResult>(recognizer->ProcessText(text, options));
     });
     return future;
 }
 
+std::future<std::vector<std::shared_ptr<IntentRecognitionResult>>> IntentRecognizer::RecognizeBatchAsync(std::vector<std::string> texts)
+{
+    // Shared by the work items of one batch, the last one to finish fulfills the promise.
+    struct Batch
+    {
+        std::vector<std::string> texts;
+        std::vector<std::shared_ptr<IntentRecognitionResult>> results;
+        std::atomic<size_t> pendingChunks{ 0 };
+        std::atomic<bool> failed{ false };
+        std::promise<std::vector<std::shared_ptr<IntentRecognitionResult>>> promise;
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->texts = std::move(texts);
+    batch->results.resize(batch->texts.size());
+    auto future = batch->promise.get_future();
+
+    if (batch->texts.empty())
+    {
+        batch->promise.set_value({});
+        return future;
+    }
+
+    // One contiguous chunk of texts per worker keeps the queue short and every worker busy.
+    auto threadPool = m_state->threadPool;
+    auto chunkCount = std::min(batch->texts.size(), threadPool->GetThreadCount());
+    auto chunkSize = (batch->texts.size() + chunkCount - 1) / chunkCount;
+    chunkCount = (batch->texts.size() + chunkSize - 1) / chunkSize;
+    batch->pendingChunks = chunkCount;
+
+    auto recognizer = m_state->recognizer;
+    auto options = GetModelMatchingOptions();
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        auto begin = chunk * chunkSize;
+        auto end = std::min(begin + chunkSize, batch->texts.size());
+        threadPool->Post([recognizer, batch, begin, end, options]() {
+            try
+            {
+                // The output buffers are reused for every text of the chunk.
+                IntentRecognitionOutput output;
+                for (auto index = begin; index < end && !batch->failed; index++)
+                {
+                    recognizer->ProcessText(batch->texts[index], output, options);
+                    batch->results[index] = std::make_shared<IntentRecognitionResult>(output);
+                }
+            }
+            catch (...)
+            {
+                // Only the first failure is reported.
+                if (!batch->failed.exchange(true))
+                {
+                    batch->promise.set_exception(std::current_exception());
+                }
+            }
+
+            if (--batch->pendingChunks == 0 && !batch->failed)
+            {
+                batch->promise.set_value(std::move(batch->results));
+            }
+        });
+    }
+    return future;
+}
+
+void IntentRecognizer::SetParallelModelMatching(bool enabled)
+{
+    m_state->parallelModelMatching = enabled;
+}
+
+void IntentRecognizer::SetStopAtExactMatch(bool enabled)
+{
+    m_state->stopAtExactMatch = enabled;
+}
+
+ModelMatchingOptions IntentRecognizer::GetModelMatchingOptions() const
+{
+    // Recognitions run on the pool, so it outlives them and a plain pointer is enough.
+    ModelMatchingOptions options;
+    options.ThreadPool = m_state->parallelModelMatching ? m_state->threadPool.get() : nullptr;
+    options.StopAtExactMatch = m_state->stopAtExactMatch;
+    return options;
+}
+
 void IntentRecognizer::AddIntent(const std::string& simplePhrase)
 {
     auto trigger = std::shared_ptr<ISpxTrigger>(new CSpxIntentTrigger());
@@ -197,6 +396,58 @@ bool IntentRecognizer::ApplyLanguageModels(const std::vector<std::shared_ptr<Lan
     return result;
 }
 
+bool IntentRecognizer::UpdateListEntity(const std::string& modelId, const std::string& entityId, const std::vector<std::string>& removedPhrases, const std::vector<std::string>& addedPhrases)
+{
+    auto model = m_state->recognizer->FindPatternMatchingModel(modelId);
+    return model != nullptr && model->UpdateListEntity(entityId, removedPhrases, addedPhrases);
+}
+
+bool IntentRecognizer::AddIntentPhrases(const std::string& modelId, const PatternMatchingIntent& intent)
+{
+    auto model = m_state->recognizer->FindPatternMatchingModel(modelId);
+    if (model == nullptr)
+    {
+        return false;
+    }
+    model->AddIntent(CreatePatternMatchingIntent(*model, intent), intent.Id);
+    return true;
+}
+
+bool IntentRecognizer::RemoveIntentPhrases(const std::string& modelId, const std::string& intentId, const std::vector<std::string>& phrases)
+{
+    auto model = m_state->recognizer->FindPatternMatchingModel(modelId);
+    return model != nullptr && model->RemovePatterns(intentId, phrases);
+}
+
+bool IntentRecognizer::ReplaceIntent(const std::string& modelId, const PatternMatchingIntent& intent)
+{
+    auto model = m_state->recognizer->FindPatternMatchingModel(modelId);
+    if (model == nullptr)
+    {
+        return false;
+    }
+    model->ReplaceIntent(CreatePatternMatchingIntent(*model, intent), intent.Id);
+    return true;
+}
+
+bool IntentRecognizer::RemoveIntent(const std::string& modelId, const std::string& intentId)
+{
+    auto model = m_state->recognizer->FindPatternMatchingModel(modelId);
+    return model != nullptr && model->RemoveIntent(intentId);
+}
+
+std::shared_ptr<CSpxPatternMatchingIntent> IntentRecognizer::CreatePatternMatchingIntent(const CSpxPatternMatchingModel& model, const PatternMatchingIntent& intent) const
+{
+    // Built like the intents of AddPatternMatchingModel, before the model lock is taken.
+    auto pmIntent = std::make_shared<CSpxPatternMatchingIntent>();
+    pmIntent->Init(intent.Id, 0, model.GetOrthographyInfo().Name);
+    for (const auto& phrase : intent.Phrases)
+    {
+        pmIntent->AddPhrase(phrase);
+    }
+    return pmIntent;
+}
+
 void IntentRecognizer::AddIntent(std::shared_ptr<ISpxTrigger> trigger, const std::string& intentId)
 {
     m_state->recognizer->AddIntentTrigger(intentId, trigger, "");
@@ -236,50 +487,110 @@ void IntentRecognizer::AddPatternMatchingModel(const std::shared_ptr<LanguageUnd
         }
     };
 
+    // Normalizing list phrases and intent patterns is most of the load time, so it runs on the recognizer's pool. Each
+    // task only touches its own entity or intent, and the results are added in the order of the model, so the loaded
+    // model is the same as one loaded serially. The tasks hold on to luModel since they read its phrases, and this
+    // thread waits for them, so models must not be applied from a work item of the same pool.
+    const size_t phrasesPerTask = 4096;
+    auto threadPool = m_state->threadPool;
+
+    struct EntityLoad
+    {
+        std::shared_ptr<ISpxEntity> entity;
+        std::vector<std::future<CSpxListEntity::PreparedPhrases>> preparedPhrases;
+    };
+    std::vector<EntityLoad> entityLoads;
+    entityLoads.reserve(model->Entities.size());
+
+    auto compiled = model->m_storage->compiled;
     for (const auto& entity : model->Entities)
     {
         auto pmEntity = pmFactory->CreateEntity(entity.Type);
         pmEntity->Init(entity.Id, pmModel->GetOrthographyInfo());
         pmEntity->SetMode(entity.Mode);
 
-        auto phraseContext = static_cast<void*>(const_cast<std::vector<std::string>*>(&entity.Phrases));
-        for (size_t i = 0; i < entity.Phrases.size(); i++)
+        auto compiledList = compiled != nullptr && entity.Type == EntityType::List ? compiled->FindList(entity.Id) : nullptr;
+        if (compiledList != nullptr)
         {
-            const char* phrase = nullptr;
-            size_t phraseLen = 0;
-            auto hr = phraseGetter(phraseContext, i, &phrase, &phraseLen);
-            if (hr != PhraseGetterHr::NoError)
+            std::static_pointer_cast<CSpxListEntity>(pmEntity)->AttachCompiledList(compiledList);
+        }
+
+        EntityLoad load{ pmEntity, {} };
+        if (entity.Type == EntityType::List)
+        {
+            // Large lists are split so their phrases are normalized by several workers.
+            auto listEntity = std::static_pointer_cast<const CSpxListEntity>(pmEntity);
+            auto phrases = &entity.Phrases;
+            for (size_t begin = 0; begin < phrases->size(); begin += phrasesPerTask)
+            {
+                auto end = std::min(begin + phrasesPerTask, phrases->size());
+                load.preparedPhrases.push_back(threadPool->Submit([luModel, listEntity, phrases, begin, end]() {
+                    return listEntity->PreparePhrases(*phrases, begin, end);
+                }));
+            }
+        }
+        else
+        {
+            auto phraseContext = static_cast<void*>(const_cast<std::vector<std::string>*>(&entity.Phrases));
+            for (size_t i = 0; i < entity.Phrases.size(); i++)
             {
-                std::ostringstream msg;
-                msg << "phraseGetter error " << static_cast<int>(hr) << " with modelId " << modelId << " entity.Phrases[" << i << "] " << entity.Phrases[i];
-                throw std::runtime_error(msg.str());
+                const char* phrase = nullptr;
+                size_t phraseLen = 0;
+                auto hr = phraseGetter(phraseContext, i, &phrase, &phraseLen);
+                if (hr != PhraseGetterHr::NoError)
+                {
+                    std::ostringstream msg;
+                    msg << "phraseGetter error " << static_cast<int>(hr) << " with modelId " << modelId << " entity.Phrases[" << i << "] " << entity.Phrases[i];
+                    throw std::runtime_error(msg.str());
+                }
+                pmEntity->AddPhrase(std::string(phrase, phraseLen));
             }
-            pmEntity->AddPhrase(std::string(phrase, phraseLen));
         }
-        pmFactory->AddEntity(pmEntity);
+        entityLoads.push_back(std::move(load));
     }
 
+    std::vector<std::future<std::shared_ptr<CSpxPatternMatchingIntent>>> intentLoads;
+    intentLoads.reserve(model->Intents.size());
+
     for (const auto& intent : model->Intents)
     {
         auto pmIntent = pmFactory->CreateIntent();
         auto priority = 0;
         pmIntent->Init(intent.Id, priority, pmModel->GetOrthographyInfo().Name);
 
-        auto phraseContext = static_cast<void*>(const_cast<std::vector<std::string>*>(&intent.Phrases));
-        for (size_t i = 0; i < intent.Phrases.size(); i++)
-        {
-            const char* phrase = nullptr;
-            size_t phraseLen = 0;
-            auto hr = phraseGetter(phraseContext, i, &phrase, &phraseLen);
-            if (hr != PhraseGetterHr::NoError)
+        auto phrases = &intent.Phrases;
+        intentLoads.push_back(threadPool->Submit([luModel, pmIntent, phrases, phraseGetter, modelId]() {
+            auto phraseContext = static_cast<void*>(const_cast<std::vector<std::string>*>(phrases));
+            for (size_t i = 0; i < phrases->size(); i++)
             {
-                std::ostringstream msg;
-                msg << "phraseGetter error " << static_cast<int>(hr) << " with modelId " << modelId << " intent.Phrases[" << i << "] " << intent.Phrases[i];
-                throw std::runtime_error(msg.str());
+                const char* phrase = nullptr;
+                size_t phraseLen = 0;
+                auto hr = phraseGetter(phraseContext, i, &phrase, &phraseLen);
+                if (hr != PhraseGetterHr::NoError)
+                {
+                    std::ostringstream msg;
+                    msg << "phraseGetter error " << static_cast<int>(hr) << " with modelId " << modelId << " intent.Phrases[" << i << "] " << (*phrases)[i];
+                    throw std::runtime_error(msg.str());
+                }
+                pmIntent->AddPhrase(std::string(phrase, phraseLen));
             }
-            pmIntent->AddPhrase(std::string(phrase, phraseLen));
+            return pmIntent;
+        }));
+    }
+
+    // Merge in model order; get() rethrows what a task threw, e.g. for an invalid pattern.
+    for (auto& load : entityLoads)
+    {
+        for (auto& prepared : load.preparedPhrases)
+        {
+            std::static_pointer_cast<CSpxListEntity>(load.entity)->AddPreparedPhrases(prepared.get());
         }
-        pmFactory->AddIntent(pmIntent);
+        pmFactory->AddEntity(load.entity);
+    }
+
+    for (auto& load : intentLoads)
+    {
+        pmFactory->AddIntent(load.get());
     }
 
     auto pmTrigger = std::shared_ptr<ISpxTrigger>(new CSpxIntentTrigger());
@@ -8,6 +8,9 @@
 
 #include <string>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include <ajv.h>
 #include <intentapi_cxx_exports.h>
@@ -17,6 +20,11 @@ namespace SpeechSDK {
 namespace Standalone {
 namespace Intent {
 
+namespace Impl {
+class CSpxIntentMatchResult;
+struct IntentRecognitionOutput;
+}
+
 /// <summary>
 /// Represents the result of an intent recognition.
 /// </summary>
@@ -31,6 +39,13 @@ public:
     /// <param name="jsonResult">Simple result JSON string.</param>
     /// <param name="detailedJsonResult">Detailed result JSON string.</param>
     IntentRecognitionResult(std::string& intentId, std::string& jsonResult, std::string& detailedJsonResult);
+
+    /// <summary>
+    /// Internal constructor. Creates a new instance from the output of the recognizer. The detailed result JSON is only
+    /// built when it is first asked for.
+    /// </summary>
+    /// <param name="output">The recognizer output.</param>
+    explicit IntentRecognitionResult(const Impl::IntentRecognitionOutput& output);
     IntentRecognitionResult(const IntentRecognitionResult& other);
     IntentRecognitionResult& operator=(const IntentRecognitionResult& other);
     IntentRecognitionResult(IntentRecognitionResult&&) = delete;
@@ -60,11 +75,16 @@ public:
 private:
 
     void PopulateIntentFields(std::string& jsonResult);
+    void CopyFrom(const IntentRecognitionResult& other);
 
     struct Storage
     {
         std::string intentId;
         std::map<std::string, std::string> entities;
+
+        // The detailed result is rendered from the matches the first time it is needed.
+        std::vector<std::shared_ptr<Impl::CSpxIntentMatchResult>> matches;
+        std::once_flag detailedJsonResultRendered;
         std::string detailedJsonResult;
     };
 
@@ -9,12 +9,14 @@
 #include <future>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include <intentapi_cxx_exports.h>
 #include <intentapi_cxx_intent_recognition_result.h>
 #include <intentapi_cxx_pattern_matching_model.h>
 
 #include <intent_recognizer.h>
+#include <thread_pool.h>
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -39,12 +41,28 @@ public:
     /// <returns>Instance of intent recognizer.</returns>
     static std::shared_ptr<IntentRecognizer> FromLanguage(const std::string& language = "en-US");
 
+    /// <summary>
+    /// Creates an intent recognizer from the specified language that runs recognitions on its own worker threads.
+    /// Recognizers created without a thread count share one process-wide set of workers.
+    /// </summary>
+    /// <param name="language">Language tag in BCP 47 format.</param>
+    /// <param name="workerThreads">The number of worker threads. 0 uses one per hardware thread.</param>
+    /// <returns>Instance of intent recognizer.</returns>
+    static std::shared_ptr<IntentRecognizer> FromLanguage(const std::string& language, size_t workerThreads);
+
     /// <summary>
     /// Internal constructor. Creates a new instance from the provided language.
     /// </summary>
     /// <param name="language">Language tag in BCP 47 format.</param>
     explicit IntentRecognizer(const std::string& language);
 
+    /// <summary>
+    /// Internal constructor. Creates a new instance from the provided language with its own worker threads.
+    /// </summary>
+    /// <param name="language">Language tag in BCP 47 format.</param>
+    /// <param name="workerThreads">The number of worker threads. 0 uses one per hardware thread.</param>
+    IntentRecognizer(const std::string& language, size_t workerThreads);
+
     IntentRecognizer(const IntentRecognizer&) = delete;
     IntentRecognizer& operator=(const IntentRecognizer&) = delete;
     IntentRecognizer(IntentRecognizer&&) = delete;
@@ -65,6 +83,31 @@ public:
     /// </returns>
     std::future<std::shared_ptr<IntentRecognitionResult>> RecognizeOnceAsync(std::string text);
 
+    /// <summary>
+    /// Starts intent recognition for a batch of texts. The texts are spread across the worker threads.
+    /// It is only valid for offline pattern matching or exact matching intents.
+    /// </summary>
+    /// <param name="texts">The texts to be evaluated.</param>
+    /// <returns>Future containing one result per text (shared pointers to IntentRecognitionResult), in the order
+    /// the texts were passed in.
+    /// </returns>
+    std::future<std::vector<std::shared_ptr<IntentRecognitionResult>>> RecognizeBatchAsync(std::vector<std::string> texts);
+
+    /// <summary>
+    /// Sets whether each recognition matches the text against the applied models concurrently, on the worker threads
+    /// of the recognizer. The results are the same either way. Off by default.
+    /// </summary>
+    /// <param name="enabled">True to match models concurrently.</param>
+    void SetParallelModelMatching(bool enabled);
+
+    /// <summary>
+    /// Sets whether recognitions stop at the first applied model, in model id order, with an exact match of the top
+    /// priority. The remaining models are not matched, so the detailed result leaves out their matches, and their
+    /// exact matches are not considered. Off by default.
+    /// </summary>
+    /// <param name="enabled">True to stop at the first exact match.</param>
+    void SetStopAtExactMatch(bool enabled);
+
     /// <summary>
     /// Adds a simple phrase that may appear in the input text, indicating a specific user intent.
     /// This simple phrase can be a pattern including and enitity surrounded by braces. Such as "click the {checkboxName} checkbox".
@@ -127,9 +170,56 @@ public:
     /// <returns>True if the application of the models takes effect immediately. Otherwise false.</returns>
     bool ApplyLanguageModels(const std::vector<std::shared_ptr<LanguageUnderstandingModel>>& collection);
 
+    /// <summary>
+    /// Removes phrases from a list entity of an applied pattern matching model, then adds phrases to it, without
+    /// applying the model again. Recognitions see the list either before or after the whole update.
+    /// The PatternMatchingModel the model was applied from is not changed.
+    /// </summary>
+    /// <param name="modelId">The id of the applied pattern matching model.</param>
+    /// <param name="entityId">The id of the list entity.</param>
+    /// <param name="removedPhrases">Phrases to remove. Phrases the list does not have are ignored.</param>
+    /// <param name="addedPhrases">Phrases to add.</param>
+    /// <returns>False if there is no such model or list entity.</returns>
+    bool UpdateListEntity(const std::string& modelId, const std::string& entityId, const std::vector<std::string>& removedPhrases, const std::vector<std::string>& addedPhrases);
+
+    /// <summary>
+    /// Adds the phrases of the intent to an applied pattern matching model, to the intent with the same id if there
+    /// is one.
+    /// </summary>
+    /// <param name="modelId">The id of the applied pattern matching model.</param>
+    /// <param name="intent">The intent and the phrases to add.</param>
+    /// <returns>False if there is no such model.</returns>
+    bool AddIntentPhrases(const std::string& modelId, const PatternMatchingIntent& intent);
+
+    /// <summary>
+    /// Removes phrases from an intent of an applied pattern matching model.
+    /// </summary>
+    /// <param name="modelId">The id of the applied pattern matching model.</param>
+    /// <param name="intentId">The id of the intent.</param>
+    /// <param name="phrases">The phrases to remove, as they were added.</param>
+    /// <returns>False if there is no such model or intent, or the intent has none of the phrases.</returns>
+    bool RemoveIntentPhrases(const std::string& modelId, const std::string& intentId, const std::vector<std::string>& phrases);
+
+    /// <summary>
+    /// Replaces an intent of an applied pattern matching model and all of its phrases, or adds it.
+    /// </summary>
+    /// <param name="modelId">The id of the applied pattern matching model.</param>
+    /// <param name="intent">The new intent.</param>
+    /// <returns>False if there is no such model.</returns>
+    bool ReplaceIntent(const std::string& modelId, const PatternMatchingIntent& intent);
+
+    /// <summary>
+    /// Removes an intent from an applied pattern matching model.
+    /// </summary>
+    /// <param name="modelId">The id of the applied pattern matching model.</param>
+    /// <param name="intentId">The id of the intent.</param>
+    /// <returns>False if there is no such model or intent.</returns>
+    bool RemoveIntent(const std::string& modelId, const std::string& intentId);
+
 private:
 
     void AddIntent(std::shared_ptr<ISpxTrigger> trigger, const std::string& intentId);
+    ModelMatchingOptions GetModelMatchingOptions() const;
 
     enum class PhraseGetterHr
     {
@@ -140,11 +230,15 @@ private:
     };
 
     void AddPatternMatchingModel(const std::shared_ptr<LanguageUnderstandingModel>& luModel) const;
+    std::shared_ptr<CSpxPatternMatchingIntent> CreatePatternMatchingIntent(const CSpxPatternMatchingModel& model, const PatternMatchingIntent& intent) const;
 
     struct State
     {
         std::shared_ptr<CSpxIntentRecognizer> recognizer;
+        std::shared_ptr<CSpxThreadPool> threadPool;
         std::string language;
+        bool parallelModelMatching = false;
+        bool stopAtExactMatch = false;
     };
 
     State* m_state;
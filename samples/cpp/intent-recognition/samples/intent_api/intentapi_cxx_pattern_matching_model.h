@@ -6,7 +6,8 @@
 //
 #pragma once
 
-#include <iterator>
+#include <istream>
+#include <memory>
 
 #include <ajv.h>
 #include <intentapi_cxx_language_understanding_model.h>
@@ -18,6 +19,12 @@ namespace SpeechSDK {
 namespace Standalone {
 namespace Intent {
 
+namespace Impl {
+class CSpxCompiledModel;
+}
+
+class IntentRecognizer;
+
 /// <summary>
 /// Represents a pattern matching model used for intent recognition.
 /// </summary>
@@ -34,8 +41,13 @@ private:
         std::string modelId;
         std::vector<PatternMatchingIntent> intents;
         std::vector<PatternMatchingEntity> entities;
+
+        // Set for models loaded with FromCompiledFile, holds the phrases of their list entities.
+        std::shared_ptr<const Impl::CSpxCompiledModel> compiled;
     };
 
+    friend class IntentRecognizer;
+
     Storage* m_storage;
 
 public:
@@ -76,19 +88,23 @@ public:
 #endif
         if (err == 0 && fp != NULL)
         {
-            char buffer[1024] = {};
+            // The file is parsed as it is read, it is never in memory as a whole.
+            auto model = std::shared_ptr<PatternMatchingModel>(new PatternMatchingModel(""));
+            JsonFileHandler handler(*model);
+            ajv::JsonStreamReader reader(handler);
+
+            char buffer[4096] = {};
             size_t numread = 0;
-            std::string fileContents = "";
 #ifdef _MSC_VER
             while ((numread = fread_s((void**)&buffer, sizeof(buffer), sizeof(char), sizeof(buffer), fp)) != 0)
 #else
             while ((numread = fread((void**)&buffer, sizeof(char), sizeof(buffer), fp)) != 0)
 #endif
             {
-                fileContents.append(buffer, numread);
+                if (!reader.Feed(buffer, numread)) break;
             }
             fclose(fp);
-            return ParseJSONFile(fileContents);
+            return reader.End() && handler.IsRootObject() ? model : nullptr;
         }
         else
         {
@@ -105,11 +121,35 @@ public:
     /// <returns>A shared pointer to pattern matching model.</returns>
     static std::shared_ptr<PatternMatchingModel> FromJSONFileStream(std::istream& iStream)
     {
-        std::istreambuf_iterator<char> iterator{ iStream };
-        std::string str(iterator, {});
-        return ParseJSONFile(str);
+        auto model = std::shared_ptr<PatternMatchingModel>(new PatternMatchingModel(""));
+        JsonFileHandler handler(*model);
+        ajv::JsonStreamReader reader(handler);
+
+        char buffer[4096];
+        while (iStream.read(buffer, sizeof(buffer)) || iStream.gcount() > 0)
+        {
+            if (!reader.Feed(buffer, static_cast<size_t>(iStream.gcount()))) break;
+        }
+        return reader.End() && handler.IsRootObject() ? model : nullptr;
     }
 
+    /// <summary>
+    /// Creates a pattern matching model from a compiled model file written by SaveCompiledFile. The file is mapped
+    /// read-only, so loading takes about the same time however long the lists are, and processes loading the same
+    /// file share its memory. List entity phrases stay in the file: they are not copied into Entities, whose Phrases
+    /// only hold phrases added afterwards.
+    /// </summary>
+    /// <param name="filepath">A string that representing the path to a compiled model file.</param>
+    /// <returns>A shared pointer to pattern matching model, or nullptr if the file cannot be loaded.</returns>
+    static std::shared_ptr<PatternMatchingModel> FromCompiledFile(const std::string& filepath);
+
+    /// <summary>
+    /// Compiles this model into a file that FromCompiledFile can load, e.g. after FromJSONFile as an offline build
+    /// step. Throws std::runtime_error if the file cannot be written.
+    /// </summary>
+    /// <param name="filepath">A string that representing the path of the file to write.</param>
+    void SaveCompiledFile(const std::string& filepath) const;
+
     PatternMatchingModel(const PatternMatchingModel& other)
         : LanguageUnderstandingModel(other),
           m_storage(new Storage(*other.m_storage)),
@@ -161,216 +201,174 @@ private:
     {
     }
 
-    static std::shared_ptr<PatternMatchingModel> ParseJSONFile(const std::string& fileContents)
+    /// <summary>
+    /// Builds a model from a LUIS JSON export while it is parsed. Only strings are looked at, everything that is not
+    /// part of a pattern matching model is skipped.
+    /// </summary>
+    class JsonFileHandler : public ajv::JsonStreamReader::Handler
     {
-        auto model = std::shared_ptr<PatternMatchingModel>(new PatternMatchingModel(""));
+    public:
+
+        explicit JsonFileHandler(PatternMatchingModel& model) : m_model(model) {}
 
-        auto parser = ajv::json::Parse(fileContents);
-        auto reader = parser.Reader();
+        bool IsRootObject() const { return m_rootIsObject; }
 
-        if (!reader.IsObject())
+        void StartObject() override { Open(true); }
+        void StartArray() override { Open(false); }
+        void EndObject() override { Close(); }
+        void EndArray() override { Close(); }
+
+        void Name(const char* ptr, size_t size) override
         {
-            // Attempt to parse language understanding json file failed.
-            return nullptr;
+            auto name = ajv::JsonString::Encoder::DecodeView(ptr, &size, m_scratch);
+            m_containers.back().name.assign(name, size);
         }
 
-        for (auto name = reader.FirstName(); name.IsOk(); name++)
+        void Value(ajv::JsonKind kind, const char* ptr, size_t size) override
         {
-            auto nameStr = name.AsString();
-            auto item = reader[nameStr.c_str()];
-
-            if (nameStr == "luis_schema_version")
-            {
-                // We support any version that we are able to pull data out of.
-            }
-            else if (nameStr == "prebuiltEntities" && item.IsArray())
-            {
-                int prebuiltcount = item.ValueCount();
-                for (int j = 0; j < prebuiltcount; j++)
-                {
-                    auto obj = item[j];
-                    ParsePrebuiltEntityJson(obj, model);
-                }
-            }
-            else if (nameStr == "name" && item.IsString())
+            if (kind != ajv::JsonKind::String || m_containers.empty())
             {
-                model->m_storage->modelId = item.AsString();
+                return;
             }
-            else if ((nameStr == "patternAnyEntities" || nameStr == "entities") && item.IsArray())
+
+            auto& container = m_containers.back();
+            auto decoded = ajv::JsonString::Encoder::DecodeView(ptr, &size, m_scratch);
+            m_value.assign(decoded, size);
+            auto& value = m_value;
+
+            if (container.role == Role::Root && container.name == "name")
             {
-                int anyCount = item.ValueCount();
-                for (int j = 0; j < anyCount; j++)
-                {
-                    auto obj = item[j];
-                    ParseEntityJson(obj, model);
-                }
+                m_model.m_storage->modelId = value;
             }
-            else if (nameStr == "patterns" && item.IsArray())
+            else if (container.role == Role::Element && container.name == "name")
             {
-                int patternCount = item.ValueCount();
-                for (int j = 0; j < patternCount; j++)
+                if (m_section == Section::PrebuiltEntities && value == "number")
                 {
-                    auto obj = item[j];
-                    ParsePatternJson(obj, model);
+                    m_model.Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
                 }
-            }
-            else if (nameStr == "closedLists" && item.IsArray())
-            {
-                int listCount = item.ValueCount();
-                for (int j = 0; j < listCount; j++)
+                else if (m_section == Section::Entities && !value.empty())
                 {
-                    auto obj = item[j];
-                    ParseListEntityJson(obj, model);
+                    m_model.Entities.push_back({ value, EntityType::Any, EntityMatchMode::Basic, {} });
                 }
-            }
-        }
-        return model;
-    }
-
-    static void ParsePrebuiltEntityJson(ajv::JsonReader& reader, std::shared_ptr<PatternMatchingModel> model)
-    {
-        for (auto name = reader.FirstName(); name.IsOk(); name++)
-        {
-            auto nameStr = name.AsString();
-            auto item = reader[nameStr.c_str()];
-            if (nameStr == "name" && item.IsString())
-            {
-                auto valueStr = item.AsString();
-                if (valueStr == "number")
+                else if (m_section == Section::ClosedLists && !value.empty())
                 {
-                    model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
+                    m_entity.Id = value;
                 }
-                // ignore any other prebuilt types as they are not supported.
             }
-        }
-    }
-
-    static void ParseEntityJson(ajv::JsonReader& reader, std::shared_ptr<PatternMatchingModel> model)
-    {
-        for (auto name = reader.FirstName(); name.IsOk(); name++)
-        {
-            auto nameStr = name.AsString();
-            auto item = reader[nameStr.c_str()];
-            if (nameStr == "name" && item.IsString())
+            else if (container.role == Role::Element && m_section == Section::Patterns && !value.empty())
             {
-                auto valueStr = item.AsString();
-                if (!valueStr.empty())
+                if (container.name == "pattern")
                 {
-                    model->Entities.push_back({ valueStr, EntityType::Any, EntityMatchMode::Basic, {} });
+                    m_pattern = value;
                 }
-                // ignore any other pairs since we only care about the name.
-            }
-        }
-    }
-
-    static void ParseListEntityJson(ajv::JsonReader& reader, std::shared_ptr<PatternMatchingModel> model)
-    {
-        // Default to Strict matching.
-        PatternMatchingEntity entity{ "", EntityType::List, EntityMatchMode::Strict, {} };
-
-        for (auto name = reader.FirstName(); name.IsOk(); name++)
-        {
-            auto nameStr = name.AsString();
-            auto item = reader[nameStr.c_str()];
-
-            if (nameStr == "name" && item.IsString())
-            {
-                auto valueStr = item.AsString();
-                if (!valueStr.empty())
+                else if (container.name == "intent")
                 {
-                    entity.Id = valueStr;
+                    m_intentId = value;
                 }
             }
-            else if (nameStr == "subLists" && item.IsArray())
+            else if (((container.role == Role::SubList && container.name == "canonicalForm") || container.role == Role::SubListPhrases) && !value.empty())
             {
-                ParseSubList(item, entity);
+                m_entity.Phrases.push_back(value);
             }
         }
 
-        model->Entities.push_back(entity);
-    }
+    private:
 
-    static void ParseSubList(ajv::JsonReader& reader, PatternMatchingEntity& entity)
-    {
-        int subListCount = reader.ValueCount();
+        // What a container is in the model, by its parent and the name it has there.
+        enum class Role { Root, Section, Element, SubLists, SubList, SubListPhrases, Other };
+        enum class Section { PrebuiltEntities, Entities, Patterns, ClosedLists, Other };
 
-        for (int subListIndex = 0; subListIndex < subListCount; subListIndex++)
+        struct Container
         {
-            auto subList = reader[subListIndex];
+            Role role;
+            std::string name;
+        };
 
-            for (auto name = subList.FirstName(); name.IsOk(); name++)
+        void Open(bool isObject)
+        {
+            auto role = Role::Other;
+            if (m_containers.empty())
             {
-                auto nameStr = name.AsString();
-                auto item = subList[nameStr.c_str()];
-
-                if (nameStr == "canonicalForm" && item.IsString())
+                m_rootIsObject = isObject;
+                role = isObject ? Role::Root : Role::Other;
+            }
+            else
+            {
+                auto& parent = m_containers.back();
+                if (parent.role == Role::Root && !isObject)
                 {
-                    auto valueStr = item.AsString();
-                    if (!valueStr.empty())
-                    {
-                        entity.Phrases.push_back(valueStr);
-                    }
+                    m_section = parent.name == "prebuiltEntities" ? Section::PrebuiltEntities
+                        : parent.name == "patternAnyEntities" || parent.name == "entities" ? Section::Entities
+                        : parent.name == "patterns" ? Section::Patterns
+                        : parent.name == "closedLists" ? Section::ClosedLists
+                        : Section::Other;
+                    role = m_section != Section::Other ? Role::Section : Role::Other;
                 }
-                else if (nameStr == "list" && item.IsArray())
+                else if (parent.role == Role::Section && isObject)
                 {
-                    auto subListSynonymItemCount = item.ValueCount();
-                    for (int subListSynonymIndex = 0; subListSynonymIndex < subListSynonymItemCount; subListSynonymIndex++)
-                    {
-                        auto valueStr = item[subListSynonymIndex].AsString();
-                        if (!valueStr.empty())
-                        {
-                            entity.Phrases.push_back(valueStr);
-                        }
-                    }
+                    role = Role::Element;
+                    m_pattern.clear();
+                    m_intentId.clear();
+                    m_entity = { "", EntityType::List, EntityMatchMode::Strict, {} };
+                }
+                else if (parent.role == Role::Element && !isObject && m_section == Section::ClosedLists && parent.name == "subLists")
+                {
+                    role = Role::SubLists;
+                }
+                else if (parent.role == Role::SubLists && isObject)
+                {
+                    role = Role::SubList;
+                }
+                else if (parent.role == Role::SubList && !isObject && parent.name == "list")
+                {
+                    role = Role::SubListPhrases;
                 }
             }
+            m_containers.push_back({ role, std::string() });
         }
-    }
-
-    static void ParsePatternJson(ajv::JsonReader& reader, std::shared_ptr<PatternMatchingModel> model)
-    {
-        std::string patternStr, intentIdStr;
 
-        for (auto name = reader.FirstName(); name.IsOk(); name++)
+        void Close()
         {
-            auto nameStr = name.AsString();
-            auto item = reader[nameStr.c_str()];
-            if (item.IsString())
+            if (m_containers.back().role == Role::Element)
             {
-                auto valueStr = item.AsString();
-                if (!valueStr.empty())
+                if (m_section == Section::Patterns && !m_pattern.empty() && !m_intentId.empty())
+                {
+                    AddPattern(m_model, m_pattern, m_intentId);
+                }
+                else if (m_section == Section::ClosedLists)
                 {
-                    if (nameStr == "pattern")
-                    {
-                        patternStr = valueStr;
-                    }
-                    else if (nameStr == "intent")
-                    {
-                        intentIdStr = valueStr;
-                    }
+                    m_model.Entities.push_back(m_entity);
                 }
             }
+            m_containers.pop_back();
         }
 
-        if (!patternStr.empty() && !intentIdStr.empty())
-        {
-            bool added = false;
+        PatternMatchingModel& m_model;
+        std::vector<Container> m_containers;
+        bool m_rootIsObject = false;
 
-            for (auto& intent : model->Intents)
-            {
-                if (intent.Id == intentIdStr)
-                {
-                    intent.Phrases.push_back(patternStr);
-                    added = true;
-                    break;
-                }
-            }
+        // reused for every name and value, so reading them doesn't allocate once they have grown big enough
+        std::string m_scratch;
+        std::string m_value;
 
-            if (!added)
+        Section m_section = Section::Other;
+        std::string m_pattern;
+        std::string m_intentId;
+        PatternMatchingEntity m_entity;
+    };
+
+    static void AddPattern(PatternMatchingModel& model, const std::string& pattern, const std::string& intentId)
+    {
+        for (auto& intent : model.Intents)
+        {
+            if (intent.Id == intentId)
             {
-                model->Intents.push_back({ {patternStr}, intentIdStr });
+                intent.Phrases.push_back(pattern);
+                return;
             }
         }
+
+        model.Intents.push_back({ {pattern}, intentId });
     }
 
 };
@@ -0,0 +1,490 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctype.h>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "compiled_model.h"
+#include "intent_trigger.h"
+#include "list_entity.h"
+#include "locale_information.h"
+#include "mapped_file.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+constexpr uint32_t CSpxCompiledModel::FORMAT_VERSION;
+
+namespace {
+
+const char IMAGE_MAGIC[8] = { 'S', 'P', 'X', 'P', 'M', 'D', 'L', '\0' };
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct StringRef
+{
+    uint32_t Offset;
+    uint32_t Length;
+};
+
+struct ImageHeader
+{
+    char Magic[8];
+    uint32_t Version;
+    uint32_t ByteOrderMark;
+    uint32_t FileSize;
+    StringRef ModelId;
+    uint32_t OrthographyCount;
+    uint32_t OrthographiesOffset;
+    uint32_t IntentCount;
+    uint32_t IntentsOffset;
+    uint32_t EntityCount;
+    uint32_t EntitiesOffset;
+};
+
+struct IntentRecord
+{
+    StringRef Id;
+    uint32_t PhraseCount;
+    uint32_t PhrasesOffset;
+};
+
+struct EntityRecord
+{
+    StringRef Id;
+    uint32_t Type;
+    uint32_t Mode;
+    uint32_t PhraseCount;
+    uint32_t PhrasesOffset;
+    uint32_t IndexCount;
+    uint32_t IndexOffset;
+    uint32_t GreedOffset;
+};
+
+static_assert(sizeof(ImageHeader) == 52, "ImageHeader must not contain padding");
+static_assert(sizeof(IntentRecord) == 16, "IntentRecord must not contain padding");
+static_assert(sizeof(EntityRecord) == 36, "EntityRecord must not contain padding");
+
+[[noreturn]] void ThrowInvalidImage(const std::string& reason)
+{
+    SPX_TRACE_ERROR("CSpxCompiledModel: %s", reason.c_str());
+    throw std::runtime_error("CSpxCompiledModel: invalid model image, " + reason);
+}
+
+// Bounds checked reads from the mapped image. Records are copied out since the mapping gives no alignment guarantees
+// to the compiler.
+class ImageReader
+{
+public:
+    ImageReader(const char* data, size_t size) : m_data(data), m_size(size) {}
+
+    void CheckRange(uint64_t offset, uint64_t count, uint64_t elementSize) const
+    {
+        if (offset > m_size || count * elementSize > m_size - offset)
+        {
+            ThrowInvalidImage("a record is out of range");
+        }
+    }
+
+    template<typename T>
+    T Read(uint64_t offset) const
+    {
+        CheckRange(offset, 1, sizeof(T));
+        T value;
+        std::memcpy(&value, m_data + offset, sizeof(T));
+        return value;
+    }
+
+    std::string ReadString(const StringRef& ref) const
+    {
+        CheckRange(ref.Offset, ref.Length, 1);
+        return std::string(m_data + ref.Offset, ref.Length);
+    }
+
+    std::vector<std::string> ReadStrings(uint32_t offset, uint32_t count) const
+    {
+        CheckRange(offset, count, sizeof(StringRef));
+        std::vector<std::string> strings;
+        strings.reserve(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            strings.push_back(ReadString(Read<StringRef>(offset + uint64_t{ i } * sizeof(StringRef))));
+        }
+        return strings;
+    }
+
+private:
+    const char* m_data;
+    size_t m_size;
+};
+
+// Appends records and strings to an image kept in memory, keeping everything 4-byte aligned.
+class ImageBuilder
+{
+public:
+    uint32_t Reserve(size_t bytes)
+    {
+        auto offset = m_image.size();
+        auto aligned = (bytes + 3) & ~size_t{ 3 };
+        if (offset + aligned > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::runtime_error("CSpxCompiledModelWriter: the model is too large for the image format");
+        }
+        m_image.append(aligned, '\0');
+        return static_cast<uint32_t>(offset);
+    }
+
+    template<typename T>
+    void Put(uint32_t offset, const T& value)
+    {
+        std::memcpy(&m_image[offset], &value, sizeof(T));
+    }
+
+    StringRef AddString(const std::string& value)
+    {
+        auto offset = Reserve(value.length());
+        std::memcpy(&m_image[offset], value.data(), value.length());
+        return { offset, static_cast<uint32_t>(value.length()) };
+    }
+
+    uint32_t AddStrings(const std::vector<std::string>& values)
+    {
+        auto offset = Reserve(values.size() * sizeof(StringRef));
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            Put(static_cast<uint32_t>(offset + i * sizeof(StringRef)), AddString(values[i]));
+        }
+        return offset;
+    }
+
+    uint32_t AddNumbers(const std::vector<uint32_t>& values)
+    {
+        auto offset = Reserve(values.size() * sizeof(uint32_t));
+        if (!values.empty())
+        {
+            std::memcpy(&m_image[offset], values.data(), values.size() * sizeof(uint32_t));
+        }
+        return offset;
+    }
+
+    std::string& GetImage() { return m_image; }
+
+private:
+    std::string m_image;
+};
+
+}
+
+CSpxCompiledList::CSpxCompiledList(std::shared_ptr<const CSpxMappedFile> file, uint32_t phraseCount, uint32_t phrasesOffset,
+    uint32_t indexCount, uint32_t indexOffset, std::vector<std::pair<std::string, unsigned int>> greed) :
+    m_file(std::move(file)),
+    m_phraseCount(phraseCount),
+    m_phrasesOffset(phrasesOffset),
+    m_indexCount(indexCount),
+    m_indexOffset(indexOffset),
+    m_greed(std::move(greed))
+{
+}
+
+std::string CSpxCompiledList::GetPhrase(size_t index) const
+{
+    if (index >= m_phraseCount)
+    {
+        throw std::out_of_range("CSpxCompiledList: phrase index out of range");
+    }
+    ImageReader reader(m_file->GetData(), m_file->GetSize());
+    return reader.ReadString(reader.Read<StringRef>(m_phrasesOffset + uint64_t{ index } * sizeof(StringRef)));
+}
+
+uint32_t CSpxCompiledList::GetIndexEntry(uint32_t position) const
+{
+    ImageReader reader(m_file->GetData(), m_file->GetSize());
+    auto phraseIndex = reader.Read<uint32_t>(m_indexOffset + uint64_t{ position } * sizeof(uint32_t));
+    if (phraseIndex >= m_phraseCount)
+    {
+        ThrowInvalidImage("a list index entry is out of range");
+    }
+    return phraseIndex;
+}
+
+int CSpxCompiledList::CompareFolded(uint32_t phraseIndex, const std::string& folded, bool prefixOnly) const
+{
+    ImageReader reader(m_file->GetData(), m_file->GetSize());
+    auto ref = reader.Read<StringRef>(m_phrasesOffset + uint64_t{ phraseIndex } * sizeof(StringRef));
+    reader.CheckRange(ref.Offset, ref.Length, 1);
+    auto phrase = reinterpret_cast<const unsigned char*>(m_file->GetData() + ref.Offset);
+
+    // Same ordering as comparing CSpxListEntity::FoldCase(phrase) with folded, without building the folded phrase.
+    size_t i = 0;
+    for (; i < folded.length(); i++)
+    {
+        if (i == ref.Length || phrase[i] == '\0')
+        {
+            return -1;
+        }
+        auto phraseChar = static_cast<unsigned char>(::tolower(phrase[i]));
+        auto foldedChar = static_cast<unsigned char>(folded[i]);
+        if (phraseChar != foldedChar)
+        {
+            return phraseChar < foldedChar ? -1 : 1;
+        }
+    }
+    if (prefixOnly || i == ref.Length || phrase[i] == '\0')
+    {
+        return 0;
+    }
+    return 1;
+}
+
+uint32_t CSpxCompiledList::LowerBound(const std::string& folded) const
+{
+    uint32_t first = 0;
+    uint32_t count = m_indexCount;
+    while (count > 0)
+    {
+        auto step = count / 2;
+        if (CompareFolded(GetIndexEntry(first + step), folded, false) < 0)
+        {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+Maybe<std::string> CSpxCompiledList::Find(const std::string& folded) const
+{
+    auto position = LowerBound(folded);
+    if (position < m_indexCount)
+    {
+        auto phraseIndex = GetIndexEntry(position);
+        if (CompareFolded(phraseIndex, folded, false) == 0)
+        {
+            return GetPhrase(phraseIndex);
+        }
+    }
+    return Maybe<std::string>();
+}
+
+bool CSpxCompiledList::HasPrefix(const std::string& folded) const
+{
+    auto position = LowerBound(folded);
+    return position < m_indexCount && CompareFolded(GetIndexEntry(position), folded, true) == 0;
+}
+
+Maybe<unsigned int> CSpxCompiledList::GetGreed(const std::string& orthographyName) const
+{
+    for (auto& entry : m_greed)
+    {
+        if (entry.first == orthographyName)
+        {
+            return entry.second;
+        }
+    }
+    return Maybe<unsigned int>();
+}
+
+std::shared_ptr<const CSpxCompiledModel> CSpxCompiledModel::Load(const std::string& path)
+{
+    auto file = std::make_shared<const CSpxMappedFile>(path);
+    ImageReader reader(file->GetData(), file->GetSize());
+
+    auto header = reader.Read<ImageHeader>(0);
+    if (std::memcmp(header.Magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0)
+    {
+        ThrowInvalidImage("not a compiled model image");
+    }
+    if (header.ByteOrderMark != BYTE_ORDER_MARK)
+    {
+        ThrowInvalidImage("the image was written on a machine with a different byte order");
+    }
+    if (header.Version != FORMAT_VERSION)
+    {
+        ThrowInvalidImage("unsupported format version " + std::to_string(header.Version));
+    }
+    if (header.FileSize != file->GetSize())
+    {
+        ThrowInvalidImage("the file is truncated");
+    }
+
+    auto model = std::make_shared<CSpxCompiledModel>();
+    model->m_modelId = reader.ReadString(header.ModelId);
+    auto orthographies = reader.ReadStrings(header.OrthographiesOffset, header.OrthographyCount);
+
+    reader.CheckRange(header.IntentsOffset, header.IntentCount, sizeof(IntentRecord));
+    for (uint32_t i = 0; i < header.IntentCount; i++)
+    {
+        auto record = reader.Read<IntentRecord>(header.IntentsOffset + uint64_t{ i } * sizeof(IntentRecord));
+        model->m_intents.push_back({ reader.ReadString(record.Id), reader.ReadStrings(record.PhrasesOffset, record.PhraseCount) });
+    }
+
+    // List phrases are only range checked as a whole here, single phrases are checked when they are read.
+    reader.CheckRange(header.EntitiesOffset, header.EntityCount, sizeof(EntityRecord));
+    for (uint32_t i = 0; i < header.EntityCount; i++)
+    {
+        auto record = reader.Read<EntityRecord>(header.EntitiesOffset + uint64_t{ i } * sizeof(EntityRecord));
+        if (record.Type > static_cast<uint32_t>(Intent::EntityType::PrebuiltInteger) ||
+            record.Mode > static_cast<uint32_t>(Intent::EntityMatchMode::Fuzzy))
+        {
+            ThrowInvalidImage("unknown entity type or mode");
+        }
+
+        EntityDefinition entity{ reader.ReadString(record.Id), static_cast<Intent::EntityType>(record.Type), static_cast<Intent::EntityMatchMode>(record.Mode), nullptr };
+        if (entity.Type == Intent::EntityType::List)
+        {
+            reader.CheckRange(record.PhrasesOffset, record.PhraseCount, sizeof(StringRef));
+            reader.CheckRange(record.IndexOffset, record.IndexCount, sizeof(uint32_t));
+            reader.CheckRange(record.GreedOffset, header.OrthographyCount, sizeof(uint32_t));
+
+            std::vector<std::pair<std::string, unsigned int>> greed;
+            for (uint32_t j = 0; j < header.OrthographyCount; j++)
+            {
+                greed.emplace_back(orthographies[j], reader.Read<uint32_t>(record.GreedOffset + uint64_t{ j } * sizeof(uint32_t)));
+            }
+            entity.List = std::make_shared<const CSpxCompiledList>(file, record.PhraseCount, record.PhrasesOffset, record.IndexCount, record.IndexOffset, std::move(greed));
+        }
+        model->m_entities.push_back(std::move(entity));
+    }
+
+    return model;
+}
+
+std::shared_ptr<const CSpxCompiledList> CSpxCompiledModel::FindList(const std::string& entityId) const
+{
+    for (auto& entity : m_entities)
+    {
+        if (entity.List != nullptr && entity.Id == entityId)
+        {
+            return entity.List;
+        }
+    }
+    return nullptr;
+}
+
+void CSpxCompiledModelWriter::AddIntent(const std::string& intentId, const std::vector<std::string>& phrases)
+{
+    m_intents.push_back({ intentId, phrases });
+}
+
+void CSpxCompiledModelWriter::AddEntity(const std::string& entityId, Intent::EntityType type, Intent::EntityMatchMode mode, const std::vector<std::string>& phrases)
+{
+    Entity entity{ entityId, type, mode, {} };
+    if (type == Intent::EntityType::List)
+    {
+        // Store what CSpxListEntity::AddPhrase would keep.
+        for (auto& phrase : phrases)
+        {
+            auto normalized = CSpxIntentTrigger::NormalizeInput(phrase);
+            if (!normalized.empty())
+            {
+                entity.Phrases.push_back(std::move(normalized));
+            }
+        }
+    }
+    m_entities.push_back(std::move(entity));
+}
+
+void CSpxCompiledModelWriter::Write(const std::string& path) const
+{
+    auto orthographies = Locales::all_orthographies();
+    std::vector<std::string> orthographyNames;
+    for (auto orthography : orthographies)
+    {
+        orthographyNames.push_back(orthography->Name);
+    }
+
+    ImageBuilder builder;
+    auto headerOffset = builder.Reserve(sizeof(ImageHeader));
+    auto intentsOffset = builder.Reserve(m_intents.size() * sizeof(IntentRecord));
+    auto entitiesOffset = builder.Reserve(m_entities.size() * sizeof(EntityRecord));
+
+    ImageHeader header;
+    std::memcpy(header.Magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header.Version = CSpxCompiledModel::FORMAT_VERSION;
+    header.ByteOrderMark = BYTE_ORDER_MARK;
+    header.ModelId = builder.AddString(m_modelId);
+    header.OrthographyCount = static_cast<uint32_t>(orthographyNames.size());
+    header.OrthographiesOffset = builder.AddStrings(orthographyNames);
+    header.IntentCount = static_cast<uint32_t>(m_intents.size());
+    header.IntentsOffset = intentsOffset;
+    header.EntityCount = static_cast<uint32_t>(m_entities.size());
+    header.EntitiesOffset = entitiesOffset;
+
+    for (size_t i = 0; i < m_intents.size(); i++)
+    {
+        IntentRecord record;
+        record.Id = builder.AddString(m_intents[i].Id);
+        record.PhraseCount = static_cast<uint32_t>(m_intents[i].Phrases.size());
+        record.PhrasesOffset = builder.AddStrings(m_intents[i].Phrases);
+        builder.Put(static_cast<uint32_t>(intentsOffset + i * sizeof(IntentRecord)), record);
+    }
+
+    for (size_t i = 0; i < m_entities.size(); i++)
+    {
+        auto& entity = m_entities[i];
+
+        // Sort the phrases by their folding, keeping only the first phrase of each folding like CSpxListEntity does.
+        std::vector<std::string> folded;
+        folded.reserve(entity.Phrases.size());
+        for (auto& phrase : entity.Phrases)
+        {
+            folded.push_back(CSpxListEntity::FoldCase(phrase));
+        }
+        std::vector<uint32_t> index(entity.Phrases.size());
+        std::iota(index.begin(), index.end(), 0);
+        std::stable_sort(index.begin(), index.end(), [&folded](uint32_t a, uint32_t b) { return folded[a] < folded[b]; });
+        index.erase(std::unique(index.begin(), index.end(), [&folded](uint32_t a, uint32_t b) { return folded[a] == folded[b]; }), index.end());
+
+        std::vector<uint32_t> greed;
+        for (auto orthography : orthographies)
+        {
+            unsigned int orthographyGreed = 0;
+            for (auto& phrase : entity.Phrases)
+            {
+                orthographyGreed = std::max(orthographyGreed, CSpxListEntity::CalculateGreed(*orthography, phrase));
+            }
+            greed.push_back(orthographyGreed);
+        }
+
+        EntityRecord record;
+        record.Id = builder.AddString(entity.Id);
+        record.Type = static_cast<uint32_t>(entity.Type);
+        record.Mode = static_cast<uint32_t>(entity.Mode);
+        record.PhraseCount = static_cast<uint32_t>(entity.Phrases.size());
+        record.PhrasesOffset = builder.AddStrings(entity.Phrases);
+        record.IndexCount = static_cast<uint32_t>(index.size());
+        record.IndexOffset = builder.AddNumbers(index);
+        record.GreedOffset = builder.AddNumbers(greed);
+        builder.Put(static_cast<uint32_t>(entitiesOffset + i * sizeof(EntityRecord)), record);
+    }
+
+    auto& image = builder.GetImage();
+    header.FileSize = static_cast<uint32_t>(image.size());
+    builder.Put(headerOffset, header);
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(image.data(), image.size());
+    stream.close();
+    if (!stream)
+    {
+        SPX_TRACE_ERROR("CSpxCompiledModelWriter: cannot write %s", path.c_str());
+        throw std::runtime_error("CSpxCompiledModelWriter: cannot write " + path);
+    }
+}
+
+}}}}}
@@ -5,14 +5,17 @@
 
 #include "stdafx.h"
 
-#include <regex>
-#include <stack>
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
 #include <cstring>
+#include <deque>
+#include <map>
 #include <sstream>
 #include <stdlib.h>
 
 #include "en_integer_parser.h"
+#include "number_words.h"
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -189,153 +192,333 @@ const std::map<const char*, int64_t, cmp_str> OrdinalNumberMap
     //{ "trillionths", 1000000000000L }
 };
 
-const char* NegativeRegex = "(-|minus|negative).*";
-const char* NumberPatternRegex = R"(\b(\d+|\d+(rd|st|th|nd)|and| -|negative|minus|seventeen|eighteen|thousand|trillion|nineteen|thirteen|fourteen|sixteen|seventy|fifteen|hundred|billion|million|twenty|ninety|twelve|dozens|thirty|eighty|eleven|forty|seven|crore|sixty|eight|three|fifty|dozen|lakh|nine|zero|five|four|bln|two|mln|one|tln|ten|six|an|a|seventeenths|seventieths|nineteenths|thousandths|seventeenth|trillionths|thirteenths|fourteenths|eighteenths|eightieths|seventieth|sixteenths|trillionth|thousandth|fourteenth|fifteenths|thirtieths|twentieths|millionths|eighteenth|nineteenth|hundredths|ninetieths|billionths|thirteenth|elevenths|thirtieth|sixteenth|twentieth|fiftieths|eightieth|ninetieth|fortieths|fifteenth|secondary|billionth|millionth|hundredth|sixtieths|fortieth|sixtieth|twelfths|eleventh|fiftieth|sevenths|quarters|eighths|twelfth|seventh|quarter|fourths|nineths|tenths|fourth|thirds|sixths|halves|ninths|firsts|second|nineth|fifths|eighth|third|ninth|first|tenth|fifth|sixth|half|oh|for|too|to|fore)\b)";
+namespace {
 
-// Note: The number parsing from this section is based on the open source project and converted from the C# code there.
-// https://github.com/microsoft/Recognizers-Text
-Maybe<std::string> CSpxENIntegerParser::Parse(const std::string& input) const
+// The words the parser accepts as part of a number, they are matched regardless of case. Only the ones in the maps above
+// have a value, the others like "and" just join the parts of a number.
+const char* NumberWords[] =
 {
-    try
+    "and", "negative", "minus", "seventeen", "eighteen", "thousand", "trillion", "nineteen", "thirteen", "fourteen",
+    "sixteen", "seventy", "fifteen", "hundred", "billion", "million", "twenty", "ninety", "twelve", "dozens", "thirty",
+    "eighty", "eleven", "forty", "seven", "crore", "sixty", "eight", "three", "fifty", "dozen", "lakh", "nine", "zero",
+    "five", "four", "bln", "two", "mln", "one", "tln", "ten", "six", "an", "a", "seventeenths", "seventieths",
+    "nineteenths", "thousandths", "seventeenth", "trillionths", "thirteenths", "fourteenths", "eighteenths", "eightieths",
+    "seventieth", "sixteenths", "trillionth", "thousandth", "fourteenth", "fifteenths", "thirtieths", "twentieths",
+    "millionths", "eighteenth", "nineteenth", "hundredths", "ninetieths", "billionths", "thirteenth", "elevenths",
+    "thirtieth", "sixteenth", "twentieth", "fiftieths", "eightieth", "ninetieth", "fortieths", "fifteenth", "secondary",
+    "billionth", "millionth", "hundredth", "sixtieths", "fortieth", "sixtieth", "twelfths", "eleventh", "fiftieth",
+    "sevenths", "quarters", "eighths", "twelfth", "seventh", "quarter", "fourths", "nineths", "tenths", "fourth", "thirds",
+    "sixths", "halves", "ninths", "firsts", "second", "nineth", "fifths", "eighth", "third", "ninth", "first", "tenth",
+    "fifth", "sixth", "half", "oh", "for", "too", "to", "fore"
+};
+
+class NumberWordMatcher : public CSpxNumberWords<Maybe<int64_t>>
+{
+public:
+    NumberWordMatcher()
     {
-        std::regex numberPatternRegex(NumberPatternRegex, std::regex_constants::icase);
-        std::smatch sm;
-        std::string stringToProcess = input;
-        int64_t result = 0;
-        bool found = false;
+        for (auto word : NumberWords)
+        {
+            auto cardinal = CardinalNumberMap.find(word);
+            auto ordinal = OrdinalNumberMap.find(word);
+            if (cardinal != CardinalNumberMap.end())
+            {
+                Add(word, cardinal->second);
+            }
+            else if (ordinal != OrdinalNumberMap.end())
+            {
+                Add(word, ordinal->second);
+            }
+            else
+            {
+                Add(word, Maybe<int64_t>());
+            }
+        }
+        Freeze();
+    }
+};
 
-        // Remove locale number punctuation.
-        stringToProcess.erase(std::remove(stringToProcess.begin(), stringToProcess.end(), ','), stringToProcess.end());
+bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
 
-        auto matchBegin = std::sregex_iterator(stringToProcess.begin(), stringToProcess.end(), numberPatternRegex);
-        auto matchEnd = std::sregex_iterator();
-        std::vector<std::string> matches;
+// Numbers are whole words, words being made of these the same as \w.
+bool IsWordCharacter(char c)
+{
+    return IsDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
 
-        for (std::sregex_iterator iter = matchBegin; iter != matchEnd; ++iter)
+struct NumberToken
+{
+    size_t Start;
+    size_t Length;
+};
+
+/// <summary>
+/// Finds the numbers in a text: digits, digits with an ordinal suffix like "21st", the words of NumberWords and " -"
+/// between two words.
+/// </summary>
+class NumberScanner
+{
+public:
+    explicit NumberScanner(const std::string& text) : m_text{ text }, m_lowered{ text }
+    {
+        for (auto& c : m_lowered)
         {
-            auto match = *iter;
-
-            // If there is ever a prefix or suffix not containing a number, then there are words captured that are not numbers.
-            // In this case we should empty matches and break. This means we are returning no number.
-
-            //trim the strings of spaces and '-'s
-            auto prefix = match.prefix().str();
-            prefix.erase(0, prefix.find_first_not_of(' '));
-            prefix.erase(0, prefix.find_first_not_of('-'));
-            prefix.erase(prefix.find_last_not_of(' ') + 1);
-            prefix.erase(prefix.find_last_not_of('-') + 1);
-            auto suffix = match.suffix().str();
-            suffix.erase(0, suffix.find_first_not_of(' '));
-            suffix.erase(0, suffix.find_first_not_of('-'));
-            suffix.erase(suffix.find_last_not_of(' ') + 1);
-            suffix.erase(suffix.find_last_not_of('-') + 1);
-
-            if ((!prefix.empty() && !std::regex_search(prefix, sm, numberPatternRegex))
-                || (!suffix.empty() && !std::regex_search(suffix, sm, numberPatternRegex)))
+            if (c >= 'A' && c <= 'Z')
             {
-                matches.clear();
-                break;
+                c = static_cast<char>(c - 'A' + 'a');
             }
+        }
+    }
+
+    /// <summary>
+    /// Finds the first number at or after from in the range [begin, end). The words are those of the range, so a word
+    /// cut by the edge of the range ends there.
+    /// </summary>
+    bool Find(size_t begin, size_t end, size_t from, NumberToken& token) const
+    {
+        for (auto i = from; i < end; i++)
+        {
+            bool afterWord = i > begin && IsWordCharacter(m_text[i - 1]);
+            if (IsWordCharacter(m_text[i]))
+            {
+                if (afterWord)
+                {
+                    continue;
+                }
+
+                auto wordEnd = i + 1;
+                while (wordEnd < end && IsWordCharacter(m_text[wordEnd]))
+                {
+                    wordEnd++;
+                }
+                if (IsNumber(i, wordEnd - i))
+                {
+                    token = NumberToken{ i, wordEnd - i };
+                    return true;
+                }
+                i = wordEnd - 1;
+            }
+            else if (m_text[i] == ' ' && afterWord && i + 2 < end && m_text[i + 1] == '-' && IsWordCharacter(m_text[i + 2]))
+            {
+                token = NumberToken{ i, 2 };
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// <summary>
+    /// Returns true if the range [begin, end) is empty once spaces and '-'s are trimmed off, or if it has a number.
+    /// </summary>
+    bool IsEmptyOrHasNumber(size_t begin, size_t end) const
+    {
+        // Trim the same way as the text between numbers always was: spaces then '-'s.
+        auto trimStart = [&](char c) { while (begin < end && m_text[begin] == c) begin++; };
+        auto trimEnd = [&](char c) { while (end > begin && m_text[end - 1] == c) end--; };
+        trimStart(' ');
+        trimStart('-');
+        trimEnd(' ');
+        trimEnd('-');
+
+        NumberToken token;
+        return begin == end || Find(begin, end, begin, token);
+    }
 
-            // If we matched, we want the group not the whole string or the beginning word boundary group so we get match[1].
-            matches.push_back(match[1].str());
+    /// <summary>
+    /// Gets the value of a number. The maps and the ordinal suffixes are lower case, only numbers spelled that way
+    /// have a value.
+    /// </summary>
+    bool GetValue(const NumberToken& token, uint64_t& value) const
+    {
+        if (m_text.compare(token.Start, token.Length, m_lowered, token.Start, token.Length) != 0)
+        {
+            return false;
         }
 
-        if (matches.size() != 0)
+        if (IsDigit(m_text[token.Start]))
         {
-            bool isNegative = false;
-            // Check for negatives
-            std::regex negativeRegex(NegativeRegex);
-            std::cmatch cm;
-            if (std::regex_match(input.c_str(), cm, negativeRegex))
+            // errno can be set to any non-zero value by a library function call
+            // regardless of whether there was an error, so it needs to be cleared
+            // in order to check the error set by strtol
+            errno = 0;
+            char* endptr = NULL;
+            auto digits = m_text.c_str() + token.Start;
+            auto digitNum = strtol(digits, &endptr, 10);
+            if (endptr != digits && errno == 0)
             {
-                isNegative = true;
+                value = digitNum;
+                return true;
             }
+            return false;
+        }
 
-            auto nums = ConvertMatchesToNumVector(matches);
+        Maybe<int64_t> word;
+        if (Matcher().Lookup(m_lowered, token.Start, token.Length, &word) && word)
+        {
+            value = word.Get();
+            return true;
+        }
+        return false;
+    }
 
-            if (!nums.empty())
+    /// <summary>
+    /// Returns true if there is nothing in the text but numbers, spaces and '-'s.
+    /// </summary>
+    bool HasOnlyNumbers() const
+    {
+        for (size_t i = 0; i < m_text.length();)
+        {
+            if (IsWordCharacter(m_text[i]))
             {
-                auto strResult = ConvertVectorToNum(nums);
-                char* endptr = NULL;
-                // errno can be set to any non-zero value by a library function call
-                // regardless of whether there was an error, so it needs to be cleared
-                // in order to check the error set by strtol
-                errno = 0;
-                auto numResult = strtol(strResult.c_str(), &endptr, 10);
-                if (endptr != strResult.c_str() && errno == 0)
+                auto wordEnd = i + 1;
+                while (wordEnd < m_text.length() && IsWordCharacter(m_text[wordEnd]))
+                {
+                    wordEnd++;
+                }
+                if (!IsNumber(i, wordEnd - i))
                 {
-                    isNegative ?
-                        result -= numResult :
-                        result += numResult;
-                    found = true;
+                    return false;
                 }
+                i = wordEnd;
             }
+            else if (m_text[i] == ' ' || m_text[i] == '-')
+            {
+                i++;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static const NumberWordMatcher& Matcher()
+    {
+        static const NumberWordMatcher matcher;
+        return matcher;
+    }
+
+    bool IsNumber(size_t start, size_t length) const
+    {
+        size_t digits = 0;
+        while (digits < length && IsDigit(m_text[start + digits]))
+        {
+            digits++;
         }
 
-        return found ? Maybe<std::string>(std::to_string(result)) : Maybe<std::string>();;
+        if (digits == length)
+        {
+            return true;
+        }
+        if (digits > 0)
+        {
+            auto suffix = m_lowered.c_str() + start + digits;
+            return length - digits == 2 &&
+                (strncmp(suffix, "rd", 2) == 0 || strncmp(suffix, "st", 2) == 0 || strncmp(suffix, "th", 2) == 0 || strncmp(suffix, "nd", 2) == 0);
+        }
+        return Matcher().Lookup(m_lowered, start, length);
+    }
+
+    const std::string& m_text;
+    std::string m_lowered;
+};
+
+// The number is negative if the input starts with a minus and is all on one line.
+bool IsNegative(const char* input)
+{
+    size_t sign = 0;
+    if (strncmp(input, "-", 1) == 0)
+    {
+        sign = 1;
+    }
+    else if (strncmp(input, "minus", 5) == 0)
+    {
+        sign = 5;
     }
-    catch (const std::regex_error& ex)
+    else if (strncmp(input, "negative", 8) == 0)
     {
-        SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
-        UNUSED(ex);
-        return Maybe<std::string>();
+        sign = 8;
     }
+    return sign != 0 && strpbrk(input + sign, "\r\n") == nullptr;
 }
 
-std::vector<uint64_t> CSpxENIntegerParser::ConvertMatchesToNumVector(const std::vector<std::string>& matches) const
+}
+
+bool CSpxENIntegerParser::MayContainWord(const std::string& word) const
 {
-    std::vector<uint64_t> results;
+    // Whatever isn't a number is left between the numbers, and Parse fails if that isn't only spaces and '-'s.
+    std::string stripped = word;
+    stripped.erase(std::remove(stripped.begin(), stripped.end(), ','), stripped.end());
+    return NumberScanner{ stripped }.HasOnlyNumbers();
+}
 
-    for (auto& match : matches)
+// Note: The number parsing from this section is based on the open source project and converted from the C# code there.
+// https://github.com/microsoft/Recognizers-Text
+Maybe<std::string> CSpxENIntegerParser::Parse(const std::string& input) const
+{
+    std::string stringToProcess = input;
+    int64_t result = 0;
+    bool found = false;
+
+    // Remove locale number punctuation.
+    stringToProcess.erase(std::remove(stringToProcess.begin(), stringToProcess.end(), ','), stringToProcess.end());
+
+    NumberScanner scanner{ stringToProcess };
+    std::vector<NumberToken> matches;
+    NumberToken match;
+    for (size_t from = 0; scanner.Find(0, stringToProcess.length(), from, match); from = match.Start + match.Length)
     {
-        auto cardinal = CardinalNumberMap.find(match.c_str());
-        if (cardinal != CardinalNumberMap.end())
-        {
-            results.push_back(cardinal->second);
-            continue;
-        }
-        auto ordinal = OrdinalNumberMap.find(match.c_str());
-        if (ordinal != OrdinalNumberMap.end())
+        // If there is ever a prefix or suffix not containing a number, then there are words captured that are not numbers.
+        // In this case we should empty matches and break. This means we are returning no number.
+        if (!scanner.IsEmptyOrHasNumber(from, match.Start)
+            || !scanner.IsEmptyOrHasNumber(match.Start + match.Length, stringToProcess.length()))
         {
-            results.push_back(ordinal->second);
-            continue;
+            matches.clear();
+            break;
         }
 
-        auto pullOutDigitNum = [&](auto& regex, const auto& str)
+        matches.push_back(match);
+    }
+
+    if (matches.size() != 0)
+    {
+        bool isNegative = IsNegative(input.c_str());
+
+        std::vector<uint64_t> nums;
+        for (const auto& number : matches)
         {
-            std::cmatch cm;
-            if (std::regex_match(str.c_str(), cm, regex))
+            uint64_t value;
+            if (scanner.GetValue(number, value))
             {
-                // errno can be set to any non-zero value by a library function call
-                // regardless of whether there was an error, so it needs to be cleared
-                // in order to check the error set by strtol
-                errno = 0;
-                char* endptr = NULL;
-                auto digitNum = strtol(str.c_str(), &endptr, 10);
-                if (endptr != str.c_str() && errno == 0)
-                {
-                    results.push_back(digitNum);
-                }
+                nums.push_back(value);
             }
-        };
-
-        try
-        {
-            std::regex digitOrdinalRegex("\\d+(nd|st|rd|th)");
-            pullOutDigitNum(digitOrdinalRegex, match);
-
-            std::regex digitRegex("\\d+");
-            pullOutDigitNum(digitRegex, match);
         }
-        catch (const std::regex_error& ex)
+
+        if (!nums.empty())
         {
-            SPX_TRACE_ERROR("REGEX: Error: %s", ex.what());
-            UNUSED(ex);
+            auto strResult = ConvertVectorToNum(nums);
+            char* endptr = NULL;
+            // errno can be set to any non-zero value by a library function call
+            // regardless of whether there was an error, so it needs to be cleared
+            // in order to check the error set by strtol
+            errno = 0;
+            auto numResult = strtol(strResult.c_str(), &endptr, 10);
+            if (endptr != strResult.c_str() && errno == 0)
+            {
+                isNegative ?
+                    result -= numResult :
+                    result += numResult;
+                found = true;
+            }
         }
     }
 
-    return results;
+    return found ? Maybe<std::string>(std::to_string(result)) : Maybe<std::string>();
 }
 
 struct ValueStruct
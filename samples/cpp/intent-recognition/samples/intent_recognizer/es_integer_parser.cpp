@@ -6,14 +6,15 @@
 #include "stdafx.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <deque>
 #include <iostream>
-#include <map>
 #include <sstream>
-#include <regex>
+#include <stdlib.h>
 #include <vector>
 
 #include "es_integer_parser.h"
+#include "number_words.h"
 #include "string_utils.h"
 
 namespace Microsoft {
@@ -22,16 +23,8 @@ namespace Standalone {
 namespace Intent {
 namespace Impl {
 
-struct comparator
-{
-    bool operator()(const char* lhs, const char* rhs) const
-    {
-        return std::strcmp(lhs, rhs) < 0;
-    }
-};
-
 // Beginning of Parser section
-const static std::map<const char*, const Token, comparator> NUMBERS
+const static CSpxNumberWords<Token> NUMBERS
 {
     // 0b1 mask
     {"cero", Token(0 , 0x1)},
@@ -60,16 +53,16 @@ const static std::map<const char*, const Token, comparator> NUMBERS
     {"billon", Token(1'000'000'000'000, 0b1000000000000)}, {"billones", Token(1'000'000'000'000, 0b1000000000000)}
 };
 
-Maybe<Token> CSpxESIntegerParser::GetNumericValue(std::string& input)
+Maybe<Token> CSpxESIntegerParser::GetNumericValue(const std::string& input, size_t offset, size_t length)
 {
-    auto result = NUMBERS.find(input.c_str());
-    if (result == NUMBERS.end())
+    Token token;
+    if (NUMBERS.Lookup(input, offset, length, &token))
     {
-        return nullptr;
+        return token;
     }
     else
     {
-        return result->second;
+        return nullptr;
     }
 }
 
@@ -82,6 +75,12 @@ inline void NormalizeChar(std::string& input, const std::string& target, const s
     }
 }
 
+// Words are made of the same characters as \w, anything else is a space or punctuation.
+inline bool IsWordCharacter(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
 Maybe<std::vector<Token>> CSpxESIntegerParser::FromString(const std::string& input)
 {
     std::vector<Token> output;
@@ -94,55 +93,54 @@ Maybe<std::vector<Token>> CSpxESIntegerParser::FromString(const std::string& inp
     NormalizeChar(lowerCase, "ú", "u");
 
     // this filters out spaces and any punctuation that may appear
-    auto delimiters = "(\\w+)";
-    std::regex regex(delimiters);
+    for (size_t start = 0; start < lowerCase.length();)
+    {
+        if (!IsWordCharacter(lowerCase[start]))
+        {
+            start++;
+            continue;
+        }
 
-    // We scan from right to left
-    std::vector<std::string> vector{};
-    std::copy(
-        std::sregex_token_iterator(lowerCase.cbegin(), lowerCase.cend(), regex),
-        std::sregex_token_iterator(),
-        std::back_inserter(vector));
+        auto end = start + 1;
+        while (end < lowerCase.length() && IsWordCharacter(lowerCase[end]))
+        {
+            end++;
+        }
+        auto tokenStart = start;
+        auto token = lowerCase.c_str() + tokenStart;
+        auto length = end - start;
+        start = end;
 
-    for (auto& token : vector)
-    {
         // if the token is a connector type
-        if (token == "y")
+        if (length == 1 && token[0] == 'y')
         {
             output.push_back(Token{});
             continue;
         }
         // if the token is found in the map of hardocded entities
-        auto numericValue = GetNumericValue(token);
+        auto numericValue = GetNumericValue(lowerCase, tokenStart, length);
         if (numericValue)
         {
             output.push_back(numericValue.Get());
+            continue;
         }
-        else
+
+        // if the token can be casted to a number, the word ends where the digits do
+        errno = 0;
+        char* endptr = nullptr;
+        auto value = strtol(token, &endptr, 10);
+        if (endptr == token || errno != 0)
         {
-            // if the token can be casted to a number
-            try
-            {
-                uint64_t value = std::stol(token);
-                auto explicitToken = Token
-                {
-                    value,
-                    0b1111111111111111,
-                    Tag::Explicit
-                };
-                output.push_back(explicitToken);
-            }
-            catch (std::invalid_argument&)
-            {
-                SPX_TRACE_ERROR("Error parsing number in pattern matched", token.c_str());
-                return nullptr;
-            }
-            catch (std::out_of_range&)
-            {
-                SPX_TRACE_ERROR("Error parsing number in pattern matched", token.c_str());
-                return nullptr;
-            }
+            SPX_TRACE_ERROR("Error parsing number in pattern matched", std::string(token, length).c_str());
+            return nullptr;
         }
+        auto explicitToken = Token
+        {
+            static_cast<uint64_t>(value),
+            0b1111111111111111,
+            Tag::Explicit
+        };
+        output.push_back(explicitToken);
     }
 
     return output;
@@ -225,89 +223,11 @@ std::vector<std::vector<Token>> CSpxESIntegerParser::Segment(std::vector<Token>
 // End of segmentation section
 
 // Beginning of aggregation section
-inline uint64_t AggregateAcc(std::deque<uint64_t> numbers)
-{
-    auto accumulator = 0LL;
-    while (!numbers.empty())
-    {
-        auto value = numbers.front();
-        numbers.pop_front();
-        accumulator += value;
-    }
-
-    return accumulator;
-}
-
 constexpr bool CSpxESIntegerParser::IsMultiplier(const uint64_t& input)
 {
     return input % 1000 == 0;
 }
 
-Maybe<uint64_t> CSpxESIntegerParser::AsInteger(const std::vector<Token>& numbers)
-{
-    // if the number is only a connector we fail as we don't want to return `0`
-    if (numbers.size() == 1 && numbers.front().Type == Tag::Connector)
-    {
-        return nullptr;
-    }
-
-    std::deque<uint64_t> total;
-
-    uint64_t acc = 0LL;
-    bool wasLastIterationMultiplication = false;
-    for (auto& token : numbers)
-    {
-        if (token.Type == Tag::Connector)
-        {
-            continue;
-        }
-        uint64_t input = token.Value;
-
-        // we only start operating on an accumalator that has been initialised
-        if (acc > 0)
-        {
-            // multipliers are numbers divisible by 1000
-            auto isMulti = IsMultiplier(input);
-
-            // accumulator are groups of numbers of length at most xxx
-            // namely up to the hundreds digit
-            if (isMulti && acc < input)
-            {
-                wasLastIterationMultiplication = true;
-                acc *= input;
-            }
-            // if did not multiply the accumulator in the previous iteration
-            // it means that we are still working in an xxx number group
-            // that will be eventually multiplied (unless is the last one)
-            else if (!isMulti && acc > input && !wasLastIterationMultiplication)
-            {
-                wasLastIterationMultiplication = false;
-                acc += input;
-            }
-            // If we have reached a number where that is bigger than the latest
-            // accumulator, it means that we commit the result to the accumulator
-            // and we start the next group of xxx
-            else
-            {
-                wasLastIterationMultiplication = false;
-                total.push_front(acc);
-                acc = input;
-            }
-        }
-        // We initialise te accumulator
-        else
-        {
-            acc = input;
-        }
-    }
-
-    // we break off the for loop before we are able to commit the last bit
-    total.push_front(acc);
-
-    // we collapse the deque by adding all its elements
-    return AggregateAcc(total);
-}
-
 Maybe<std::string> CSpxESIntegerParser::Aggregate(const std::vector<std::vector<Token>>& numbers)
 {
     std::ostringstream output;
@@ -317,7 +237,7 @@ Maybe<std::string> CSpxESIntegerParser::Aggregate(const std::vector<std::vector<
     while (it != end)
     {
         const auto& number = *it;
-        auto result = AsInteger(number);
+        auto result = AggregateTokens(number, IsMultiplier);
         if (result)
         {
             output << result.Get();
@@ -334,7 +254,7 @@ Maybe<std::string> CSpxESIntegerParser::Aggregate(const std::vector<std::vector<
 Maybe<std::string> CSpxESIntegerParser::Aggregate(const std::vector<Token>& number)
 {
     std::ostringstream output;
-    auto result = AsInteger(number);
+    auto result = AggregateTokens(number, IsMultiplier);
     if (result) {
         output << result.Get();
     } else {
@@ -345,6 +265,20 @@ Maybe<std::string> CSpxESIntegerParser::Aggregate(const std::vector<Token>& numb
 // End of aggregation section
 
  // --- ISpxIntegerParser ---
+bool CSpxESIntegerParser::MayContainWord(const std::string& word) const
+{
+    // Only the first of each accented letter in the input is normalized, so a word with one may read differently in a
+    // longer input.
+    if (std::any_of(word.begin(), word.end(), [](char c) { return static_cast<unsigned char>(c) >= 0x80; }))
+    {
+        return true;
+    }
+
+    // Words are split at anything that isn't \w, spaces included, so any other word that doesn't read as numbers on
+    // its own doesn't in any input either.
+    return static_cast<bool>(FromString(word));
+}
+
 Maybe<std::string> CSpxESIntegerParser::Parse(const std::string& input) const
 {
     auto parsed = FromString(input);
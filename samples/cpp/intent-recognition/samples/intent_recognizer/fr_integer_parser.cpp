@@ -7,12 +7,12 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <bitset>
 #include <cmath>
 #include <limits>
-#include <stdexcept>
 
 #include "fr_integer_parser.h"
-#include "substrings_matcher.h"
+#include "number_words.h"
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -70,39 +70,30 @@ struct NumberInfo
     int32_t factor;
 };
 
-class SubstringToIntMatcher : public SubstringsMatcherBase<NumberInfo>
+class SubstringToIntMatcher : public CSpxNumberWords<NumberInfo>
 {
 public:
     SubstringToIntMatcher(const std::initializer_list<NumberInfo>& matches)
     {
         std::for_each(matches.begin(), matches.end(), [this](const NumberInfo& entry)
             {
-                SubstringsMatcherBase::UpdateSearchTree(
-                    m_root,
-                    entry.str,
-                    entry,
-                    [](bool isMatch, const std::string&, const NumberInfo& info) -> NumberInfo
-                    {
-                        return isMatch
-                            ? info
-                            : NumberInfo{ "", 0, NumberType::Ignore };
-                    },
-                    [](bool isMatch, const std::string& subStr, const NumberInfo& value, bool existingIsMatch, NumberInfo& existing) -> void
-                    {
-                        (void)subStr;
-
-                        if (existingIsMatch && isMatch)
-                        {
-                            // duplicate match detected. Probably a bug
-                            throw std::invalid_argument("Inconsistent value specified");
-                        }
-                        else if (!existingIsMatch && isMatch)
-                        {
-                            existing = value;
-                        }
-                    });
+                Add(entry.str, entry);
+                for (auto c : entry.str)
+                {
+                    m_bytes.set(static_cast<unsigned char>(c));
+                }
             });
+        Freeze();
     }
+
+    // Returns true if c is in one of the substrings.
+    bool IsInSubstrings(char c) const
+    {
+        return m_bytes.test(static_cast<unsigned char>(c));
+    }
+
+private:
+    std::bitset<256> m_bytes;
 };
 
 static const SubstringToIntMatcher MATCHER(
@@ -384,6 +375,16 @@ static size_t parse_numbers(const std::string& str, size_t offset, int64_t& valu
     return i;
 }
 
+bool CSpxFRIntegerParser::MayContainWord(const std::string& word) const
+{
+    // Parse reads every byte of its input as part of one of the substrings, or as a digit or '.' of a number. Some of
+    // the substrings span words, so this can't tell more than whether the bytes are right.
+    return std::all_of(word.begin(), word.end(), [](char c)
+        {
+            return (c >= '0' && c <= '9') || c == '.' || MATCHER.IsInSubstrings(c);
+        });
+}
+
 Maybe<std::string> CSpxFRIntegerParser::Parse(const std::string& str) const
 {
     std::string output;
@@ -410,20 +411,15 @@ Maybe<std::string> CSpxFRIntegerParser::Parse(const std::string& str) const
 
     for (size_t i = 0; i < str.length();)
     {
-        size_t index = MATCHER.Find(str, i, &info);
-        if (index == MATCHER.NO_MATCH)
+        size_t length = MATCHER.MatchLength(str, i, str.length() - i, &info);
+        if (length == 0)
         {
-            // we should find at least one of the number substrings. If we don't then the string contains
+            // one of the number substrings should start right here. If none does then the string contains
             // something that isn't recognized as a number value
             return Maybe<std::string>{};
         }
-        else if (index != i)
-        {
-            // if we jumped forward that means we skipped over some input that was not a valid number
-            return Maybe<std::string>{};
-        }
 
-        i += info.str.length();
+        i += length;
 
         switch (info.type)
         {
@@ -0,0 +1,166 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <intentapi_cxx_enums.h>
+
+#include "maybe.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+class CSpxMappedFile;
+
+/// <summary>
+/// The phrases of a list entity as stored in a compiled model image. Phrases are normalized and indexed by their case
+/// folding, lookups read the mapped image directly.
+/// </summary>
+class CSpxCompiledList
+{
+public:
+
+    CSpxCompiledList(std::shared_ptr<const CSpxMappedFile> file, uint32_t phraseCount, uint32_t phrasesOffset,
+        uint32_t indexCount, uint32_t indexOffset, std::vector<std::pair<std::string, unsigned int>> greed);
+
+    size_t GetPhraseCount() const { return m_phraseCount; }
+    std::string GetPhrase(size_t index) const;
+
+    /// <summary>
+    /// Finds the first phrase whose case folding (see CSpxListEntity::FoldCase) equals the folded input.
+    /// </summary>
+    Maybe<std::string> Find(const std::string& folded) const;
+
+    /// <summary>
+    /// Returns true if the case folding of any phrase starts with the folded prefix.
+    /// </summary>
+    bool HasPrefix(const std::string& folded) const;
+
+    /// <summary>
+    /// The number of words in the longest phrase, as counted with the given orthography when the image was compiled.
+    /// </summary>
+    Maybe<unsigned int> GetGreed(const std::string& orthographyName) const;
+
+private:
+
+    uint32_t GetIndexEntry(uint32_t position) const;
+    int CompareFolded(uint32_t phraseIndex, const std::string& folded, bool prefixOnly) const;
+    uint32_t LowerBound(const std::string& folded) const;
+
+    std::shared_ptr<const CSpxMappedFile> m_file;
+    uint32_t m_phraseCount;
+    uint32_t m_phrasesOffset;
+    uint32_t m_indexCount;
+    uint32_t m_indexOffset;
+    std::vector<std::pair<std::string, unsigned int>> m_greed;
+};
+
+/// <summary>
+/// A pattern matching model compiled into a binary image. Intents and entity definitions are small and are copied out
+/// on load, list entity phrases stay in the read-only mapping so that loading does not depend on the list sizes and
+/// processes using the same image share its pages.
+/// </summary>
+/// <remarks>
+/// All numbers are 32-bit in the byte order of the machine that wrote the image, the byte order mark lets the loader
+/// reject images from machines with a different one. Records are 4-byte aligned and offsets count from the start of
+/// the file.
+///
+///   Header        { Magic[8], Version, ByteOrderMark, FileSize, ModelId, OrthographyCount, OrthographiesOffset,
+///                   IntentCount, IntentsOffset, EntityCount, EntitiesOffset }
+///   StringRef     { Offset, Length }
+///   IntentRecord  { Id, PhraseCount, PhrasesOffset }
+///   EntityRecord  { Id, Type, Mode, PhraseCount, PhrasesOffset, IndexCount, IndexOffset, GreedOffset }
+///
+/// Ids and phrases are StringRefs. A list's index holds phrase numbers sorted by case folding, keeping only the first
+/// phrase of each folding. Its greed table has one entry per orthography in the header.
+/// </remarks>
+class CSpxCompiledModel
+{
+public:
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    struct IntentDefinition
+    {
+        std::string Id;
+        std::vector<std::string> Phrases;
+    };
+
+    struct EntityDefinition
+    {
+        std::string Id;
+        Intent::EntityType Type;
+        Intent::EntityMatchMode Mode;
+        std::shared_ptr<const CSpxCompiledList> List;
+    };
+
+    /// <summary>
+    /// Maps and validates an image. Throws std::runtime_error if the file cannot be read or is not a valid image of
+    /// this format version.
+    /// </summary>
+    static std::shared_ptr<const CSpxCompiledModel> Load(const std::string& path);
+
+    const std::string& GetModelId() const { return m_modelId; }
+    const std::vector<IntentDefinition>& GetIntents() const { return m_intents; }
+    const std::vector<EntityDefinition>& GetEntities() const { return m_entities; }
+
+    /// <summary>
+    /// Finds the compiled phrases of a list entity, or nullptr if the image has no list entity with this id.
+    /// </summary>
+    std::shared_ptr<const CSpxCompiledList> FindList(const std::string& entityId) const;
+
+private:
+
+    std::string m_modelId;
+    std::vector<IntentDefinition> m_intents;
+    std::vector<EntityDefinition> m_entities;
+};
+
+/// <summary>
+/// Builds a compiled model image. This is the offline step, it does the work CSpxListEntity::AddPhrase would
+/// otherwise do at startup.
+/// </summary>
+class CSpxCompiledModelWriter
+{
+public:
+
+    explicit CSpxCompiledModelWriter(const std::string& modelId) : m_modelId(modelId) {}
+
+    void AddIntent(const std::string& intentId, const std::vector<std::string>& phrases);
+
+    /// <summary>
+    /// Adds an entity. Phrases are only stored for list entities.
+    /// </summary>
+    void AddEntity(const std::string& entityId, Intent::EntityType type, Intent::EntityMatchMode mode, const std::vector<std::string>& phrases);
+
+    /// <summary>
+    /// Writes the image. Throws std::runtime_error if the file cannot be written.
+    /// </summary>
+    void Write(const std::string& path) const;
+
+private:
+
+    struct Entity
+    {
+        std::string Id;
+        Intent::EntityType Type;
+        Intent::EntityMatchMode Mode;
+        std::vector<std::string> Phrases;
+    };
+
+    std::string m_modelId;
+    std::vector<CSpxCompiledModel::IntentDefinition> m_intents;
+    std::vector<Entity> m_entities;
+};
+
+}}}}}
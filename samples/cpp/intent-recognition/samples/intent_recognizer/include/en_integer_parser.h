@@ -20,10 +20,10 @@ public:
 
     // --- ISpxIntegerParser ---
     Maybe<std::string> Parse(const std::string& input) const override;
+    bool MayContainWord(const std::string& word) const override;
 
 private:
 
-    std::vector<uint64_t> ConvertMatchesToNumVector(const std::vector<std::string>& matched) const;
     std::string ConvertVectorToNum(const std::vector<uint64_t>& nums) const;
 };
 
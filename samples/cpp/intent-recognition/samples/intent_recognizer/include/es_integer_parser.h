@@ -5,6 +5,7 @@
 
 #pragma once
 #include <string>
+#include <vector>
 
 #include "intent_interfaces.h"
 
@@ -58,18 +59,84 @@ struct Token
     }
 };
 
+/// <summary>
+/// Adds up the tokens of one number. Tokens are added up in groups, a multiplier multiplies the group before it e.g.
+/// "dos mil", and a token that doesn't fit the group starts the next one. What a multiplier is depends on the language.
+/// </summary>
+template<typename TIsMultiplier>
+Maybe<uint64_t> AggregateTokens(const std::vector<Token>& numbers, TIsMultiplier isMultiplier)
+{
+    // if the number is only a connector we fail as we don't want to return `0`
+    if (numbers.size() == 1 && numbers.front().Type == Tag::Connector)
+    {
+        return nullptr;
+    }
+
+    uint64_t total = 0;
+    uint64_t acc = 0;
+    bool wasLastIterationMultiplication = false;
+    for (auto& token : numbers)
+    {
+        if (token.Type == Tag::Connector)
+        {
+            continue;
+        }
+        uint64_t input = token.Value;
+
+        // we only start operating on an accumalator that has been initialised
+        if (acc > 0)
+        {
+            auto isMulti = isMultiplier(input);
+
+            // accumulator are groups of numbers of length at most xxx
+            // namely up to the hundreds digit
+            if (isMulti && acc < input)
+            {
+                wasLastIterationMultiplication = true;
+                acc *= input;
+            }
+            // if did not multiply the accumulator in the previous iteration
+            // it means that we are still working in an xxx number group
+            // that will be eventually multiplied (unless is the last one)
+            else if (!isMulti && acc > input && !wasLastIterationMultiplication)
+            {
+                wasLastIterationMultiplication = false;
+                acc += input;
+            }
+            // If we have reached a number where that is bigger than the latest
+            // accumulator, it means that we commit the result to the total
+            // and we start the next group of xxx
+            else
+            {
+                wasLastIterationMultiplication = false;
+                total += acc;
+                acc = input;
+            }
+        }
+        // We initialise te accumulator
+        else
+        {
+            acc = input;
+        }
+    }
+
+    // we break off the for loop before we are able to commit the last bit
+    return total + acc;
+}
+
 class CSpxESIntegerParser : public ISpxIntegerParser
 {
 public:
 
     // --- ISpxIntegerParser ---
     Maybe<std::string> Parse(const std::string& input) const override;
+    bool MayContainWord(const std::string& word) const override;
 
 private:
     // Parser layer
     // Methods that take the input string and tokenized it into processable entities
     static Maybe<std::vector<Token>> FromString(const std::string& input);
-    static Maybe<Token> GetNumericValue(std::string& input);
+    static Maybe<Token> GetNumericValue(const std::string& input, size_t offset, size_t length);
 
     // Segmentation layer
     // Once an input is parsed, we proceed to check if a group of tokens represent a single number
@@ -79,7 +146,6 @@ private:
     // After segmentation determines, how many numbers we have, we aggregate the tokens to generate the final result
     static Maybe<std::string> Aggregate(const std::vector<std::vector<Token>>& numbers);
     static Maybe<std::string> Aggregate(const std::vector<Token>& number);
-    static Maybe<uint64_t> AsInteger(const std::vector<Token>& input);
     constexpr static bool IsMultiplier(const uint64_t& input);
 };
 
@@ -21,6 +21,7 @@ public:
 
     // --- ISpxIntegerParser ---
     Maybe<std::string> Parse(const std::string& input) const override;
+    bool MayContainWord(const std::string& word) const override;
 };
 
 }}}}}
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "maybe.h"
+#include "utf8_utils.h"
 
 #include <intentapi_cxx_enums.h>
 
@@ -28,6 +29,12 @@ struct OrthographyInformation
     std::string SentenceEndCharacters;
     std::array<char, 4> WordBoundary;
     bool RightToLeft;
+
+    // The characters of the strings above as sets, for checking a character without searching the strings.
+    Utils::CharacterSet WhitespaceSet{ Whitespace };
+    Utils::CharacterSet InputPunctuationSet{ InputPunctuation };
+    Utils::CharacterSet PatternPunctuationSet{ PatternPunctuation };
+    Utils::CharacterSet SentenceEndSet{ SentenceEndCharacters };
 };
 
 class ISpxEntity // -> CSpxIntegerEntity, CSpxListEntity, CSpxPatternAnyEntity
@@ -43,6 +50,14 @@ public:
 
     virtual Maybe<std::string> Parse(const std::string & input) const = 0;
 
+    // Returns false only if Parse cannot succeed for any input that starts with prefix. Lets the pattern matcher stop
+    // adding words to an entity early.
+    virtual bool MayStartWith(const std::string & prefix) const = 0;
+
+    // Returns false only if Parse cannot succeed for any input that has word in it, with a space or an end of the input
+    // on each side of it. Lets the pattern matcher rule out spans of the utterance without parsing them.
+    virtual bool MayContainWord(const std::string & word) const = 0;
+
     virtual void Init(const std::string& name, const OrthographyInformation& orthography) = 0;
     virtual void SetMode(Intent::EntityMatchMode mode) = 0;
     virtual void AddPhrase(const std::string& phrase) = 0;
@@ -52,6 +67,9 @@ class ISpxIntegerParser // -> CSpxENIntegerParser, CSpxESIntegerParser, CSpxFRIn
 {
 public:
     virtual Maybe<std::string> Parse(const std::string & input) const = 0;
+
+    // The same as ISpxEntity::MayContainWord.
+    virtual bool MayContainWord(const std::string & word) const = 0;
 };
 
 struct EntityResult
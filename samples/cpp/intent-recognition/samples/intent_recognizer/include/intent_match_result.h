@@ -17,9 +17,13 @@ namespace Impl {
 
 class CSpxIntentMatchResult;
 
+/// <summary>
+/// Ranks matches, returns true if one ranks above two. Matches that rank neither above nor below each other are
+/// equivalent, recognition only keeps the first of those.
+/// </summary>
 struct SpxIntentMatchResultCompare
 {
-    bool operator()(std::shared_ptr<CSpxIntentMatchResult> one, std::shared_ptr<CSpxIntentMatchResult> two) const;
+    bool operator()(const std::shared_ptr<CSpxIntentMatchResult>& one, const std::shared_ptr<CSpxIntentMatchResult>& two) const;
     static int64_t CountEntityType(const std::map<std::string, EntityResult>& entities, Intent::EntityType type);
 };
 
@@ -61,10 +65,23 @@ public:
         return m_bytesMatched;
     }
 
+    /// <summary>
+    /// The number of entities of the type, counted once when the match is made since ranking needs them for every
+    /// comparison. Only PrebuiltInteger and List entities are counted, ranking doesn't look at other types.
+    /// </summary>
+    int64_t GetEntityCount(Intent::EntityType type) const
+    {
+        return type == Intent::EntityType::PrebuiltInteger ? m_integerEntityCount
+            : type == Intent::EntityType::List ? m_listEntityCount
+            : SpxIntentMatchResultCompare::CountEntityType(m_entities, type);
+    }
+
 private:
 
     unsigned int m_priority = UINT32_MAX;
     unsigned int m_bytesMatched = 0;
+    int64_t m_integerEntityCount = 0;
+    int64_t m_listEntityCount = 0;
     std::string m_intentId;
     std::map<std::string, EntityResult> m_entities{};
     std::string m_pattern;
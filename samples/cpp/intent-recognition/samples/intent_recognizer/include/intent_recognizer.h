@@ -6,13 +6,14 @@
 #pragma once
 
 #include <mutex>
-#include <set>
+#include <vector>
 
 #include <ajv.h>
 
 #include "intent_match_result.h"
 #include "intent_trigger.h"
 #include "pattern_matching_model.h"
+#include "thread_pool.h"
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -23,6 +24,45 @@ using namespace Microsoft::SpeechSDK::Standalone::Intent::Impl;
 
 namespace Impl {
 
+/// <summary>
+/// The outcome of recognizing one text. No JSON is built while recognizing, RenderDetailedJsonResult does that on
+/// demand.
+/// </summary>
+struct IntentRecognitionOutput
+{
+    /// <summary>
+    /// The id of the best match. Empty if no intent matched.
+    /// </summary>
+    std::string IntentId;
+
+    /// <summary>
+    /// All matches, best first.
+    /// </summary>
+    std::vector<std::shared_ptr<CSpxIntentMatchResult>> Matches;
+};
+
+/// <summary>
+/// How a recognition goes through the models. The defaults match the text against one model after the other on the
+/// calling thread.
+/// </summary>
+struct ModelMatchingOptions
+{
+    /// <summary>
+    /// The pool to match the models on concurrently. The calling thread matches models too and never waits for work
+    /// that is still queued, so it may be a worker of the same pool. The matches are merged in the same order either
+    /// way, so the output is the same as without a pool.
+    /// </summary>
+    CSpxThreadPool* ThreadPool = nullptr;
+
+    /// <summary>
+    /// Stops at the first model, in model id order with the default model last, that has an exact match of the top
+    /// priority. Only another such match that matched more bytes could rank above it, so the output is that of the
+    /// models up to and including this one: exact matches of later models are not considered and Matches leaves out
+    /// the matches of later models.
+    /// </summary>
+    bool StopAtExactMatch = false;
+};
+
 class CSpxIntentRecognizer
 {
 public:
@@ -33,30 +73,43 @@ public:
     void AddIntentTrigger(const std::string& id, const ISpxTrigger::Ptr& trigger, const std::string& modelId);
     void ClearLanguageModels();
 
-    void ProcessText(const std::string& text, std::string& intentId, std::string& jsonResult, std::string& detailedJsonResult);
+    /// <summary>
+    /// Returns the pattern matching model added with the model id, or nullptr if there is none.
+    /// </summary>
+    std::shared_ptr<CSpxPatternMatchingModel> FindPatternMatchingModel(const std::string& modelId) const;
+
+    /// <summary>
+    /// Recognizes the intent in the text. This does not change the recognizer, any number of threads may call it at once.
+    /// </summary>
+    IntentRecognitionOutput ProcessText(const std::string& text, const ModelMatchingOptions& options = {}) const;
+
+    /// <summary>
+    /// Same as above, but fills the output passed in so callers recognizing many texts can reuse its buffers.
+    /// </summary>
+    void ProcessText(const std::string& text, IntentRecognitionOutput& output, const ModelMatchingOptions& options = {}) const;
+
+    /// <summary>
+    /// Builds the JSON array describing every match, best first.
+    /// </summary>
+    /// <param name="matches">The matches of an IntentRecognitionOutput, best first.</param>
+    static std::string RenderDetailedJsonResult(const std::vector<std::shared_ptr<CSpxIntentMatchResult>>& matches);
 
     void Init();
     void Term();
 
 private:
 
-    std::string PrepareSimplePatternResults(std::set<std::shared_ptr<CSpxIntentMatchResult>, SpxIntentMatchResultCompare>& results, const std::string& inputText);
-
-    std::string IntentIdFromPatternMatchingModels(const std::string& inputText);
-    void AddToPatternMatchingJson(ajv::JsonBuilder::JsonWriter writer, std::shared_ptr<CSpxIntentMatchResult> matchResult) const;
+    void MatchPatternMatchingModels(const std::string& inputText, const ModelMatchingOptions& options, std::vector<std::shared_ptr<CSpxIntentMatchResult>>& matches) const;
+    static bool HasExactTopMatch(const std::vector<std::shared_ptr<CSpxIntentMatchResult>>& results);
+    static void AddToPatternMatchingJson(ajv::JsonStreamWriter& writer, const std::shared_ptr<CSpxIntentMatchResult>& matchResult);
     std::shared_ptr<CSpxPatternMatchingModel> GetOrCreateModel(const std::string& key);
 
-    void InitIntentResult(const char* intentId = "", const char* jsonResult = "", const char* detailedJsonResult = "");
-
     std::string m_lang;
-    std::mutex m_mutex;
+    // Guards the model map, recognizing text does not need it otherwise.
+    mutable std::mutex m_mutex;
     std::map<std::string, std::list<std::shared_ptr<ISpxTrigger>>> m_triggerMap;
     std::map<const std::string, std::shared_ptr<CSpxPatternMatchingModel>> m_patternMatchingModelMap;
     std::shared_ptr<CSpxPatternMatchingModel> m_defaultPatternMatchingModel;
-
-    std::string m_intentId;
-    std::string m_jsonResult;
-    std::string m_detailedJsonResult;
 };
 
 }}}}}
@@ -20,12 +20,12 @@ public:
 
     // --- ISpxIntegerParser ---
     Maybe<std::string> Parse(const std::string& input) const override;
+    bool MayContainWord(const std::string& word) const override;
 
 private:
 
     // parsing
     static Maybe<std::vector<Token>> FromString(const std::string& input);
-    static Maybe<Token> GetNumericValue(std::string& input);
 
     // segmentation
     static std::vector<std::vector<Token>> Segment(std::vector<Token> input);
@@ -33,7 +33,6 @@ private:
 
     // aggregator
     static Maybe<std::string> Aggregate(std::vector<std::vector<Token>> numbers);
-    static Maybe<uint64_t> AsInteger(std::vector<Token> input);
 
 };
 
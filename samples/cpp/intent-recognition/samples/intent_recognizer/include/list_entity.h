@@ -4,8 +4,13 @@
 //
 
 #pragma once
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
+#include "compiled_model.h"
 #include "intent_interfaces.h"
 #include "locale_information.h"
 
@@ -30,14 +35,64 @@ public:
     unsigned int GetGreed() const override { return m_greed; }
     bool IsRequired() const override { return (m_matchMode == Intent::EntityMatchMode::Strict); }
     Maybe<std::string> Parse(const std::string& input) const override;
+    bool MayStartWith(const std::string& prefix) const override;
+    bool MayContainWord(const std::string&) const override { return true; }
+
+    /// <summary>
+    /// Serves the phrases of a compiled list from its model image. Phrases added with AddPhrase come after them.
+    /// </summary>
+    void AttachCompiledList(std::shared_ptr<const CSpxCompiledList> list);
+
+    /// <summary>
+    /// Phrases normalized ahead of AddPreparedPhrases, with the greed of the longest one.
+    /// </summary>
+    struct PreparedPhrases
+    {
+        std::vector<std::string> Normalized;
+        unsigned int Greed = 0;
+    };
+
+    /// <summary>
+    /// Normalizes phrases [begin, end) and counts their words without changing the entity. Loading a large list can
+    /// prepare several ranges at the same time and add them in order, leaving the entity as if AddPhrase was used.
+    /// </summary>
+    PreparedPhrases PreparePhrases(const std::vector<std::string>& phrases, size_t begin, size_t end) const;
+    void AddPreparedPhrases(PreparedPhrases&& prepared);
+
+    /// <summary>
+    /// Returns a copy of the entity with the phrases removed, then the phrases added. The copy shares the bulk of
+    /// the phrases with this entity, which is left as it was, so the cost follows the number of changed phrases.
+    /// </summary>
+    std::shared_ptr<CSpxListEntity> Update(const std::vector<std::string>& removed, const std::vector<std::string>& added) const;
 
-private:
     static unsigned int CalculateGreed(const OrthographyInformation& orthography, const std::string& phrase);
+    static std::string FoldCase(const std::string& value);
+
+private:
+
+    // Case folded phrase -> the first phrase with that folding. Being ordered, the same map answers both exact
+    // lookups and "does any phrase start with this" queries in O(log n).
+    using PhraseMap = std::map<std::string, std::string>;
+
+    void InsertNormalizedPhrase(std::string&& normalized);
+    void RemovePhrase(const std::string& phrase);
+    void Freeze();
+
+    bool IsRemoved(const std::string& folded) const { return !m_removedPhrases.empty() && m_removedPhrases.count(folded) > 0; }
 
     unsigned int m_greed;
+    unsigned int m_compiledGreed = 0;
     std::string m_name;
     Intent::EntityMatchMode m_matchMode;
-    std::vector<std::string> m_phrases;
+
+    // Phrases are added to m_phrases. Update() moves them into m_frozenPhrases once there are enough of them, which
+    // copies of the entity share instead of copying. m_removedPhrases hides phrases of m_frozenPhrases and of the
+    // compiled list that were removed since.
+    PhraseMap m_phrases;
+    std::shared_ptr<const PhraseMap> m_frozenPhrases;
+    std::set<std::string> m_removedPhrases;
+
+    std::shared_ptr<const CSpxCompiledList> m_compiledList;
     const OrthographyInformation* m_orthography;
 };
 
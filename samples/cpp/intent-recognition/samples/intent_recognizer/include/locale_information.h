@@ -5,6 +5,7 @@
 
 #pragma once
 #include <string>
+#include <vector>
 
 #include "intent_interfaces.h"
 
@@ -27,6 +28,11 @@ namespace Locales {
     /// <returns>The orthography information for that language, or a nullptr if there isn't one specified</returns>
     const OrthographyInformation* find_orthography(const std::string& language);
 
+    /// <summary>
+    /// Gets all known orthographies, the default one first
+    /// </summary>
+    std::vector<const OrthographyInformation*> all_orthographies();
+
     namespace Utils
     {
         // French is special because they use non-breaking spaces before and after punctuation.
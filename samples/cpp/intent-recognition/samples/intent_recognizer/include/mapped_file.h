@@ -0,0 +1,45 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+/// <summary>
+/// A file mapped read-only into memory. Pages are loaded on first access and shared by all processes mapping the same
+/// file.
+/// </summary>
+class CSpxMappedFile
+{
+public:
+
+    /// <summary>
+    /// Maps the whole file. Throws std::runtime_error if the file cannot be opened or mapped.
+    /// </summary>
+    explicit CSpxMappedFile(const std::string& path);
+    ~CSpxMappedFile();
+
+    CSpxMappedFile(const CSpxMappedFile&) = delete;
+    CSpxMappedFile& operator=(const CSpxMappedFile&) = delete;
+
+    const char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _MSC_VER
+    void* m_mapping = nullptr;
+#endif
+};
+
+}}}}}
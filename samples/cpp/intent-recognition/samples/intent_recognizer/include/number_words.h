@@ -0,0 +1,93 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include "substrings_matcher.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+    /// <summary>
+    /// The number words of a language and the value each of them stands for. The integer parsers of all languages look
+    /// their words up through this: the table is frozen into a trie once, when it is created, and lookups don't allocate.
+    /// If a word is in the table more than once the first value is kept.
+    /// </summary>
+    template<typename TValue>
+    class CSpxNumberWords : public SubstringsMatcherBase<TValue>
+    {
+    public:
+        /// <summary>
+        /// Creates the table from pairs of a word and its value
+        /// </summary>
+        CSpxNumberWords(std::initializer_list<std::pair<const char*, TValue>> words)
+        {
+            for (const auto& word : words)
+            {
+                Add(word.first, word.second);
+            }
+            this->Freeze();
+        }
+
+        /// <summary>
+        /// Creates the table from a container of pairs of a word and its value, std::map for example
+        /// </summary>
+        template<typename TWords>
+        explicit CSpxNumberWords(const TWords& words)
+        {
+            for (const auto& word : words)
+            {
+                Add(word.first, word.second);
+            }
+            this->Freeze();
+        }
+
+        /// <summary>
+        /// Looks up the word that covers exactly the specified range of the input
+        /// </summary>
+        /// <param name="input">The input to look in</param>
+        /// <param name="offset">The offset the word starts at</param>
+        /// <param name="length">The length of the word</param>
+        /// <param name="value">(Optional) The value of the word</param>
+        /// <returns>True if it is one of the words</returns>
+        bool Lookup(const std::string& input, size_t offset, size_t length, TValue* value = nullptr) const
+        {
+            return length != 0 && this->MatchLength(input, offset, length, value) == length;
+        }
+
+    protected:
+        /// <summary>
+        /// For tables that need to add their words one by one. Call Freeze once they are all added.
+        /// </summary>
+        CSpxNumberWords() = default;
+
+        void Add(const std::string& word, const TValue& value)
+        {
+            SubstringsMatcherBase<TValue>::UpdateSearchTree(
+                this->m_root,
+                word,
+                value,
+                [](bool isMatch, const std::string&, const TValue& value)
+                {
+                    return isMatch ? value : TValue{};
+                },
+                [](bool isMatch, const std::string&, const TValue& value, bool existingIsMatch, TValue& existing)
+                {
+                    if (!existingIsMatch && isMatch)
+                    {
+                        existing = value;
+                    }
+                });
+        }
+    };
+
+}}}}}
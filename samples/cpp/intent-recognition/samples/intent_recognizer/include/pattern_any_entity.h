@@ -29,6 +29,8 @@ public:
     unsigned int GetGreed() const override { return m_greed; }
     bool IsRequired() const override { return true; }
     Maybe<std::string> Parse(const std::string& input) const override;
+    bool MayStartWith(const std::string&) const override { return true; }
+    bool MayContainWord(const std::string&) const override { return true; }
 
 private:
     std::string m_name;
@@ -0,0 +1,140 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "intent_interfaces.h"
+#include "pattern_matching_intent.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+/// <summary>
+/// The kind of pattern element that ends the literal prefix of a pattern in the automaton.
+/// </summary>
+enum class PatternTransition
+{
+    /// <summary>
+    /// The pattern has nothing left but punctuation and whitespace.
+    /// </summary>
+    End,
+    /// <summary>
+    /// The pattern continues with an entity, e.g. "{appName}".
+    /// </summary>
+    Entity,
+    /// <summary>
+    /// The pattern continues with an optional group, e.g. "[on|in]".
+    /// </summary>
+    Optional,
+    /// <summary>
+    /// The pattern continues with a required group, e.g. "(left|right)".
+    /// </summary>
+    Required,
+    /// <summary>
+    /// The pattern continues with text the automaton does not handle (e.g. malformed UTF-8).
+    /// </summary>
+    Literal
+};
+
+/// <summary>
+/// A single pattern registered with the automaton.
+/// </summary>
+struct PatternAutomatonEntry
+{
+    std::string IntentId;
+    std::shared_ptr<CSpxPatternMatchingIntent> Intent;
+    size_t PatternIndex;
+    size_t PatternOffset;
+    PatternTransition Transition;
+};
+
+/// <summary>
+/// A pattern whose literal prefix matched the input.
+/// </summary>
+struct PatternAutomatonCandidate
+{
+    const PatternAutomatonEntry* Entry;
+    const char* InputLocation;
+    unsigned int BytesMatched;
+};
+
+/// <summary>
+/// Compiles the patterns of a model into one prefix tree. The literal text at the start of every pattern is
+/// merged with the literal text of all other patterns, and each pattern is attached to the node where its
+/// literal prefix ends together with the kind of element that follows. Walking the tree once for an input
+/// yields every pattern whose literal prefix matches, with the input location and byte count the pattern
+/// matching engine would have reached at that point.
+/// </summary>
+class CSpxPatternMatchingAutomaton
+{
+public:
+
+    void Init(const OrthographyInformation& orthography);
+    void Clear();
+
+    /// <summary>
+    /// Adds the patterns of the intent starting at firstPattern. Patterns before that index are assumed to
+    /// have been added already.
+    /// </summary>
+    /// <param name="intentId">The id the intent is registered under in the model.</param>
+    /// <param name="intent">The intent owning the patterns.</param>
+    /// <param name="firstPattern">The index of the first pattern to add.</param>
+    void AddPatterns(const std::string& intentId, const std::shared_ptr<CSpxPatternMatchingIntent>& intent, size_t firstPattern);
+
+    /// <summary>
+    /// Removes all patterns of the intent registered under intentId, touching only the nodes they were attached to.
+    /// </summary>
+    /// <param name="intentId">The id the intent is registered under in the model.</param>
+    void RemovePatterns(const std::string& intentId);
+
+    /// <summary>
+    /// Walks the input through the tree and collects every pattern whose literal prefix matches the input.
+    /// Candidates are returned in model order (by intent id, then pattern index).
+    /// </summary>
+    /// <param name="input">The null terminated UTF8 input.</param>
+    /// <param name="candidates">Receives the candidates.</param>
+    void Match(const char* input, std::vector<PatternAutomatonCandidate>& candidates) const;
+
+private:
+
+    struct Edge
+    {
+        uint32_t Character;
+        uint32_t Node;
+    };
+
+    struct Node
+    {
+        // Sorted by Character.
+        std::vector<Edge> Edges;
+        std::vector<uint32_t> Entries;
+        unsigned int BytesMatched = 0;
+    };
+
+    static uint32_t PackCharacter(const char* input, size_t bytes);
+    uint32_t GetOrAddChild(uint32_t node, uint32_t character, size_t bytes);
+
+    void Compact();
+
+    std::vector<Node> m_nodes{ 1 };
+    std::vector<PatternAutomatonEntry> m_entries;
+
+    // The node each entry is attached to, and the entries of each intent id. Entries of removed intents stay in
+    // m_entries, detached from their nodes, until there are more of them than live ones.
+    std::vector<uint32_t> m_entryNodes;
+    std::map<std::string, std::vector<uint32_t>> m_intentEntries;
+    size_t m_removedEntries = 0;
+    const OrthographyInformation* m_orthography = nullptr;
+};
+
+}}}}}
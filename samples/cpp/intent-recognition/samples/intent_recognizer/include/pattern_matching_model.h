@@ -5,11 +5,17 @@
 
 #pragma once
 #include <array>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <tuple>
+#include <vector>
 #include "intent_interfaces.h"
 #include "locale_information.h"
+#include "pattern_matching_automaton.h"
 #include "pattern_matching_intent.h"
+#include "utterance_tokens.h"
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -45,7 +51,42 @@ public:
 
     void AddIntent(std::shared_ptr<CSpxPatternMatchingIntent> intent, const std::string& intentId);
     void AddEntity(std::shared_ptr<ISpxEntity> entity);
+
+    // Changes to a model that is in use. Each one only updates the structures it affects and publishes a new snapshot
+    // when it is done, so matches never wait for it and see the model either before or after the change.
+
+    /// <summary>
+    /// Removes the intent and its patterns. Returns false if there is no intent with that id.
+    /// </summary>
+    bool RemoveIntent(const std::string& intentId);
+
+    /// <summary>
+    /// Replaces the intent and all of its patterns, or adds it if there is no intent with that id.
+    /// </summary>
+    void ReplaceIntent(std::shared_ptr<CSpxPatternMatchingIntent> intent, const std::string& intentId);
+
+    /// <summary>
+    /// Removes the patterns of the intent that were added from one of the phrases. Returns false if there were none.
+    /// </summary>
+    bool RemovePatterns(const std::string& intentId, const std::vector<std::string>& phrases);
+
+    /// <summary>
+    /// Removes the entity. Returns false if there is no entity with that name.
+    /// </summary>
+    bool RemoveEntity(const std::string& name);
+
+    /// <summary>
+    /// Removes phrases from a list entity, then adds phrases to it. Returns false if there is no list entity with
+    /// that name.
+    /// </summary>
+    bool UpdateListEntity(const std::string& name, const std::vector<std::string>& removed, const std::vector<std::string>& added);
+
     virtual const OrthographyInformation& GetOrthographyInfo() const;
+    /// <summary>
+    /// Finds all patterns matching the phrase. This does not take the model lock, it works on the snapshot of the
+    /// model published after the last change, so any number of threads can match concurrently with each other and
+    /// with threads adding intents or entities.
+    /// </summary>
     std::vector<std::shared_ptr<CSpxIntentMatchResult>> FindMatches(const std::string& phrase);
 
     const std::string& GetId() const;
@@ -53,28 +94,131 @@ public:
 private:
     friend class CSpxPatternMatchingFactory;
 
+    using IntentMap = std::map<std::string, std::shared_ptr<CSpxPatternMatchingIntent>>;
+    using EntityMap = std::map<std::string, std::shared_ptr<ISpxEntity>>;
+
+    /// <summary>
+    /// An immutable copy of everything FindMatches needs. Once published, a snapshot is never modified, changes to
+    /// the model go into a new one.
+    /// </summary>
+    struct Snapshot
+    {
+        IntentMap Intents;
+        EntityMap Entities;
+        std::shared_ptr<const CSpxPatternMatchingAutomaton> Automaton;
+    };
+
+    /// <summary>
+    /// Returns the current snapshot, building and publishing it first if the model changed since the last one.
+    /// </summary>
+    std::shared_ptr<const Snapshot> GetSnapshot();
+
+    // These expect m_mutex to be held.
+    void InsertIntent(const std::shared_ptr<CSpxPatternMatchingIntent>& intent, const std::string& intentId);
+    void InsertEntity(const std::shared_ptr<ISpxEntity>& entity);
+    bool EraseIntent(const std::string& intentId);
+    void Invalidate(bool automatonChanged);
+    std::shared_ptr<const Snapshot> PublishSnapshot();
+
+    /// <summary>
+    /// The entity parses of one FindMatches call. Patterns sharing an entity try it on the same spans of the
+    /// utterance over and over, this parses each span with each entity once. It also goes over the words of the
+    /// utterance once per entity to find those the entity can't contain, which rules out every span that has them
+    /// without parsing it.
+    /// </summary>
+    class EntityParseMemo
+    {
+    public:
+
+        explicit EntityParseMemo(const std::string& utterance) : m_utterance{ utterance }
+        {}
+
+        /// <summary>
+        /// Parses value, the text the entity was given for the input between start and end, or returns the result
+        /// of doing so before.
+        /// </summary>
+        const Maybe<std::string>& Parse(const ISpxEntity& entity, const char* start, const char* end, const std::string& value);
+
+        /// <summary>
+        /// Finds where the spans of the utterance that begin at start stop being worth parsing with the entity. A span
+        /// that ends there or later has a word the entity can't contain, see ISpxEntity::MayContainWord. Returns
+        /// nullptr if every span may be the entity. Words are separated by spaces, the same as RemoveLastToken does.
+        /// </summary>
+        const char* FindSpanLimit(const ISpxEntity& entity, const char* start);
+
+    private:
+
+        struct Entry
+        {
+            std::string Value;
+            Maybe<std::string> Result;
+        };
+
+        struct Word
+        {
+            size_t Start;
+            size_t End;
+        };
+
+        const std::string& m_utterance;
+        std::map<std::tuple<const ISpxEntity*, const char*, const char*>, Entry> m_entries;
+
+        // The words of the utterance and, for each of its bytes, the word it is in or the next word after a space.
+        // Found on the first call to FindSpanLimit.
+        std::vector<Word> m_words;
+        std::vector<size_t> m_wordAt;
+
+        // For each entity, the end of the first word it can't contain from each word on. npos if there is none.
+        std::map<const ISpxEntity*, std::vector<size_t>> m_limits;
+    };
+
     Maybe<std::shared_ptr<CSpxIntentMatchResult>> CheckPattern(
+        const Snapshot& snapshot,
         const char* input,
         const char* patternText,
         const IntentPattern& intentPattern,
         const char* intentId,
         unsigned int intentPriority,
         std::map<std::string, Impl::EntityResult>& entityResults,
-        unsigned int bytesPreviouslyMatched);
+        const CSpxUtteranceTokens& tokens,
+        EntityParseMemo& parseMemo,
+        unsigned int bytesPreviouslyMatched) const;
 
-    void StoreEntityResult(const std::string& entityName, std::string& entityValue, std::map<std::string, EntityResult>& entityResults, bool& requiredEntityPresent);
+    /// <summary>
+    /// The body of CheckPattern without its checks for empty input and pattern. This lets matching resume in the
+    /// middle of a pattern, e.g. after the automaton matched its literal prefix.
+    /// </summary>
+    Maybe<std::shared_ptr<CSpxIntentMatchResult>> MatchPattern(
+        const Snapshot& snapshot,
+        const char* input,
+        const char* patternText,
+        const IntentPattern& intentPattern,
+        const char* intentId,
+        unsigned int intentPriority,
+        std::map<std::string, Impl::EntityResult>& entityResults,
+        const CSpxUtteranceTokens& tokens,
+        EntityParseMemo& parseMemo,
+        unsigned int bytesPreviouslyMatched) const;
+
+    void StoreEntityResult(const Snapshot& snapshot, const std::string& entityName, std::string& entityValue, const char* entityStart, const char* entityEnd, std::map<std::string, EntityResult>& entityResults, EntityParseMemo& parseMemo, bool& requiredEntityPresent) const;
 
     /// <summary>
     /// This will parse the input for the optional phrases. It will put all phrases in the vector it returns. The pointer will be moved to the end of the optional phrase including the ']'.
     /// </summary>
     /// <param name="input">This should be a null terminated character array pointer.</param>
     /// <returns>A vector containing all of the optional phrases.</returns>
-    std::vector<std::string> ParseGroupedPhrases(const char** input);
+    std::vector<std::string> ParseGroupedPhrases(const char** input) const;
 
+    // Guards the members below except m_snapshot, which is only accessed through std::atomic_load/atomic_store.
     std::mutex m_mutex;
     std::string m_id;
-    std::map<std::string, std::shared_ptr<CSpxPatternMatchingIntent>> m_intentMap;
-    std::map<std::string, std::shared_ptr<ISpxEntity>> m_entityMap;
+    IntentMap m_intentMap;
+    EntityMap m_entityMap;
+    CSpxPatternMatchingAutomaton m_automaton;
+
+    // A copy of m_automaton shared by the snapshots since it last changed, so entity changes don't copy it.
+    std::shared_ptr<const CSpxPatternMatchingAutomaton> m_publishedAutomaton;
+    std::shared_ptr<const Snapshot> m_snapshot;
 
     const OrthographyInformation* m_orthography = &Locales::default_orthography();
 };
@@ -43,7 +43,7 @@ namespace Utils {
     /// It moves the pointer for startLocation past the characters.
     /// </summary>
     /// <param name="inputLocation">The null terminated UTF8 char buffer.</param>
-    void SkipPunctuationAndWhitespace(const char*& startLocation, const std::string& punctuation, const OrthographyInformation& orthography);
+    void SkipPunctuationAndWhitespace(const char*& startLocation, const CharacterSet& punctuation, const OrthographyInformation& orthography);
 
     /// <summary>
     /// This function checks the orthography input punctuation and skips any UTF8 characters in it.
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,7 +24,9 @@ namespace Impl {
     /// <summary>
     /// Base substring matcher that uses a trie internally to match one or more substrings. It will always return the longest
     /// match it can find. This class is templated so that you can specify the type of the value that is returned when a match
-    /// if found
+    /// if found.
+    /// Derived classes build the trie with UpdateSearchTree and must call Freeze once they are done. Freeze lays the trie out
+    /// in flat arrays which is what Find searches, and adds the failure links FindAll uses to scan in a single pass.
     /// </summary>
     template<typename TValue>
     class SubstringsMatcherBase
@@ -48,9 +53,36 @@ namespace Impl {
             TValue value{};
         };
 
+        /// <summary>
+        /// A node of the frozen trie. The children of a node are stored next to each other, starting at firstChild.
+        /// </summary>
+        struct FrozenNode
+        {
+            uint32_t firstChild;
+            uint32_t childCount;
+            uint32_t depth;
+            uint32_t valueIndex;
+        };
+
+        static constexpr uint32_t NO_NODE{ 0 };
+        static constexpr uint32_t NO_VALUE{ std::numeric_limits<uint32_t>::max() };
+
+        // Only used while building, Freeze empties it.
         SearchNode m_root;
         size_t m_maxMatchLen{ 0 };
 
+        // The frozen trie. Node 0 is the root, m_labels[i] is the character leading to node i and m_values holds the
+        // values of matching nodes. Most lookups fail on the first character, so the root's children get a direct table.
+        std::vector<FrozenNode> m_nodes{ FrozenNode{ 1, 0, 0, NO_VALUE } };
+        std::vector<char> m_labels{ '\0' };
+        std::vector<TValue> m_values;
+        std::array<uint32_t, 256> m_rootChildren{};
+
+        // Aho-Corasick failure links: the node for the longest proper suffix of a node's path that is also in the trie.
+        // m_outputDepths holds the length of the longest match that is a suffix of the node's path, 0 if there is none.
+        std::vector<uint32_t> m_failures{ 0 };
+        std::vector<uint32_t> m_outputDepths{ 0 };
+
     protected:
         SubstringsMatcherBase() = default;
 
@@ -102,24 +134,124 @@ namespace Impl {
             size_t stopAt = std::min(offset + count, input.length());
             for (size_t i = offset; i < stopAt;)
             {
-                const SearchNode* match = Match(input, i, stopAt, &m_root);
-                if (match->isMatch)
+                const FrozenNode& match = m_nodes[Match(input, i, stopAt)];
+                if (match.valueIndex != NO_VALUE)
                 {
                     if (value != nullptr)
                     {
-                        *value = match->value;
+                        *value = m_values[match.valueIndex];
                     }
                     return i;
                 }
                 else
                 {
-                    i += match->substring.length() + 1;
+                    i += match.depth + 1;
                 }
             }
 
             return NO_MATCH;
         }
 
+        /// <summary>
+        /// Gets the length of the longest substring that starts exactly at the specified offset. Unlike Find this does
+        /// not search past the offset
+        /// </summary>
+        /// <param name="input">The input to match in</param>
+        /// <param name="offset">The offset the substring must start at</param>
+        /// <param name="count">The maximum number of characters the substring can cover</param>
+        /// <param name="value">(Optional) The value for the match that was found</param>
+        /// <returns>The length of the match, or 0 if there is none</returns>
+        size_t MatchLength(const std::string& input, size_t offset, size_t count, TValue* value = nullptr) const
+        {
+            const FrozenNode& match = m_nodes[Match(input, offset, std::min(offset + count, input.length()))];
+            if (match.valueIndex == NO_VALUE)
+            {
+                return 0;
+            }
+
+            if (value != nullptr)
+            {
+                *value = m_values[match.valueIndex];
+            }
+            return match.depth;
+        }
+
+        /// <summary>
+        /// Gets the length of the shortest substring that starts exactly at the specified offset
+        /// </summary>
+        /// <param name="input">The input to match in</param>
+        /// <param name="offset">The offset the substring must start at</param>
+        /// <param name="count">The maximum number of characters the substring can cover</param>
+        /// <param name="value">(Optional) The value for the match that was found</param>
+        /// <returns>The length of the match, or 0 if there is none</returns>
+        size_t ShortestMatchLength(const std::string& input, size_t offset, size_t count, TValue* value = nullptr) const
+        {
+            size_t stopAt = std::min(offset + count, input.length());
+            uint32_t current = 0;
+            for (size_t i = offset; i < stopAt; i++)
+            {
+                current = FindChild(current, input[i]);
+                if (current == NO_NODE)
+                {
+                    return 0;
+                }
+
+                const FrozenNode& node = m_nodes[current];
+                if (node.valueIndex != NO_VALUE)
+                {
+                    if (value != nullptr)
+                    {
+                        *value = m_values[node.valueIndex];
+                    }
+                    return node.depth;
+                }
+            }
+            return 0;
+        }
+
+        /// <summary>
+        /// Finds all non-overlapping matches in the input in a single pass. Of matches starting at the same place the longest
+        /// is reported, and of overlapping matches the one starting first. Unlike Find this never skips over a match.
+        /// </summary>
+        /// <param name="input">The input to search in</param>
+        /// <param name="callback">Called as callback(index, length, value) for every match, in order. Return false to
+        /// stop searching.</param>
+        template<typename TCallback>
+        void FindAll(const std::string& input, TCallback callback) const
+        {
+            uint32_t state = 0;
+            for (size_t i = 0; i < input.length(); i++)
+            {
+                state = Transition(state, input[i]);
+                if (m_outputDepths[state] == 0)
+                {
+                    continue;
+                }
+
+                // This is the first match to end since the last one. A match that starts earlier can only be one that is
+                // still in progress, i.e. one that starts within the path of the current node. Take the first start that
+                // has a match, at the latest that is the start of the match ending here.
+                size_t firstStart = i + 1 - m_nodes[state].depth;
+                size_t lastStart = i + 1 - m_outputDepths[state];
+                for (size_t start = firstStart; start <= lastStart; start++)
+                {
+                    const FrozenNode& match = m_nodes[Match(input, start, input.length())];
+                    if (match.valueIndex != NO_VALUE)
+                    {
+                        if (!callback(start, static_cast<size_t>(match.depth), m_values[match.valueIndex]))
+                        {
+                            return;
+                        }
+
+                        // Continue after the match from the root, the loop moves i forward by one.
+                        i = start + match.depth - 1;
+                        state = 0;
+                        break;
+                    }
+                }
+            }
+        }
+
     protected:
         static void UpdateSearchTree(
             SearchNode& root,
@@ -162,32 +294,115 @@ namespace Impl {
             current->isMatch = true;
         }
 
-        static const SearchNode* Match(const std::string& input, size_t offset, size_t stopAt, const SearchNode* root)
+        /// <summary>
+        /// Lays the trie built by UpdateSearchTree out in flat arrays and releases the tree. Call this once, after the
+        /// last call to UpdateSearchTree.
+        /// </summary>
+        void Freeze()
         {
-            const SearchNode* lastMatch = nullptr;
-            const SearchNode* current = root;
+            // Breadth first, so the children of every node end up next to each other.
+            std::vector<const SearchNode*> order{ &m_root };
+            m_nodes.assign(1, FrozenNode{});
+            m_labels.assign(1, '\0');
+            m_values.clear();
+            m_rootChildren.fill(NO_NODE);
 
-            for (size_t i = offset; i < stopAt; i++)
+            for (size_t index = 0; index < order.size(); index++)
             {
-                const SearchNode* next;
-                auto iter = current->next.find(input[i]);
-                if (iter != current->next.end())
+                const SearchNode* source = order[index];
+
+                FrozenNode& node = m_nodes[index];
+                node.firstChild = static_cast<uint32_t>(order.size());
+                node.childCount = static_cast<uint32_t>(source->next.size());
+                node.depth = static_cast<uint32_t>(source->substring.length());
+                node.valueIndex = NO_VALUE;
+                if (source->isMatch)
                 {
-                    next = &(iter->second);
-                    if (next->isMatch)
+                    node.valueIndex = static_cast<uint32_t>(m_values.size());
+                    m_values.push_back(source->value);
+                }
+
+                // std::map keeps the children sorted by character, which FindChild relies on.
+                for (const auto& child : source->next)
+                {
+                    if (index == 0)
                     {
-                        lastMatch = next;
+                        m_rootChildren[static_cast<unsigned char>(child.first)] = static_cast<uint32_t>(order.size());
                     }
-                    
-                    current = next;
+                    order.push_back(&child.second);
+                    m_labels.push_back(child.first);
+                    m_nodes.push_back(FrozenNode{});
                 }
-                else
+            }
+
+            m_root = SearchNode{};
+
+            // The nodes are in breadth first order, so the failure links of shallower nodes are done before they are needed.
+            m_failures.assign(m_nodes.size(), 0);
+            m_outputDepths.assign(m_nodes.size(), 0);
+            for (uint32_t node = 0; node < m_nodes.size(); node++)
+            {
+                for (uint32_t child = m_nodes[node].firstChild; child < m_nodes[node].firstChild + m_nodes[node].childCount; child++)
+                {
+                    m_failures[child] = node == 0 ? 0 : Transition(m_failures[node], m_labels[child]);
+                    m_outputDepths[child] = m_nodes[child].valueIndex != NO_VALUE
+                        ? m_nodes[child].depth
+                        : m_outputDepths[m_failures[child]];
+                }
+            }
+        }
+
+    private:
+        uint32_t FindChild(uint32_t node, char character) const
+        {
+            if (node == 0)
+            {
+                return m_rootChildren[static_cast<unsigned char>(character)];
+            }
+
+            const FrozenNode& parent = m_nodes[node];
+            auto first = m_labels.begin() + parent.firstChild;
+            auto last = first + parent.childCount;
+            auto child = std::lower_bound(first, last, character);
+            return child != last && *child == character
+                ? static_cast<uint32_t>(child - m_labels.begin())
+                : NO_NODE;
+        }
+
+        uint32_t Transition(uint32_t node, char character) const
+        {
+            while (true)
+            {
+                uint32_t next = FindChild(node, character);
+                if (next != NO_NODE || node == 0)
+                {
+                    return next;
+                }
+                node = m_failures[node];
+            }
+        }
+
+        uint32_t Match(const std::string& input, size_t offset, size_t stopAt) const
+        {
+            uint32_t lastMatch = NO_NODE;
+            uint32_t current = 0;
+
+            for (size_t i = offset; i < stopAt; i++)
+            {
+                uint32_t next = FindChild(current, input[i]);
+                if (next == NO_NODE)
                 {
                     break;
                 }
+
+                if (m_nodes[next].valueIndex != NO_VALUE)
+                {
+                    lastMatch = next;
+                }
+                current = next;
             }
 
-            return lastMatch != nullptr
+            return lastMatch != NO_NODE
                 ? lastMatch
                 : current;
         }
@@ -196,6 +411,10 @@ namespace Impl {
     // *sigh* provide "storage" for this value so GCC can link. As of C++ 17, this is no longer required
     template<typename TVal>
     constexpr size_t SubstringsMatcherBase<TVal>::NO_MATCH;
+    template<typename TVal>
+    constexpr uint32_t SubstringsMatcherBase<TVal>::NO_NODE;
+    template<typename TVal>
+    constexpr uint32_t SubstringsMatcherBase<TVal>::NO_VALUE;
 
     /// <summary>
     /// Uses a trie internally to match one or more substrings. It will always return the longest
@@ -0,0 +1,80 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+/// <summary>
+/// A fixed number of worker threads taking work items from one queue. Recognizing a short utterance takes far less
+/// time than starting a thread, so recognizers hand their work to a pool instead of starting a thread per call.
+/// </summary>
+class CSpxThreadPool
+{
+public:
+
+    /// <summary>
+    /// Creates a pool with the given number of workers. 0 uses one worker per hardware thread.
+    /// </summary>
+    explicit CSpxThreadPool(size_t threadCount = 0);
+
+    /// <summary>
+    /// Runs everything already queued, then stops the workers.
+    /// </summary>
+    ~CSpxThreadPool();
+
+    CSpxThreadPool(const CSpxThreadPool&) = delete;
+    CSpxThreadPool& operator=(const CSpxThreadPool&) = delete;
+
+    /// <summary>
+    /// The pool shared by all recognizers that were not given a pool of their own.
+    /// </summary>
+    static std::shared_ptr<CSpxThreadPool> Default();
+
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+    /// <summary>
+    /// Queues a work item. Work items must not throw, and must not wait for other work items of the same pool since
+    /// those could be queued behind them.
+    /// </summary>
+    void Post(std::function<void()> work);
+
+    /// <summary>
+    /// Queues a function and returns a future for its result. Exceptions thrown by the function are stored in the future.
+    /// </summary>
+    template<typename TFunction>
+    auto Submit(TFunction function) -> std::future<decltype(function())>
+    {
+        using TResult = decltype(function());
+        auto task = std::make_shared<std::packaged_task<TResult()>>(std::move(function));
+        auto future = task->get_future();
+        Post([task]() { (*task)(); });
+        return future;
+    }
+
+private:
+
+    void WorkerLoop();
+
+    std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::deque<std::function<void()>> m_queue;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+}}}}}
@@ -5,7 +5,9 @@
 
 #pragma once
 #include <array>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -34,7 +36,7 @@ namespace Utils {
     /// <param name="utf8CharacterBuffer">The array to place the multi-byte character into.
     /// This does not need to include a null terminator.</param>
     /// <returns> The number of bytes making up the character.</returns>
-    size_t ExtractLastUtf8Character(std::string& input, std::array<char, 4>& utf8Character);
+    size_t ExtractLastUtf8Character(const std::string& input, std::array<char, 4>& utf8Character);
 
     /// <summary>
     /// This function takes in a char pointer pointing to the first byte of a multi-byte UTF-8 character.
@@ -47,4 +49,49 @@ namespace Utils {
     /// <returns> The number of bytes making up the character.</returns>
     size_t ExtractMultibyteUtf8Character(const char* input, std::array<char, 4>& utf8CharacterArray);
 
+    /// <summary>
+    /// Returns the number of ASCII bytes at the start of input, looking at no more than length bytes. Checks 16 bytes
+    /// at a time where SSE2 is available.
+    /// </summary>
+    size_t CountLeadingAscii(const char* input, size_t length);
+
+    /// <summary>
+    /// Returns true if input is well formed UTF-8: no overlong encodings, surrogates, code points past U+10FFFF or
+    /// characters cut short. This is what converting to a wide string accepts.
+    /// </summary>
+    bool IsWellFormedUtf8(const std::string& input);
+
+    /// <summary>
+    /// A set of the UTF-8 characters in a string, e.g. the punctuation of an orthography. ASCII characters are looked
+    /// up in a bitmap and others with a binary search of their sorted encodings, instead of searching the string.
+    /// Contains gives the same answer as searching the string with std::string::find for any bytes
+    /// ExtractUtf8Character returns, malformed characters are searched for in the string.
+    /// </summary>
+    class CharacterSet
+    {
+    public:
+
+        CharacterSet() = default;
+        explicit CharacterSet(const std::string& characters);
+
+        bool Contains(char character) const
+        {
+            auto byte = static_cast<unsigned char>(character);
+            if (byte < 128)
+            {
+                return (m_ascii[byte / 64] & (uint64_t{ 1 } << (byte % 64))) != 0;
+            }
+            return m_characters.find(character) != std::string::npos;
+        }
+
+        bool Contains(const char* character, size_t bytes) const;
+
+    private:
+
+        std::array<uint64_t, 2> m_ascii = { 0, 0 };
+        std::vector<uint32_t> m_multibyte;
+        std::string m_characters;
+        bool m_malformed = false;
+    };
+
 }}}}}
@@ -0,0 +1,84 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "intent_interfaces.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+/// <summary>
+/// The characters and words of an utterance, found in one pass over it. Matching a pattern walks the utterance with
+/// the input functions of Utils. These answer the same questions from tables instead, so the utterance is scanned once
+/// no matter how many patterns are matched against it.
+/// Locations are pointers into the utterance passed to Init, which must outlive this. Locations that are not at the
+/// start of a character, and utterances with malformed UTF-8, are left to the functions of Utils.
+/// </summary>
+class CSpxUtteranceTokens
+{
+public:
+
+    void Init(const char* utterance, const OrthographyInformation& orthography);
+
+    /// <summary>
+    /// The same as Utils::SkipInputPunctuationAndWhitespace.
+    /// </summary>
+    void SkipPunctuationAndWhitespace(const char*& location) const;
+
+    /// <summary>
+    /// The same as Utils::GrabNextWord, except that the word is returned as its length. It starts at
+    /// location - length once the call returns.
+    /// </summary>
+    size_t GrabNextWord(const char** location) const;
+
+    /// <summary>
+    /// The same as Utils::IsWordBoundary.
+    /// </summary>
+    bool IsWordBoundary(const char* location) const;
+
+    /// <summary>
+    /// The number of bytes of the character at location, 0 at the end of the utterance. The same as the size of
+    /// Utils::GrabNextNonWhitespaceWord(location).
+    /// </summary>
+    size_t GetCharacterBytes(const char* location) const;
+
+    /// <summary>
+    /// Returns true if the character at location is the given bytes, or location is at the end and there are no bytes.
+    /// The same as Utils::GrabNextNonWhitespaceWord(location) == std::string(character, bytes).
+    /// </summary>
+    bool IsCharacter(const char* location, const char* character, size_t bytes) const;
+
+private:
+
+    struct Character
+    {
+        // Bytes of the character starting here. NotCharacter in the middle of one.
+        uint8_t Bytes;
+        bool WordBoundary;
+
+        // Where skipping input punctuation and whitespace from here stops, and where the word starting here ends.
+        uint32_t SkipTo;
+        uint32_t WordEnd;
+    };
+
+    static constexpr uint8_t NotCharacter = 0xFF;
+
+    const Character* Find(const char* location) const;
+
+    const char* m_utterance = nullptr;
+    const OrthographyInformation* m_orthography = nullptr;
+
+    // One entry per byte of the utterance and one for its end. Empty if the tables couldn't be built.
+    std::vector<Character> m_characters;
+};
+
+}}}}}
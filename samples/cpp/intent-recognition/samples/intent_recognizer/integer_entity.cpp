@@ -33,6 +33,11 @@ public:
     {
         return Maybe<std::string>();
     }
+
+    virtual bool MayContainWord(const std::string&) const override
+    {
+        return false;
+    }
 };
 
 void CSpxIntegerEntity::SetMode(Intent::EntityMatchMode)
@@ -98,4 +103,9 @@ Maybe<std::string> CSpxIntegerEntity::Parse(const std::string& input) const
     return m_integerParser->Parse(input);
 }
 
+bool CSpxIntegerEntity::MayContainWord(const std::string& word) const
+{
+    return m_integerParser->MayContainWord(word);
+}
+
 }}}}}
@@ -27,6 +27,8 @@ void CSpxIntentMatchResult::InitIntentMatchResult(
     m_entities = entities;
     m_priority = priority;
     m_bytesMatched = bytesMatched;
+    m_integerEntityCount = SpxIntentMatchResultCompare::CountEntityType(m_entities, Intent::EntityType::PrebuiltInteger);
+    m_listEntityCount = SpxIntentMatchResultCompare::CountEntityType(m_entities, Intent::EntityType::List);
 }
 
 int64_t SpxIntentMatchResultCompare::CountEntityType(const std::map<std::string, EntityResult>& entities, Intent::EntityType type)
@@ -38,7 +40,7 @@ int64_t SpxIntentMatchResultCompare::CountEntityType(const std::map<std::string,
 }
 
 // returns true if one should be higher priority.
-bool SpxIntentMatchResultCompare::operator()(std::shared_ptr<CSpxIntentMatchResult> one, std::shared_ptr<CSpxIntentMatchResult> two) const
+bool SpxIntentMatchResultCompare::operator()(const std::shared_ptr<CSpxIntentMatchResult>& one, const std::shared_ptr<CSpxIntentMatchResult>& two) const
 {
     if (one->GetPriority() < two->GetPriority())
     {
@@ -63,8 +65,8 @@ bool SpxIntentMatchResultCompare::operator()(std::shared_ptr<CSpxIntentMatchResu
         // Compare based on entity types starting with PrebuiltIntegers.
         if (oneSize == twoSize)
         {
-            auto thisPrebuiltIntegerCount = CountEntityType(one->GetEntities(), Intent::EntityType::PrebuiltInteger);
-            auto thatPrebuiltIntergerCount = CountEntityType(two->GetEntities(), Intent::EntityType::PrebuiltInteger);
+            auto thisPrebuiltIntegerCount = one->GetEntityCount(Intent::EntityType::PrebuiltInteger);
+            auto thatPrebuiltIntergerCount = two->GetEntityCount(Intent::EntityType::PrebuiltInteger);
             if (thisPrebuiltIntegerCount > thatPrebuiltIntergerCount)
             {
                 return true;
@@ -72,8 +74,8 @@ bool SpxIntentMatchResultCompare::operator()(std::shared_ptr<CSpxIntentMatchResu
 
             if (thisPrebuiltIntegerCount == thatPrebuiltIntergerCount)
             {
-                auto thisListEntityCount = CountEntityType(one->GetEntities(), Intent::EntityType::List);
-                auto thatListEntityCount = CountEntityType(two->GetEntities(), Intent::EntityType::List);
+                auto thisListEntityCount = one->GetEntityCount(Intent::EntityType::List);
+                auto thatListEntityCount = two->GetEntityCount(Intent::EntityType::List);
                 if (thisListEntityCount > thatListEntityCount)
                 {
                     return true;
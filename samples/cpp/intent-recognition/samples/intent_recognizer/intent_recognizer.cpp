@@ -5,8 +5,13 @@
 
 #include "stdafx.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <regex>
-#include <set>
+#include <stdexcept>
+#include <vector>
 
 #include "intent_match_result.h"
 #include "intent_trigger.h"
@@ -78,6 +83,13 @@ void CSpxIntentRecognizer::AddIntentTrigger(const std::string& id, const ISpxTri
     }
 }
 
+std::shared_ptr<CSpxPatternMatchingModel> CSpxIntentRecognizer::FindPatternMatchingModel(const std::string& modelId) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto model = m_patternMatchingModelMap.find(modelId);
+    return model != m_patternMatchingModelMap.end() ? model->second : nullptr;
+}
+
 std::shared_ptr<CSpxPatternMatchingModel> CSpxIntentRecognizer::GetOrCreateModel(const std::string& key)
 {
     if (m_patternMatchingModelMap.find(key) != m_patternMatchingModelMap.end())
@@ -94,120 +106,244 @@ std::shared_ptr<CSpxPatternMatchingModel> CSpxIntentRecognizer::GetOrCreateModel
     }
 }
 
-void CSpxIntentRecognizer::ProcessText(const std::string& inputText, std::string& intentId, std::string& jsonResult, std::string& detailedJsonResult)
+IntentRecognitionOutput CSpxIntentRecognizer::ProcessText(const std::string& inputText, const ModelMatchingOptions& options) const
+{
+    IntentRecognitionOutput output;
+    ProcessText(inputText, output, options);
+    return output;
+}
+
+void CSpxIntentRecognizer::ProcessText(const std::string& inputText, IntentRecognitionOutput& output, const ModelMatchingOptions& options) const
 {
     SPX_DBG_TRACE_FUNCTION();
 
+    output.IntentId.clear();
+    output.Matches.clear();
+
     // We only need to process the result when the input actually contains something...
     SPX_DBG_TRACE_VERBOSE("%s: text='%s'", __FUNCTION__, inputText.c_str());
     if (!inputText.empty())
     {
-        InitIntentResult();
-
-        intentId = IntentIdFromPatternMatchingModels(inputText);
-
-        if (!intentId.empty())
+        MatchPatternMatchingModels(inputText, options, output.Matches);
+        if (!output.Matches.empty())
         {
-            jsonResult = m_jsonResult;
-            detailedJsonResult = m_detailedJsonResult;
+            // The first intent should be the highest priority, that is the one we return. The other matches are
+            // kept for the detailed result.
+            output.IntentId.assign(output.Matches.front()->GetIntentId());
         }
     }
 }
 
-void CSpxIntentRecognizer::InitIntentResult(const char* intentId, const char* jsonResult, const char* detailedJsonResult)
+std::string CSpxIntentRecognizer::RenderDetailedJsonResult(const std::vector<std::shared_ptr<CSpxIntentMatchResult>>& matches)
 {
-    m_intentId = (intentId != nullptr) ? intentId : "";
-    m_jsonResult = (jsonResult != nullptr) ? jsonResult : "";
-    m_detailedJsonResult = (detailedJsonResult != nullptr) ? detailedJsonResult : "";
-}
-
-std::string CSpxIntentRecognizer::PrepareSimplePatternResults(std::set<std::shared_ptr<CSpxIntentMatchResult>, SpxIntentMatchResultCompare>& matchResults, const std::string& inputText)
-{
-    // Grab the first intent which should be the highest priority and return that. Pass other matches to the intent result
-    // to be stored in the detailed property.
-    auto& firstIntent = *matchResults.begin();
-    auto& firstIntentId = firstIntent->GetIntentId();
-    auto entitiesJson = ajv::json::Build();
-
-    // Copy the entities into the json
-    for (auto& entity : firstIntent->GetEntities())
+    if (matches.empty())
     {
-        entitiesJson[entity.first] = entity.second.Value;
+        return "";
     }
 
-    // Build the detailed intent json
-    auto intentsJson = ajv::json::Build();
-    int index = 0;
-    for (auto matchResult : matchResults)
+    // Reserve for the usual result, so that only strings that need escaping can make it grow.
+    size_t size = 2;
+    for (auto& matchResult : matches)
     {
-        AddToPatternMatchingJson(intentsJson[index], matchResult);
-        index++;
+        size += 64 + matchResult->GetIntentId().length() + matchResult->GetPattern().length();
+        for (auto& entity : matchResult->GetEntities())
+        {
+            size += 6 + entity.first.length() + entity.second.Value.length();
+        }
     }
 
-    // Update our result with the appropriate ID and json entities
-    InitIntentResult(firstIntentId.c_str(), entitiesJson.AsJson().c_str(), intentsJson.AsJson().c_str());
+    std::string json;
+    json.reserve(size);
 
-    return firstIntentId;
+    // Build the detailed intent json
+    auto writer = ajv::json::Write(json);
+    writer.StartArray();
+    for (auto& matchResult : matches)
+    {
+        AddToPatternMatchingJson(writer, matchResult);
+    }
+    writer.EndArray();
+    return json;
 }
 
-void CSpxIntentRecognizer::AddToPatternMatchingJson(ajv::JsonBuilder::JsonWriter writer, std::shared_ptr<CSpxIntentMatchResult> matchResult) const
+void CSpxIntentRecognizer::AddToPatternMatchingJson(ajv::JsonStreamWriter& writer, const std::shared_ptr<CSpxIntentMatchResult>& matchResult)
 {
-    writer["intentId"] = matchResult->GetIntentId();
-    writer["pattern"] = matchResult->GetPattern();
-    writer["priority"] = matchResult->GetPriority();
+    writer.StartObject();
+    writer.Name("intentId").Value(matchResult->GetIntentId());
+    writer.Name("pattern").Value(matchResult->GetPattern());
+    writer.Name("priority").Value(matchResult->GetPriority());
 
-    for (auto& entity : matchResult->GetEntities())
+    auto& entities = matchResult->GetEntities();
+    if (!entities.empty())
     {
-        writer["entities"][entity.first] = entity.second.Value;
+        writer.Name("entities").StartObject();
+        for (auto& entity : entities)
+        {
+            writer.Name(entity.first).Value(entity.second.Value);
+        }
+        writer.EndObject();
     }
+    writer.EndObject();
 }
 
-std::string CSpxIntentRecognizer::IntentIdFromPatternMatchingModels(const std::string& inputText)
+bool CSpxIntentRecognizer::HasExactTopMatch(const std::vector<std::shared_ptr<CSpxIntentMatchResult>>& results)
 {
-    std::unique_lock<std::mutex> lock(m_mutex);
+    return std::any_of(results.begin(), results.end(), [](const std::shared_ptr<CSpxIntentMatchResult>& result)
+        {
+            return result->GetPriority() == 0 && result->GetEntities().empty();
+        });
+}
+
+void CSpxIntentRecognizer::MatchPatternMatchingModels(const std::string& inputText, const ModelMatchingOptions& options, std::vector<std::shared_ptr<CSpxIntentMatchResult>>& matches) const
+{
+    matches.clear();
 
     auto phrase = CSpxIntentTrigger::NormalizeInput(inputText);
 
     if (phrase.empty())
     {
-        return phrase;
+        return;
     }
 
-    std::set<std::shared_ptr<CSpxIntentMatchResult>, SpxIntentMatchResultCompare> intentResults{};
+    // Only hold the lock long enough to copy the model list, the models protect themselves. Don't forget the default
+    // model, it goes last.
+    std::vector<std::shared_ptr<CSpxPatternMatchingModel>> models;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        models.reserve(m_patternMatchingModelMap.size() + 1);
+        for (const auto& model : m_patternMatchingModelMap)
+        {
+            models.push_back(model.second);
+        }
+    }
+    if (m_defaultPatternMatchingModel)
+    {
+        models.push_back(m_defaultPatternMatchingModel);
+    }
 
-    for (const auto& model : m_patternMatchingModelMap)
+    std::vector<std::vector<std::shared_ptr<CSpxIntentMatchResult>>> modelResults;
+    if (options.ThreadPool == nullptr || models.size() < 2)
     {
-        const auto& patternModel = model.second;
-        auto results = patternModel->FindMatches(phrase);
-        if (results.size() != 0)
+        for (const auto& patternModel : models)
         {
-            for (auto& matchResult : results)
+            modelResults.push_back(patternModel->FindMatches(phrase));
+            if (options.StopAtExactMatch && HasExactTopMatch(modelResults.back()))
             {
-                intentResults.insert(matchResult);
+                break;
             }
         }
     }
-
-    // Don't forget the default model.
-    if (m_defaultPatternMatchingModel)
+    else
     {
-        auto results = m_defaultPatternMatchingModel->FindMatches(phrase);
-        if (results.size() != 0)
+        // Models are claimed in order from a shared index by this thread and by helpers posted to the pool. This
+        // thread only ever waits for models a running helper has claimed, never for a helper that is still queued,
+        // so it may be a worker of the same pool. Helpers can outlive this call, so they share the state.
+        struct FanOut
+        {
+            std::vector<std::shared_ptr<CSpxPatternMatchingModel>> models;
+            std::string phrase;
+            bool stopAtExactMatch;
+            std::vector<std::vector<std::shared_ptr<CSpxIntentMatchResult>>> results;
+            std::vector<std::exception_ptr> errors;
+            std::vector<bool> done;
+            std::atomic<size_t> nextModel{ 0 };
+            // The first model with an exact top match, models after it need not be matched.
+            std::atomic<size_t> lastModel;
+            std::mutex mutex;
+            std::condition_variable modelDone;
+
+            void MatchModels()
+            {
+                for (auto index = nextModel++; index < models.size() && index <= lastModel; index = nextModel++)
+                {
+                    std::vector<std::shared_ptr<CSpxIntentMatchResult>> matches;
+                    std::exception_ptr failure;
+                    try
+                    {
+                        matches = models[index]->FindMatches(phrase);
+                    }
+                    catch (...)
+                    {
+                        failure = std::current_exception();
+                    }
+
+                    if (stopAtExactMatch && HasExactTopMatch(matches))
+                    {
+                        auto last = lastModel.load();
+                        while (index < last && !lastModel.compare_exchange_weak(last, index))
+                        {
+                        }
+                    }
+
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        results[index] = std::move(matches);
+                        errors[index] = failure;
+                        done[index] = true;
+                    }
+                    modelDone.notify_all();
+                }
+            }
+        };
+
+        auto fanOut = std::make_shared<FanOut>();
+        fanOut->models = std::move(models);
+        fanOut->phrase = phrase;
+        fanOut->stopAtExactMatch = options.StopAtExactMatch;
+        fanOut->results.resize(fanOut->models.size());
+        fanOut->errors.resize(fanOut->models.size());
+        fanOut->done.resize(fanOut->models.size());
+        fanOut->lastModel = fanOut->models.size() - 1;
+
+        auto helpers = std::min(fanOut->models.size() - 1, options.ThreadPool->GetThreadCount());
+        for (size_t helper = 0; helper < helpers; helper++)
         {
-            for (auto& matchResult : results)
+            try
             {
-                intentResults.insert(matchResult);
+                options.ThreadPool->Post([fanOut]() { fanOut->MatchModels(); });
+            }
+            catch (const std::runtime_error&)
+            {
+                // The pool is shutting down, this thread matches the rest.
+                break;
             }
         }
-    }
+        fanOut->MatchModels();
 
-    if (intentResults.size() == 0)
-    {
-        return "";
+        std::unique_lock<std::mutex> lock(fanOut->mutex);
+        fanOut->modelDone.wait(lock, [&]()
+            {
+                auto last = fanOut->lastModel.load();
+                return std::all_of(fanOut->done.begin(), fanOut->done.begin() + last + 1, [](bool done) { return done; });
+            });
+
+        // Helpers may still be matching models after the last one, leave their slots alone.
+        auto lastModel = fanOut->lastModel.load();
+        for (size_t index = 0; index <= lastModel; index++)
+        {
+            if (fanOut->errors[index] != nullptr)
+            {
+                std::rethrow_exception(fanOut->errors[index]);
+            }
+            modelResults.push_back(std::move(fanOut->results[index]));
+        }
     }
-    else
+
+    // Only the first of equivalent matches is kept, so the matches are ranked in the order of the models whichever
+    // thread found them. Matches that rank the same are common, so the ranked matches are few: they are kept sorted in
+    // one flat array and each match is placed with a binary search, comparing ranking values that were computed when
+    // the match was made.
+    SpxIntentMatchResultCompare ranksAbove;
+    for (auto& results : modelResults)
     {
-        return PrepareSimplePatternResults(intentResults, inputText);
+        for (auto& matchResult : results)
+        {
+            auto position = std::lower_bound(matches.begin(), matches.end(), matchResult, ranksAbove);
+            if (position == matches.end() || ranksAbove(matchResult, *position))
+            {
+                matches.insert(position, std::move(matchResult));
+            }
+        }
     }
 }
 
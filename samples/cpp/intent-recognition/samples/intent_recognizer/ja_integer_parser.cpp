@@ -3,9 +3,7 @@
 // Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
 //
 
-#include <codecvt>
 #include <deque>
-#include <map>
 #include <sstream>
 #include <stack>
 #include <string>
@@ -13,7 +11,8 @@
 
 #include "es_integer_parser.h" // needed for the Token struct
 #include "ja_integer_parser.h"
-#include "string_utils.h"
+#include "number_words.h"
+#include "utf8_utils.h"
 
 namespace Microsoft {
 namespace SpeechSDK {
@@ -21,15 +20,7 @@ namespace Standalone {
 namespace Intent {
 namespace Impl {
 
-struct comparator
-{
-    bool operator()(const char* lhs, const char* rhs) const
-    {
-        return std::strcmp(lhs, rhs) < 0;
-    }
-};
-
-const static std::map<const char*, Token, comparator> NUMBERS
+const static CSpxNumberWords<Token> NUMBERS
 {
     // 0b1 mask
     {"れい", Token(0, 0b1)},
@@ -122,44 +113,30 @@ const static std::map<const char*, Token, comparator> NUMBERS
 };
 
 // Section start: Parser
-Maybe<Token> CSpxJPIntegerParser::GetNumericValue(std::string& input)
-{
-    auto result = NUMBERS.find(input.c_str());
-    if (result == NUMBERS.end())
-    {
-        return nullptr;
-    }
-    else
-    {
-        return result->second;
-    }
-}
-
 Maybe<std::vector<Token>> CSpxJPIntegerParser::FromString(const std::string& input)
 {
     std::vector<Token> output;
 
-    // Convert the input string to a wide string
-    std::wstring winput = PAL::ToWString(input);
-
-    std::vector<wchar_t> accumulator = {};
-
-    // Iterate over the wide string from beginning to end appending characters to the
-    // accumulator until we get a match
-    for (auto it = winput.begin(); it != winput.end(); ++it)
+    // Input that is not valid UTF-8 has no characters to look at
+    if (!Utils::IsWellFormedUtf8(input))
     {
-        // Print each wide character as a UTF-8 encoded string
-        accumulator.push_back(*it);
-        std::wstring w_accumulated(accumulator.begin(), accumulator.end());
-        std::string accumulated = PAL::ToString(w_accumulated);
+        return output;
+    }
 
-        auto token = GetNumericValue(accumulated);
-        if (token)
+    // Take the shortest word that starts where the last one ended, until none does. The words are whole characters so
+    // they always end on a character boundary.
+    size_t offset = 0;
+    while (offset < input.length())
+    {
+        Token token;
+        auto length = NUMBERS.ShortestMatchLength(input, offset, input.length() - offset, &token);
+        if (length == 0)
         {
-            // std::cout << token.Get().value << std::endl;
-            output.push_back(token.Get());
-            accumulator = {};
+            break;
         }
+
+        output.push_back(token);
+        offset += length;
     }
     return output;
 }
@@ -245,19 +222,6 @@ constexpr bool CSpxJPIntegerParser::IsMultiplier(const uint64_t& input)
 // Section end: Segmenter
 
 // Section start: Aggregator
-inline uint64_t AggregateAcc(std::deque<uint64_t> numbers)
-{
-    uint64_t accumulator = 0;
-    while (!numbers.empty())
-    {
-        auto value = numbers.front();
-        numbers.pop_front();
-        accumulator += value;
-    }
-
-    return accumulator;
-}
-
 Maybe<std::string> CSpxJPIntegerParser::Aggregate(std::vector<std::vector<Token>> numbers)
 {
     std::ostringstream output;
@@ -266,7 +230,7 @@ Maybe<std::string> CSpxJPIntegerParser::Aggregate(std::vector<std::vector<Token>
 
     while (it != end) {
         const auto& number = *it;
-        auto result = AsInteger(number);
+        auto result = AggregateTokens(number, IsMultiplier);
         if (result) {
             output << result.Get();
         } else {
@@ -278,73 +242,15 @@ Maybe<std::string> CSpxJPIntegerParser::Aggregate(std::vector<std::vector<Token>
     return output.str();
 }
 
-Maybe<uint64_t> CSpxJPIntegerParser::AsInteger(std::vector<Token> numbers)
-{
-    // if the number is only a connector we fail as we don't want to return `0`
-    if (numbers.size() == 1 && numbers.front().Type == Tag::Connector)
-    {
-        return nullptr;
-    }
-
-    std::deque<uint64_t> total;
-
-    uint64_t acc = 0LL;
-    bool wasLastIterationMultiplication = false;
-    for (auto& token : numbers)
-    {
-        if (token.Type == Tag::Connector)
-        {
-            continue;
-        }
-        uint64_t input = token.Value;
-
-        // we only start operating on an accumalator that has been initialised
-        if (acc > 0)
-        {
-            // multipliers are numbers divisible by 1000
-            auto isMulti = IsMultiplier(input);
-
-            // accumulator are groups of numbers of length at most xxx
-            // namely up to the hundreds digit
-            if (isMulti && acc < input)
-            {
-                wasLastIterationMultiplication = true;
-                acc *= input;
-            }
-            // if did not multiply the accumulator in the previous iteration
-            // it means that we are still working in an xxx number group
-            // that will be eventually multiplied (unless is the last one)
-            else if (!isMulti && acc > input && !wasLastIterationMultiplication)
-            {
-                wasLastIterationMultiplication = false;
-                acc += input;
-            }
-            // If we have reached a number where that is bigger than the latest
-            // accumulator, it means that we commit the result to the accumulator
-            // and we start the next group of xxx
-            else
-            {
-                wasLastIterationMultiplication = false;
-                total.push_front(acc);
-                acc = input;
-            }
-        }
-        // We initialise te accumulator
-        else
-        {
-            acc = input;
-        }
-    }
-
-    // we break off the for loop before we are able to commit the last bit
-    total.push_front(acc);
-
-    // we collapse the deque by adding all its elements
-    return AggregateAcc(total);
-}
 // Section end: Aggregator
 
  // --- ISpxIntegerParser ---
+bool CSpxJPIntegerParser::MayContainWord(const std::string&) const
+{
+    // Only the numbers at the start of the input are read, anything may come after them.
+    return true;
+}
+
 Maybe<std::string> CSpxJPIntegerParser::Parse(const std::string& input) const
 {
     auto parsed = FromString(input);
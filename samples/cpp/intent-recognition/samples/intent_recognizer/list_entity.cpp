@@ -3,6 +3,7 @@
 // Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
 //
 
+#include <ctype.h>
 #include <regex>
 #include <stack>
 #include <stdlib.h>
@@ -35,11 +36,113 @@ void CSpxListEntity::AddPhrase(const std::string& phrase)
     std::string normalized = CSpxIntentTrigger::NormalizeInput(phrase);
     if (!normalized.empty())
     {
-        m_phrases.push_back(normalized);
-
         // Update the greed based on the larges number of words in our list of phrases
         m_greed = std::max(m_greed, CalculateGreed(*m_orthography, normalized));
+        InsertNormalizedPhrase(std::move(normalized));
+    }
+}
+
+CSpxListEntity::PreparedPhrases CSpxListEntity::PreparePhrases(const std::vector<std::string>& phrases, size_t begin, size_t end) const
+{
+    PreparedPhrases prepared;
+    prepared.Normalized.reserve(end - begin);
+    for (auto i = begin; i < end; i++)
+    {
+        auto normalized = CSpxIntentTrigger::NormalizeInput(phrases[i]);
+        if (!normalized.empty())
+        {
+            prepared.Greed = std::max(prepared.Greed, CalculateGreed(*m_orthography, normalized));
+            prepared.Normalized.push_back(std::move(normalized));
+        }
+    }
+    return prepared;
+}
+
+void CSpxListEntity::AddPreparedPhrases(PreparedPhrases&& prepared)
+{
+    m_greed = std::max(m_greed, prepared.Greed);
+    for (auto& normalized : prepared.Normalized)
+    {
+        InsertNormalizedPhrase(std::move(normalized));
+    }
+}
+
+void CSpxListEntity::InsertNormalizedPhrase(std::string&& normalized)
+{
+    auto folded = FoldCase(normalized);
+    m_removedPhrases.erase(folded);
+
+    // Keep the first phrase for each folding, Parse used to return the first match in insertion order.
+    if (m_frozenPhrases == nullptr || m_frozenPhrases->find(folded) == m_frozenPhrases->end())
+    {
+        m_phrases.emplace(std::move(folded), std::move(normalized));
+    }
+}
+
+void CSpxListEntity::RemovePhrase(const std::string& phrase)
+{
+    auto folded = FoldCase(CSpxIntentTrigger::NormalizeInput(phrase));
+    if (folded.empty())
+    {
+        return;
+    }
+
+    m_phrases.erase(folded);
+
+    // Frozen and compiled phrases can't be erased, they are hidden instead.
+    auto frozen = m_frozenPhrases != nullptr && m_frozenPhrases->find(folded) != m_frozenPhrases->end();
+    auto compiled = m_compiledList != nullptr && m_compiledList->Find(folded);
+    if (frozen || compiled)
+    {
+        m_removedPhrases.insert(std::move(folded));
+    }
+}
+
+std::shared_ptr<CSpxListEntity> CSpxListEntity::Update(const std::vector<std::string>& removed, const std::vector<std::string>& added) const
+{
+    auto updated = std::make_shared<CSpxListEntity>(*this);
+    for (const auto& phrase : removed)
+    {
+        updated->RemovePhrase(phrase);
+    }
+    for (const auto& phrase : added)
+    {
+        updated->AddPhrase(phrase);
+    }
+
+    // Every update copies the phrases that are not frozen yet, freezing them now and then keeps that small. Each
+    // freeze copies the whole list, so it is only done once the changes since the last one are a fair part of it.
+    auto frozenCount = m_frozenPhrases != nullptr ? m_frozenPhrases->size() : 0;
+    if (updated->m_phrases.size() + updated->m_removedPhrases.size() > std::max<size_t>(4096, frozenCount / 16))
+    {
+        updated->Freeze();
+    }
+    return updated;
+}
+
+void CSpxListEntity::Freeze()
+{
+    auto frozen = m_frozenPhrases != nullptr ? std::make_shared<PhraseMap>(*m_frozenPhrases) : std::make_shared<PhraseMap>();
+    for (auto removed = m_removedPhrases.begin(); removed != m_removedPhrases.end();)
+    {
+        frozen->erase(*removed);
+
+        // Only compiled phrases still need to be hidden.
+        removed = m_compiledList != nullptr && m_compiledList->Find(*removed) ? std::next(removed) : m_removedPhrases.erase(removed);
+    }
+    for (auto& phrase : m_phrases)
+    {
+        frozen->emplace(phrase.first, std::move(phrase.second));
+    }
+    m_phrases.clear();
+
+    // Removed phrases may have been the longest ones.
+    m_greed = m_compiledGreed;
+    for (const auto& phrase : *frozen)
+    {
+        m_greed = std::max(m_greed, CalculateGreed(*m_orthography, phrase.second));
     }
+    m_frozenPhrases = std::move(frozen);
 }
 
 const std::string& CSpxListEntity::GetName() const
@@ -68,18 +171,68 @@ unsigned int CSpxListEntity::CalculateGreed(const OrthographyInformation& orthog
     return num;
 }
 
+std::string CSpxListEntity::FoldCase(const std::string& value)
+{
+    // Fold the way PAL::stricmp compares: byte by byte, ASCII only, up to the first null character.
+    std::string folded;
+    folded.reserve(value.length());
+    for (char c : value)
+    {
+        if (c == '\0')
+        {
+            break;
+        }
+        folded += static_cast<char>(::tolower(static_cast<unsigned char>(c)));
+    }
+    return folded;
+}
+
+void CSpxListEntity::AttachCompiledList(std::shared_ptr<const CSpxCompiledList> list)
+{
+    m_compiledList = std::move(list);
+
+    auto greed = m_compiledList->GetGreed(m_orthography->Name);
+    if (!greed)
+    {
+        // The image was compiled before this orthography existed, count the words ourselves.
+        unsigned int counted = 0;
+        for (size_t i = 0; i < m_compiledList->GetPhraseCount(); i++)
+        {
+            counted = std::max(counted, CalculateGreed(*m_orthography, m_compiledList->GetPhrase(i)));
+        }
+        greed = counted;
+    }
+    m_compiledGreed = greed.Get();
+    m_greed = std::max(m_greed, m_compiledGreed);
+}
+
 Maybe<std::string> CSpxListEntity::Parse(const std::string& input) const
 {
-    std::string result(input);
-    // If we are strict default to an empty string.
     if (m_matchMode == Intent::EntityMatchMode::Strict)
     {
-        result = "";
-        for (auto& phrase : m_phrases)
+        auto folded = FoldCase(input);
+        auto removed = IsRemoved(folded);
+        if (m_compiledList != nullptr && !removed)
         {
-            if (PAL::stricmp(phrase.c_str(), input.c_str()) == 0)
+            auto compiled = m_compiledList->Find(folded);
+            if (compiled)
             {
-                return phrase;
+                return compiled;
+            }
+        }
+
+        auto found = m_phrases.find(folded);
+        if (found != m_phrases.end())
+        {
+            return found->second;
+        }
+
+        if (m_frozenPhrases != nullptr && !removed)
+        {
+            found = m_frozenPhrases->find(folded);
+            if (found != m_frozenPhrases->end())
+            {
+                return found->second;
             }
         }
     }
@@ -92,4 +245,39 @@ Maybe<std::string> CSpxListEntity::Parse(const std::string& input) const
     return Maybe<std::string>();
 }
 
+bool CSpxListEntity::MayStartWith(const std::string& prefix) const
+{
+    if (m_matchMode != Intent::EntityMatchMode::Strict)
+    {
+        return true;
+    }
+
+    // Phrases starting with the prefix sort right at or after it. Removed compiled phrases still count, which only
+    // means the caller tries a prefix that then fails to parse.
+    auto folded = FoldCase(prefix);
+    auto hasPrefix = [&](const std::string& phrase) { return phrase.compare(0, folded.length(), folded) == 0; };
+    if (m_compiledList != nullptr && m_compiledList->HasPrefix(folded))
+    {
+        return true;
+    }
+
+    auto candidate = m_phrases.lower_bound(folded);
+    if (candidate != m_phrases.end() && hasPrefix(candidate->first))
+    {
+        return true;
+    }
+
+    if (m_frozenPhrases != nullptr)
+    {
+        for (auto frozen = m_frozenPhrases->lower_bound(folded); frozen != m_frozenPhrases->end() && hasPrefix(frozen->first); frozen++)
+        {
+            if (!IsRemoved(frozen->first))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 }}}}}
@@ -103,6 +103,16 @@ namespace Locales {
             : nullptr;
     }
 
+    std::vector<const OrthographyInformation*> all_orthographies()
+    {
+        std::vector<const OrthographyInformation*> orthographies;
+        for (auto& orthography : ORTHOGRAPHY_INFORMATION)
+        {
+            orthographies.push_back(&orthography);
+        }
+        return orthographies;
+    }
+
     // There are 3 spaces here. Space, non-breaking space, and narrow non-breaking space.
     static const SubstringsMatcher& Spaces{ { " ", " ", " " } };
 
@@ -167,33 +177,25 @@ namespace Locales {
             return input;
         }
 
-        std::vector<char> buffer;
-        buffer.reserve(input.length() + 10);
+        std::string output;
+        output.reserve(input.length() + 10);
 
         size_t inputIndex = 0;
-        std::string punctuation;
-        while (inputIndex < input.length())
-        {
-            size_t nextPunct = Punctuation.Find(input, inputIndex, &punctuation);
-            if (nextPunct == SubstringsMatcher::NO_MATCH)
-            {
-                // add rest of string
-                buffer.insert(buffer.end(), input.begin() + inputIndex, input.end());
-                break;
-            }
-            else
+        Punctuation.FindAll(input, [&](size_t nextPunct, size_t length, const std::string&)
             {
                 // add what was before this
-                buffer.insert(buffer.end(), input.begin() + inputIndex, input.begin() + nextPunct);
+                output.append(input, inputIndex, nextPunct - inputIndex);
 
                 // add space and then the punctuation
-                buffer.push_back(' ');
-                buffer.insert(buffer.end(), punctuation.begin(), punctuation.end());
-                inputIndex = nextPunct + punctuation.length();
-            }
-        }
+                output.push_back(' ');
+                output.append(input, nextPunct, length);
+                inputIndex = nextPunct + length;
+                return true;
+            });
 
-        return std::string(buffer.data(), buffer.size());
+        // add rest of string
+        output.append(input, inputIndex, std::string::npos);
+        return output;
     }
 
 }}}}}}
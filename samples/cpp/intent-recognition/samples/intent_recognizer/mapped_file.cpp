@@ -0,0 +1,128 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#include "stdafx.h"
+
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#undef min
+#undef max
+#endif
+
+#include <stdexcept>
+
+#include "mapped_file.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+#ifdef _MSC_VER
+
+CSpxMappedFile::CSpxMappedFile(const std::string& path)
+{
+    auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        SPX_TRACE_ERROR("CSpxMappedFile: cannot open %s", path.c_str());
+        throw std::runtime_error("CSpxMappedFile: cannot open " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("CSpxMappedFile: cannot get the size of " + path);
+    }
+
+    // A mapping of an empty file cannot be created, leave it without data.
+    if (size.QuadPart > 0)
+    {
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping != nullptr)
+        {
+            m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (m_data == nullptr)
+        {
+            if (m_mapping != nullptr)
+            {
+                CloseHandle(m_mapping);
+            }
+            CloseHandle(file);
+            throw std::runtime_error("CSpxMappedFile: cannot map " + path);
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+    }
+
+    // The mapping keeps the file open.
+    CloseHandle(file);
+}
+
+CSpxMappedFile::~CSpxMappedFile()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+    }
+}
+
+#else
+
+CSpxMappedFile::CSpxMappedFile(const std::string& path)
+{
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        SPX_TRACE_ERROR("CSpxMappedFile: cannot open %s", path.c_str());
+        throw std::runtime_error("CSpxMappedFile: cannot open " + path);
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0)
+    {
+        close(file);
+        throw std::runtime_error("CSpxMappedFile: cannot get the size of " + path);
+    }
+
+    // mmap fails for an empty file, leave it without data.
+    if (status.st_size > 0)
+    {
+        auto data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+        if (data == MAP_FAILED)
+        {
+            close(file);
+            throw std::runtime_error("CSpxMappedFile: cannot map " + path);
+        }
+        m_data = static_cast<const char*>(data);
+        m_size = static_cast<size_t>(status.st_size);
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(file);
+}
+
+CSpxMappedFile::~CSpxMappedFile()
+{
+    if (m_data != nullptr)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#endif
+
+}}}}}
@@ -0,0 +1,227 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <array>
+
+#include "pattern_matching_automaton.h"
+#include "pattern_matching_utils.h"
+#include "utf8_utils.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+void CSpxPatternMatchingAutomaton::Init(const OrthographyInformation& orthography)
+{
+    m_orthography = &orthography;
+    Clear();
+}
+
+void CSpxPatternMatchingAutomaton::Clear()
+{
+    m_nodes.clear();
+    m_nodes.emplace_back();
+    m_entries.clear();
+    m_entryNodes.clear();
+    m_intentEntries.clear();
+    m_removedEntries = 0;
+}
+
+uint32_t CSpxPatternMatchingAutomaton::PackCharacter(const char* input, size_t bytes)
+{
+    // A UTF8 character is at most 4 bytes and none of them is null, so the packed value is unique.
+    uint32_t packed = 0;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        packed |= static_cast<uint32_t>(static_cast<unsigned char>(input[i])) << (8 * i);
+    }
+    return packed;
+}
+
+uint32_t CSpxPatternMatchingAutomaton::GetOrAddChild(uint32_t node, uint32_t character, size_t bytes)
+{
+    auto& edges = m_nodes[node].Edges;
+    auto edge = std::lower_bound(edges.begin(), edges.end(), character, [](const Edge& e, uint32_t c) { return e.Character < c; });
+    if (edge != edges.end() && edge->Character == character)
+    {
+        return edge->Node;
+    }
+
+    auto child = static_cast<uint32_t>(m_nodes.size());
+    edges.insert(edge, Edge{ character, child });
+
+    // Note: edges may not be used after this point since adding a node can reallocate m_nodes.
+    auto bytesMatched = m_nodes[node].BytesMatched + static_cast<unsigned int>(bytes);
+    m_nodes.emplace_back();
+    m_nodes.back().BytesMatched = bytesMatched;
+    return child;
+}
+
+void CSpxPatternMatchingAutomaton::AddPatterns(const std::string& intentId, const std::shared_ptr<CSpxPatternMatchingIntent>& intent, size_t firstPattern)
+{
+    const auto& patterns = intent->GetPatterns();
+    for (size_t index = firstPattern; index < patterns.size(); index++)
+    {
+        const char* patternText = patterns[index].Pattern.c_str();
+        const char* patternLocation = patternText;
+        uint32_t node = 0;
+        PatternTransition transition = PatternTransition::Literal;
+
+        // This follows the literal branch of CSpxPatternMatchingModel::CheckPattern for the pattern side only. The
+        // input side is replayed in Match(), so both stop at exactly the same place.
+        while (true)
+        {
+            // 'S' is the word boundary anchor of the matching engine. Normalized patterns are lower case, but leave
+            // it to the engine if it ever shows up.
+            if (*patternLocation == 'S')
+            {
+                transition = PatternTransition::Literal;
+                break;
+            }
+
+            const char* nextLocation = patternLocation;
+            Utils::SkipPatternPunctuationAndWhitespace(nextLocation, *m_orthography);
+
+            if (*nextLocation == '\0')
+            {
+                transition = PatternTransition::End;
+                break;
+            }
+            if (*nextLocation == '{')
+            {
+                transition = PatternTransition::Entity;
+                break;
+            }
+            if (*nextLocation == '[')
+            {
+                transition = PatternTransition::Optional;
+                break;
+            }
+            if (*nextLocation == '(')
+            {
+                transition = PatternTransition::Required;
+                break;
+            }
+
+            std::array<char, 4> utf8Character = { 0 };
+            auto bytes = Utils::ExtractUtf8Character(nextLocation, utf8Character);
+            if (bytes == 0 || std::find(utf8Character.begin(), utf8Character.begin() + bytes, '\0') != utf8Character.begin() + bytes)
+            {
+                // Malformed UTF8, the engine deals with it.
+                transition = PatternTransition::Literal;
+                break;
+            }
+
+            node = GetOrAddChild(node, PackCharacter(utf8Character.data(), bytes), bytes);
+            patternLocation = nextLocation + bytes;
+        }
+
+        auto entry = static_cast<uint32_t>(m_entries.size());
+        m_nodes[node].Entries.push_back(entry);
+        m_entries.push_back({ intentId, intent, index, static_cast<size_t>(patternLocation - patternText), transition });
+        m_entryNodes.push_back(node);
+        m_intentEntries[intentId].push_back(entry);
+    }
+}
+
+void CSpxPatternMatchingAutomaton::RemovePatterns(const std::string& intentId)
+{
+    auto intentEntries = m_intentEntries.find(intentId);
+    if (intentEntries == m_intentEntries.end())
+    {
+        return;
+    }
+
+    for (auto entry : intentEntries->second)
+    {
+        auto& entries = m_nodes[m_entryNodes[entry]].Entries;
+        entries.erase(std::find(entries.begin(), entries.end(), entry));
+        m_entries[entry].Intent.reset();
+    }
+    m_removedEntries += intentEntries->second.size();
+    m_intentEntries.erase(intentEntries);
+
+    if (m_removedEntries > m_entries.size() - m_removedEntries)
+    {
+        Compact();
+    }
+}
+
+void CSpxPatternMatchingAutomaton::Compact()
+{
+    // Rebuild from the intents that are left, the nodes of removed patterns go away with it. Patterns appended to an
+    // intent later were added with a copy of it holding all of its patterns, so the last entry has them all.
+    std::vector<std::pair<std::string, std::shared_ptr<CSpxPatternMatchingIntent>>> intents;
+    for (const auto& intentEntries : m_intentEntries)
+    {
+        intents.emplace_back(intentEntries.first, m_entries[intentEntries.second.back()].Intent);
+    }
+
+    Clear();
+    for (const auto& intent : intents)
+    {
+        AddPatterns(intent.first, intent.second, 0);
+    }
+}
+
+void CSpxPatternMatchingAutomaton::Match(const char* input, std::vector<PatternAutomatonCandidate>& candidates) const
+{
+    const char* inputLocation = input;
+    uint32_t node = 0;
+
+    while (true)
+    {
+        const auto& current = m_nodes[node];
+        for (auto entry : current.Entries)
+        {
+            candidates.push_back({ &m_entries[entry], inputLocation, current.BytesMatched });
+        }
+
+        if (current.Edges.empty())
+        {
+            break;
+        }
+
+        const char* nextLocation = inputLocation;
+        Utils::SkipInputPunctuationAndWhitespace(nextLocation, *m_orthography);
+        if (*nextLocation == '\0')
+        {
+            break;
+        }
+
+        std::array<char, 4> utf8Character = { 0 };
+        auto bytes = Utils::ExtractUtf8Character(nextLocation, utf8Character);
+        if (bytes == 0 || std::find(utf8Character.begin(), utf8Character.begin() + bytes, '\0') != utf8Character.begin() + bytes)
+        {
+            break;
+        }
+
+        auto character = PackCharacter(utf8Character.data(), bytes);
+        auto edge = std::lower_bound(current.Edges.begin(), current.Edges.end(), character, [](const Edge& e, uint32_t c) { return e.Character < c; });
+        if (edge == current.Edges.end() || edge->Character != character)
+        {
+            break;
+        }
+
+        inputLocation = nextLocation + bytes;
+        node = edge->Node;
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const PatternAutomatonCandidate& one, const PatternAutomatonCandidate& two)
+        {
+            if (one.Entry->IntentId != two.Entry->IntentId)
+            {
+                return one.Entry->IntentId < two.Entry->IntentId;
+            }
+            return one.Entry->PatternIndex < two.Entry->PatternIndex;
+        });
+}
+
+}}}}}
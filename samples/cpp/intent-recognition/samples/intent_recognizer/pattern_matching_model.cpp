@@ -5,6 +5,7 @@
 
 #include "stdafx.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <memory>
 #include <regex>
@@ -14,6 +15,7 @@
 #include "intent_match_result.h"
 #include "list_entity.h"
 #include "pattern_any_entity.h"
+#include "pattern_matching_automaton.h"
 #include "pattern_matching_intent.h"
 #include "pattern_matching_model.h"
 #include "pattern_matching_utils.h"
@@ -64,7 +66,8 @@ std::shared_ptr<ISpxEntity> CSpxPatternMatchingFactory::CreateEntity(Intent::Ent
 
 void CSpxPatternMatchingFactory::AddEntity(const std::shared_ptr<ISpxEntity>& entity)
 {
-    m_model->m_entityMap[entity->GetName()] = entity;
+    std::unique_lock<std::mutex> lock(m_model->m_mutex);
+    m_model->InsertEntity(entity);
 }
 
 std::shared_ptr<CSpxPatternMatchingIntent> CSpxPatternMatchingFactory::CreateIntent() const
@@ -74,17 +77,8 @@ std::shared_ptr<CSpxPatternMatchingIntent> CSpxPatternMatchingFactory::CreateInt
 
 void CSpxPatternMatchingFactory::AddIntent(const std::shared_ptr<CSpxPatternMatchingIntent>& intent)
 {
-    // Let's use the completely intuitive and not at all confusing C++ insert method to do a
-    // "get or add" with one dictionary lookup
-    auto result = m_model->m_intentMap.insert(std::make_pair(intent->GetId(), intent));
-    bool wasAdded = result.second;
-    auto inMap = result.first->second;
-
-    if (!wasAdded)
-    {
-        // We already had an entry so let's add the phrases to that one
-        inMap->AddPatterns(intent->GetPatterns());
-    }
+    std::unique_lock<std::mutex> lock(m_model->m_mutex);
+    m_model->InsertIntent(intent, intent->GetId());
 }
 
 
@@ -92,6 +86,7 @@ CSpxPatternMatchingModel::CSpxPatternMatchingModel(const std::string& id) :
     m_id(id)
 {
     SPX_DBG_TRACE_FUNCTION();
+    m_automaton.Init(*m_orthography);
 }
 
 CSpxPatternMatchingModel::~CSpxPatternMatchingModel()
@@ -116,11 +111,105 @@ void CSpxPatternMatchingModel::Init(const std::string& language)
     }
 
     assert(m_orthography != nullptr);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // The automaton depends on the orthography, so recompile anything added before.
+    m_automaton.Init(*m_orthography);
+    for (auto& intent : m_intentMap)
+    {
+        m_automaton.AddPatterns(intent.first, intent.second, 0);
+    }
+    Invalidate(true);
 }
 
-std::vector<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::FindMatches(const std::string& phrase)
+std::shared_ptr<const CSpxPatternMatchingModel::Snapshot> CSpxPatternMatchingModel::GetSnapshot()
 {
+    auto snapshot = std::atomic_load(&m_snapshot);
+    if (snapshot != nullptr)
+    {
+        return snapshot;
+    }
+
+    // The model changed since the last snapshot was published. Snapshots are built lazily on the first match after
+    // a change, so loading a model one intent at a time does not copy it over and over again.
     std::unique_lock<std::mutex> lock(m_mutex);
+    snapshot = std::atomic_load(&m_snapshot);
+    if (snapshot == nullptr)
+    {
+        snapshot = PublishSnapshot();
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const CSpxPatternMatchingModel::Snapshot> CSpxPatternMatchingModel::PublishSnapshot()
+{
+    if (m_publishedAutomaton == nullptr)
+    {
+        m_publishedAutomaton = std::make_shared<CSpxPatternMatchingAutomaton>(m_automaton);
+    }
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->Intents = m_intentMap;
+    snapshot->Entities = m_entityMap;
+    snapshot->Automaton = m_publishedAutomaton;
+    std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>(snapshot));
+    return snapshot;
+}
+
+void CSpxPatternMatchingModel::InsertIntent(const std::shared_ptr<CSpxPatternMatchingIntent>& intent, const std::string& intentId)
+{
+    auto inMap = m_intentMap.find(intentId);
+    if (inMap == m_intentMap.end())
+    {
+        m_intentMap.emplace(intentId, intent);
+        m_automaton.AddPatterns(intentId, intent, 0);
+    }
+    else
+    {
+        // We already had an entry so let's add the patterns to that one. A published snapshot may still be using
+        // the intent, so append to a copy instead of the original.
+        auto merged = std::make_shared<CSpxPatternMatchingIntent>(*inMap->second);
+        auto firstPattern = merged->GetPatterns().size();
+        merged->AddPatterns(intent->GetPatterns());
+        inMap->second = merged;
+        m_automaton.AddPatterns(intentId, merged, firstPattern);
+    }
+    Invalidate(true);
+}
+
+void CSpxPatternMatchingModel::InsertEntity(const std::shared_ptr<ISpxEntity>& entity)
+{
+    // Note if an entity with the same name is added, it will be overridden.
+    m_entityMap[entity->GetName()] = entity;
+    Invalidate(false);
+}
+
+bool CSpxPatternMatchingModel::EraseIntent(const std::string& intentId)
+{
+    if (m_intentMap.erase(intentId) == 0)
+    {
+        return false;
+    }
+    m_automaton.RemovePatterns(intentId);
+    Invalidate(true);
+    return true;
+}
+
+void CSpxPatternMatchingModel::Invalidate(bool automatonChanged)
+{
+    if (automatonChanged)
+    {
+        m_publishedAutomaton.reset();
+    }
+
+    // Matches already running keep the snapshot they loaded, the next one picks up the change.
+    std::atomic_store(&m_snapshot, std::shared_ptr<const Snapshot>());
+}
+
+std::vector<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::FindMatches(const std::string& phrase)
+{
+    auto snapshot = GetSnapshot();
     std::vector<std::shared_ptr<CSpxIntentMatchResult>> intentResults;
 
     // Trim the string of sentence ending characters. This is necessary because SR might add characters to the utterance
@@ -135,26 +224,81 @@ std::vector<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::Fi
 
     Utils::TrimUTF8SentenceEndCharacters(trimmedPhrase, *m_orthography);
 
-    for (auto& intent : m_intentMap)
+    // Shared by all patterns, so the utterance is split into words once and each entity parses each span of it once.
+    CSpxUtteranceTokens tokens;
+    tokens.Init(trimmedPhrase.c_str(), *m_orthography);
+    EntityParseMemo parseMemo{ trimmedPhrase };
+
+    if (trimmedPhrase.empty())
+    {
+        // Nothing for the automaton to walk, only patterns made of punctuation can match. Check them the slow way.
+        for (auto& intent : snapshot->Intents)
+        {
+            for (auto& intentPattern : intent.second->GetPatterns())
+            {
+                // Create the reference for entityResults here so it can be used in all the recursive calls.
+                std::map<std::string, Impl::EntityResult> entityResults;
+                auto matchResult = CheckPattern(
+                    *snapshot,
+                    trimmedPhrase.c_str(),
+                    intentPattern.Pattern.c_str(),
+                    intentPattern,
+                    intent.first.c_str(),
+                    intent.second->GetPriority(),
+                    entityResults,
+                    tokens,
+                    parseMemo,
+                    0);
+                if (matchResult)
+                {
+                    // Add our match to the result set.
+                    intentResults.push_back(matchResult.Get());
+                }
+            }
+        }
+        return intentResults;
+    }
+
+    // Walk the literal prefixes of all patterns at once, then continue matching only the patterns whose prefix matched.
+    std::vector<PatternAutomatonCandidate> candidates;
+    snapshot->Automaton->Match(trimmedPhrase.c_str(), candidates);
+
+    for (auto& candidate : candidates)
     {
-        auto intentPatterns = intent.second->GetPatterns();
-        for (auto& intentPattern : intentPatterns)
+        const auto& entry = *candidate.Entry;
+        const auto& intentPattern = entry.Intent->GetPatterns()[entry.PatternIndex];
+
+        if (entry.Transition == PatternTransition::End)
         {
-            // Create the reference for entityResults here so it can be used in all the recursive calls.
-            std::map<std::string, Impl::EntityResult> entityResults;
-            auto matchResult = CheckPattern(
-                trimmedPhrase.c_str(),
-                intentPattern.Pattern.c_str(),
-                intentPattern,
-                intent.first.c_str(),
-                intent.second->GetPriority(),
-                entityResults,
-                0);
-            if (matchResult)
+            // Nothing but punctuation left in the pattern, so the rest of the input must be punctuation as well.
+            const char* inputLocation = candidate.InputLocation;
+            tokens.SkipPunctuationAndWhitespace(inputLocation);
+            if (tokens.GetCharacterBytes(inputLocation) == 0)
             {
-                // Add our match to the result set.
-                intentResults.push_back(matchResult.Get());
+                auto intentMatchResult = std::make_shared<CSpxIntentMatchResult>();
+                intentMatchResult->InitIntentMatchResult(entry.IntentId, intentPattern.Phrase, {}, entry.Intent->GetPriority(), candidate.BytesMatched);
+                intentResults.push_back(intentMatchResult);
             }
+            continue;
+        }
+
+        // Create the reference for entityResults here so it can be used in all the recursive calls.
+        std::map<std::string, Impl::EntityResult> entityResults;
+        auto matchResult = MatchPattern(
+            *snapshot,
+            candidate.InputLocation,
+            intentPattern.Pattern.c_str() + entry.PatternOffset,
+            intentPattern,
+            entry.IntentId.c_str(),
+            entry.Intent->GetPriority(),
+            entityResults,
+            tokens,
+            parseMemo,
+            candidate.BytesMatched);
+        if (matchResult)
+        {
+            // Add our match to the result set.
+            intentResults.push_back(matchResult.Get());
         }
     }
 
@@ -162,22 +306,19 @@ std::vector<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::Fi
 }
 
 Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPattern(
+    const Snapshot& snapshot,
     const char* input,
     const char* patternText,
     const IntentPattern& intentPattern,
     const char* intentId,
     unsigned int intentPriority,
     std::map<std::string, Impl::EntityResult>& entityResults,
-    unsigned int bytesPreviouslyMatched)
+    const CSpxUtteranceTokens& tokens,
+    EntityParseMemo& parseMemo,
+    unsigned int bytesPreviouslyMatched) const
 {
 
-    const char* inputLocation = input;
     const char* patternLocation = patternText;
-    bool requiredEntityPresent = true;
-    std::string entityValue = "";
-    unsigned int entityGreedLevel = 0;
-    unsigned int entityWords = 0;
-    unsigned int bytesMatched = bytesPreviouslyMatched;
 
     // Move past any pattern punctuation
     Utils::SkipPatternPunctuationAndWhitespace(patternLocation, *m_orthography);
@@ -188,7 +329,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
     {
         auto intentMatchResult = std::make_shared<CSpxIntentMatchResult>();
 
-        intentMatchResult->InitIntentMatchResult(intentId, intentPattern.Phrase, entityResults, intentPriority, bytesMatched);
+        intentMatchResult->InitIntentMatchResult(intentId, intentPattern.Phrase, entityResults, intentPriority, bytesPreviouslyMatched);
         return Maybe<std::shared_ptr<CSpxIntentMatchResult>>(intentMatchResult);
     }
 
@@ -199,6 +340,29 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
         return Maybe<std::shared_ptr<CSpxIntentMatchResult>>();
     }
 
+    return MatchPattern(snapshot, input, patternLocation, intentPattern, intentId, intentPriority, entityResults, tokens, parseMemo, bytesPreviouslyMatched);
+}
+
+Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::MatchPattern(
+    const Snapshot& snapshot,
+    const char* input,
+    const char* patternText,
+    const IntentPattern& intentPattern,
+    const char* intentId,
+    unsigned int intentPriority,
+    std::map<std::string, Impl::EntityResult>& entityResults,
+    const CSpxUtteranceTokens& tokens,
+    EntityParseMemo& parseMemo,
+    unsigned int bytesPreviouslyMatched) const
+{
+    const char* inputLocation = input;
+    const char* patternLocation = patternText;
+    bool requiredEntityPresent = true;
+    std::string entityValue = "";
+    unsigned int entityGreedLevel = 0;
+    unsigned int entityWords = 0;
+    unsigned int bytesMatched = bytesPreviouslyMatched;
+
     while ((inputLocation != nullptr && patternLocation != nullptr) &&
         (*inputLocation != '\0' || *patternLocation != '\0'))
     {
@@ -206,7 +370,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
         if (*patternLocation == 'S')
         {
             // This means the input needs a space or word boundary here.
-            if (!Utils::IsWordBoundary(inputLocation, *m_orthography))
+            if (!tokens.IsWordBoundary(inputLocation))
             {
                 break;
             }
@@ -220,7 +384,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
         }
 
         // Check if we should skip something in the baseInput.
-        Utils::SkipInputPunctuationAndWhitespace(inputLocation, *m_orthography);
+        tokens.SkipPunctuationAndWhitespace(inputLocation);
 
         // Check if we should skip something in the patternInput.
         Utils::SkipPatternPunctuationAndWhitespace(patternLocation, *m_orthography);
@@ -280,8 +444,8 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
 
             // Find the greed level for our entity.
             auto entityClassName = entityName.substr(0, entityName.find_first_of(":"));
-            auto entityInMap = m_entityMap.find(entityClassName);
-            if (entityInMap != m_entityMap.end())
+            auto entityInMap = snapshot.Entities.find(entityClassName);
+            if (entityInMap != snapshot.Entities.end())
             {
                 entityGreedLevel = entityInMap->second->GetGreed();
             }
@@ -290,18 +454,18 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                 entityGreedLevel = 0;
             }
 
-            std::string nextBasePhrase = "";
             // First make sure we skip whitespace before any next phrase.
             Utils::SkipPatternPunctuationAndWhitespace(patternLocation, *m_orthography);
 
             // Find out the next whole word from the base input.
+            const char* entityStart = inputLocation;
             const char* inputLocation2 = inputLocation;
-            nextBasePhrase = Utils::GrabNextWord(&inputLocation2, *m_orthography);
+            auto nextWordLength = tokens.GrabNextWord(&inputLocation2);
 
             // Grab at least one word for the entity.
             if (entityValue.empty())
             {
-                entityValue += nextBasePhrase;
+                entityValue.append(inputLocation2 - nextWordLength, nextWordLength);
                 entityWords++;
                 // Move inputLocation up.
                 inputLocation = inputLocation2;
@@ -310,7 +474,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                 if (*inputLocation == '\0')
                 {
                     // Store the entity result.
-                    StoreEntityResult(entityName, entityValue, entityResults, requiredEntityPresent);
+                    StoreEntityResult(snapshot, entityName, entityValue, entityStart, inputLocation, entityResults, parseMemo, requiredEntityPresent);
                     if (!requiredEntityPresent)
                     {
                         break;
@@ -361,12 +525,12 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                         // This is a no-op on the first pass but will ensure input doesn't get skipped when the number of words exceeds the greed.
                         inputLocation = inputLocation2;
 
-                        StoreEntityResult(entityName, entityValue, entityResults, requiredEntityPresent);
+                        StoreEntityResult(snapshot, entityName, entityValue, entityStart, inputLocation, entityResults, parseMemo, requiredEntityPresent);
 
                         if (requiredEntityPresent)
                         {
                             // If this was a valid entity check the rest of the pattern to make sure we didn't grab too many words.
-                            auto result = CheckPattern(inputLocation, patternLocation, intentPattern, intentId, intentPriority, entityResults, bytesMatched);
+                            auto result = CheckPattern(snapshot, inputLocation, patternLocation, intentPattern, intentId, intentPriority, entityResults, tokens, parseMemo, bytesMatched);
                             if (result)
                             {
                                 // Woah! It all worked out and we have a match!
@@ -375,7 +539,16 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                         }
                         else
                         {
-                            if (entityWords != entityGreedLevel)
+                            if (entityWords != entityGreedLevel && !entityInMap->second->MayStartWith(entityValue + m_orthography->WordBoundary.data()))
+                            {
+                                // No phrase continues with what we have so far, more words cannot make the entity valid.
+                                if (entityResults.find(entityName) != entityResults.end())
+                                {
+                                    entityResults.erase(entityName);
+                                }
+                                break;
+                            }
+                            else if (entityWords != entityGreedLevel)
                             {
                                 // This just means our entity may need more words. So let the loop go through again.
                                 requiredEntityPresent = true;
@@ -391,9 +564,10 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                             }
                         }
                         // Find out the next whole word from the base input.
-                        nextBasePhrase = Utils::GrabNextWord(&inputLocation2, *m_orthography);
+                        nextWordLength = tokens.GrabNextWord(&inputLocation2);
 
-                        entityValue += m_orthography->WordBoundary.data() + nextBasePhrase;
+                        entityValue += m_orthography->WordBoundary.data();
+                        entityValue.append(inputLocation2 - nextWordLength, nextWordLength);
                         entityWords++;
 
                         continue;
@@ -408,19 +582,29 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                 else if (entityGreedLevel == 0)
                 {
                     // We are greedy, grab as much as possible. But if our match fails, walk it back to make sure we didn't grab too much.
-                    while (*inputLocation != '\0')
+                    auto restLength = strlen(inputLocation);
+                    entityValue.append(inputLocation, restLength);
+                    inputLocation += restLength;
+
+                    // Spans ending at or past the limit can't be the entity, they are walked back without checking them.
+                    const char* spanLimit = nullptr;
+                    if (entityInMap != snapshot.Entities.end() && entityInMap->second->IsRequired())
                     {
-                        entityValue += *inputLocation++;
+                        spanLimit = parseMemo.FindSpanLimit(*entityInMap->second, inputLocation - entityValue.length());
                     }
 
                     // Can't use entityWords here since we grabbed everything and didn't count.
                     while (!entityValue.empty())
                     {
-                        StoreEntityResult(entityName, entityValue, entityResults, requiredEntityPresent);
-                        // No need to check requiredEntity here since we might have grabbed too much.
+                        Maybe<std::shared_ptr<CSpxIntentMatchResult>> result;
+                        if (spanLimit == nullptr || inputLocation < spanLimit)
+                        {
+                            StoreEntityResult(snapshot, entityName, entityValue, entityStart, inputLocation, entityResults, parseMemo, requiredEntityPresent);
+                            // No need to check requiredEntity here since we might have grabbed too much.
 
-                        // Check to see if the rest of the pattern matches.
-                        auto result = CheckPattern(inputLocation, patternLocation, intentPattern, intentId, intentPriority, entityResults, bytesMatched);
+                            // Check to see if the rest of the pattern matches.
+                            result = CheckPattern(snapshot, inputLocation, patternLocation, intentPattern, intentId, intentPriority, entityResults, tokens, parseMemo, bytesMatched);
+                        }
 
                         // Now check if everything is good.
                         if (result && entityResults.find(entityName) != entityResults.end() && requiredEntityPresent)
@@ -489,7 +673,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
                 {
                     newPattern = possiblePhrase + patternLocation;
                 }
-                auto result = CheckPattern(inputLocation, newPattern.c_str(), intentPattern, intentId, intentPriority, entityResults, bytesMatched);
+                auto result = CheckPattern(snapshot, inputLocation, newPattern.c_str(), intentPattern, intentId, intentPriority, entityResults, tokens, parseMemo, bytesMatched);
                 if (result)
                 {
                     // Woah! It all worked out and we have a match!
@@ -510,7 +694,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
             {
                 // Let's treat each possiblePhrase as a separate possible pattern.
                 std::string newPattern = possiblePhrase + patternLocation;
-                auto result = CheckPattern(inputLocation, newPattern.c_str(), intentPattern, intentId, intentPriority, entityResults, bytesMatched);
+                auto result = CheckPattern(snapshot, inputLocation, newPattern.c_str(), intentPattern, intentId, intentPriority, entityResults, tokens, parseMemo, bytesMatched);
                 if (result)
                 {
                     // Woah! It all worked out and we have a match!
@@ -528,10 +712,9 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
         }
 
         // Extract and compare the next character from each pointer
-        auto inputChar = Utils::GrabNextNonWhitespaceWord(inputLocation);
-        auto patternChar = Utils::GrabNextNonWhitespaceWord(patternLocation);
+        auto patternCount = Utils::GetBytesToNextCharacter(patternLocation);
 
-        if (inputChar != patternChar)
+        if (!tokens.IsCharacter(inputLocation, patternLocation, patternCount))
         {
             break;
         }
@@ -541,8 +724,7 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
         // a state where the next set of bytes are mis-identified as whitespace
         // for multi-byte char sets.
 
-        auto inputCount = Utils::GetBytesToNextCharacter(inputLocation);
-        auto patternCount = Utils::GetBytesToNextCharacter(patternLocation);
+        auto inputCount = tokens.GetCharacterBytes(inputLocation);
 
         // Ensure both representations have the same byte count
         // (handles edge cases with different Unicode representations)
@@ -562,12 +744,11 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
     }
 
     // Extract and compare the next character from each pointer
-    auto inputChar = Utils::GrabNextNonWhitespaceWord(inputLocation);
-    auto patternChar = Utils::GrabNextNonWhitespaceWord(patternLocation);
+    auto patternCount = Utils::GetBytesToNextCharacter(patternLocation);
 
     // If we are still matching good! Then this is a match!
     if ((inputLocation != nullptr && patternLocation != nullptr) &&
-        (inputChar == patternChar) && requiredEntityPresent)
+        tokens.IsCharacter(inputLocation, patternLocation, patternCount) && requiredEntityPresent)
     {
         auto intentMatchResult = std::make_shared<CSpxIntentMatchResult>();
 
@@ -588,15 +769,82 @@ Maybe<std::shared_ptr<CSpxIntentMatchResult>> CSpxPatternMatchingModel::CheckPat
     }
 }
 
-void CSpxPatternMatchingModel::StoreEntityResult(const std::string& entityName, std::string& entityValue, std::map<std::string, EntityResult>& entityResults, bool& requiredEntityPresent)
+const Maybe<std::string>& CSpxPatternMatchingModel::EntityParseMemo::Parse(const ISpxEntity& entity, const char* start, const char* end, const std::string& value)
+{
+    auto inserted = m_entries.emplace(std::make_tuple(&entity, start, end), Entry());
+    auto& entry = inserted.first->second;
+
+    // The value is built from the span the same way each time, except that trailing punctuation and whitespace can
+    // add a word boundary without moving the end. Parse again if that happened.
+    if (inserted.second || entry.Value != value)
+    {
+        entry.Value = value;
+        entry.Result = entity.Parse(value);
+    }
+    return entry.Result;
+}
+
+const char* CSpxPatternMatchingModel::EntityParseMemo::FindSpanLimit(const ISpxEntity& entity, const char* start)
+{
+    if (m_wordAt.empty())
+    {
+        m_wordAt.resize(m_utterance.length());
+        for (size_t i = 0; i < m_utterance.length(); i++)
+        {
+            if (m_utterance[i] == ' ')
+            {
+                m_wordAt[i] = m_words.size();
+                continue;
+            }
+            if (i == 0 || m_utterance[i - 1] == ' ')
+            {
+                m_words.push_back({ i, i });
+            }
+            m_words.back().End = i + 1;
+            m_wordAt[i] = m_words.size() - 1;
+        }
+    }
+
+    auto inserted = m_limits.emplace(&entity, std::vector<size_t>());
+    auto& limits = inserted.first->second;
+    if (inserted.second)
+    {
+        limits.resize(m_words.size() + 1, std::string::npos);
+        for (auto i = m_words.size(); i-- > 0;)
+        {
+            const auto& word = m_words[i];
+            limits[i] = entity.MayContainWord(m_utterance.substr(word.Start, word.End - word.Start))
+                ? limits[i + 1]
+                : word.End;
+        }
+    }
+
+    auto offset = static_cast<size_t>(start - m_utterance.c_str());
+    if (offset >= m_utterance.length() || m_wordAt[offset] == m_words.size())
+    {
+        return nullptr;
+    }
+
+    auto index = m_wordAt[offset];
+    const auto& word = m_words[index];
+    auto limit = limits[index];
+    if (offset > word.Start)
+    {
+        // The span starts in the middle of the word, what it has of the word is a word of its own.
+        limit = entity.MayContainWord(m_utterance.substr(offset, word.End - offset)) ? limits[index + 1] : word.End;
+    }
+    return limit == std::string::npos ? nullptr : m_utterance.c_str() + limit;
+}
+
+void CSpxPatternMatchingModel::StoreEntityResult(const Snapshot& snapshot, const std::string& entityName, std::string& entityValue, const char* entityStart, const char* entityEnd, std::map<std::string, EntityResult>& entityResults, EntityParseMemo& parseMemo, bool& requiredEntityPresent) const
 {
     // Find the entity in the entity map if it exists.
     auto entityClassName = entityName.substr(0, entityName.find_first_of(":"));
-    auto entityMapEntry = m_entityMap.find(entityClassName);
-    if (entityMapEntry != m_entityMap.end())
+    auto entityMapEntry = snapshot.Entities.find(entityClassName);
+    if (entityMapEntry != snapshot.Entities.end())
     {
         // Emplace the entities found inside the matchResults map. Use the entity Id from the intent trigger.
-        auto entity = entityMapEntry->second->Parse(entityValue);
+        const auto& entity = parseMemo.Parse(*entityMapEntry->second, entityStart, entityEnd, entityValue);
         if (entity)
         {
             entityResults[entityName] = { entity.Get(), entityMapEntry->second->GetType() };
@@ -617,7 +865,7 @@ void CSpxPatternMatchingModel::StoreEntityResult(const std::string& entityName,
     }
 }
 
-std::vector<std::string> CSpxPatternMatchingModel::ParseGroupedPhrases(const char** input)
+std::vector<std::string> CSpxPatternMatchingModel::ParseGroupedPhrases(const char** input) const
 {
     std::vector<std::string> phrases;
     std::string phrase = "";
@@ -678,15 +926,7 @@ void CSpxPatternMatchingModel::AddIntent(std::shared_ptr<CSpxPatternMatchingInte
     if (!intentId.empty())
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (m_intentMap.find(intentId) != m_intentMap.end())
-        {
-            // We need to append the patterns
-            m_intentMap[intentId]->AddPatterns(intent->GetPatterns());
-        }
-        else
-        {
-            m_intentMap[intentId] = intent;
-        }
+        InsertIntent(intent, intentId);
     }
     else
     {
@@ -698,8 +938,95 @@ void CSpxPatternMatchingModel::AddIntent(std::shared_ptr<CSpxPatternMatchingInte
 void CSpxPatternMatchingModel::AddEntity(std::shared_ptr<ISpxEntity> entity)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    // Note if an entity with the same name is added, it will be overridden.
-    m_entityMap[entity->GetName()] = entity;
+    InsertEntity(entity);
+}
+
+bool CSpxPatternMatchingModel::RemoveIntent(const std::string& intentId)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!EraseIntent(intentId))
+    {
+        return false;
+    }
+    PublishSnapshot();
+    return true;
+}
+
+void CSpxPatternMatchingModel::ReplaceIntent(std::shared_ptr<CSpxPatternMatchingIntent> intent, const std::string& intentId)
+{
+    if (!intent || intentId.empty())
+    {
+        SPX_TRACE_ERROR("ReplaceIntent called with invalid Intent or empty Intent ID", SPXERR_INVALID_ARG);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    EraseIntent(intentId);
+    InsertIntent(intent, intentId);
+    PublishSnapshot();
+}
+
+bool CSpxPatternMatchingModel::RemovePatterns(const std::string& intentId, const std::vector<std::string>& phrases)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto inMap = m_intentMap.find(intentId);
+    if (inMap == m_intentMap.end())
+    {
+        return false;
+    }
+
+    // Published snapshots may still use the intent, so the patterns that are left go into a new one.
+    const auto& intent = *inMap->second;
+    std::vector<IntentPattern> remaining;
+    for (const auto& pattern : intent.GetPatterns())
+    {
+        if (std::find(phrases.begin(), phrases.end(), pattern.Phrase) == phrases.end())
+        {
+            remaining.push_back(pattern);
+        }
+    }
+    if (remaining.size() == intent.GetPatterns().size())
+    {
+        return false;
+    }
+
+    auto updated = std::make_shared<CSpxPatternMatchingIntent>();
+    updated->Init(intent.GetId(), intent.GetPriority(), m_orthography->Name);
+    updated->AddPatterns(remaining);
+
+    EraseIntent(intentId);
+    InsertIntent(updated, intentId);
+    PublishSnapshot();
+    return true;
+}
+
+bool CSpxPatternMatchingModel::RemoveEntity(const std::string& name)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_entityMap.erase(name) == 0)
+    {
+        return false;
+    }
+    Invalidate(false);
+    PublishSnapshot();
+    return true;
+}
+
+bool CSpxPatternMatchingModel::UpdateListEntity(const std::string& name, const std::vector<std::string>& removed, const std::vector<std::string>& added)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto inMap = m_entityMap.find(name);
+    auto list = inMap != m_entityMap.end() ? std::dynamic_pointer_cast<CSpxListEntity>(inMap->second) : nullptr;
+    if (list == nullptr)
+    {
+        return false;
+    }
+
+    // Like intents, the list may be in use by published snapshots, the update goes into a copy of it.
+    inMap->second = list->Update(removed, added);
+    Invalidate(false);
+    PublishSnapshot();
+    return true;
 }
 
 const OrthographyInformation& CSpxPatternMatchingModel::GetOrthographyInfo() const
@@ -32,7 +32,7 @@ size_t TrimUTF8Whitespace(std::string& input, const OrthographyInformation& orth
                 return 0;
             }
             // If this utf8 character is in our locale whitespace, remove it and try again.
-            if (orthography.Whitespace.find(utf8Character.data(), 0, characterSize) != std::string::npos)
+            if (orthography.WhitespaceSet.Contains(utf8Character.data(), characterSize))
             {
                 input.erase(input.size() - characterSize, characterSize);
                 bytesRemoved += characterSize;
@@ -61,7 +61,7 @@ size_t TrimUTF8SentenceEndCharacters(std::string& input, const OrthographyInform
                 return 0;
             }
             // If this utf8 character is in our locale SentenceEndCharacters, remove it and try again.
-            if (orthography.SentenceEndCharacters.find(utf8Character.data(), 0, characterSize) != std::string::npos)
+            if (orthography.SentenceEndSet.Contains(utf8Character.data(), characterSize))
             {
                 input.erase(input.size() - characterSize, characterSize);
                 bytesRemoved += characterSize;
@@ -172,15 +172,15 @@ size_t RemoveLastToken(std::string& input, const OrthographyInformation& orthogr
 
 void SkipPatternPunctuationAndWhitespace(const char*& patternLocation, const OrthographyInformation& orthography)
 {
-    SkipPunctuationAndWhitespace(patternLocation, orthography.PatternPunctuation, orthography);
+    SkipPunctuationAndWhitespace(patternLocation, orthography.PatternPunctuationSet, orthography);
 }
 
 void SkipInputPunctuationAndWhitespace(const char*& inputLocation, const OrthographyInformation& orthography)
 {
-    SkipPunctuationAndWhitespace(inputLocation, orthography.InputPunctuation, orthography);
+    SkipPunctuationAndWhitespace(inputLocation, orthography.InputPunctuationSet, orthography);
 }
 
-void SkipPunctuationAndWhitespace(const char*& startLocation, const std::string& punctuation, const OrthographyInformation& orthography)
+void SkipPunctuationAndWhitespace(const char*& startLocation, const CharacterSet& punctuation, const OrthographyInformation& orthography)
 {
     while (startLocation != nullptr && *startLocation != '\0')
     {
@@ -191,8 +191,8 @@ void SkipPunctuationAndWhitespace(const char*& startLocation, const std::string&
             std::array<char, 4> multiByteCharacterArray = { 0,0,0,0 };
             auto byteCount = Utils::ExtractMultibyteUtf8Character(startLocation, multiByteCharacterArray);
 
-            if (punctuation.find(multiByteCharacterArray.data(), 0, byteCount) != std::string::npos ||
-                orthography.Whitespace.find(multiByteCharacterArray.data(), 0, byteCount) != std::string::npos)
+            if (punctuation.Contains(multiByteCharacterArray.data(), byteCount) ||
+                orthography.WhitespaceSet.Contains(multiByteCharacterArray.data(), byteCount))
             {
                 startLocation += byteCount;
                 continue;
@@ -205,8 +205,8 @@ void SkipPunctuationAndWhitespace(const char*& startLocation, const std::string&
         else
         {
             // Check if we should skip something in the patternInput.
-            if (punctuation.find(*startLocation) != std::string::npos ||
-                orthography.Whitespace.find(*startLocation) != std::string::npos)
+            if (punctuation.Contains(*startLocation) ||
+                orthography.WhitespaceSet.Contains(*startLocation))
             {
                 startLocation++;
                 continue;
@@ -221,8 +221,6 @@ void SkipPunctuationAndWhitespace(const char*& startLocation, const std::string&
 
 std::string GrabNextWhitespaceWord(const char** input, const OrthographyInformation& orthography)
 {
-    std::string nextWord = "";
-
     if (input == nullptr || *input == nullptr || **input == '\0') {
         return "";
     }
@@ -235,9 +233,9 @@ std::string GrabNextWhitespaceWord(const char** input, const OrthographyInformat
     }
 
     // Grab everything until we see whitespace again.
-    while (orthography.Whitespace.find(utf8Character.data(), 0, bytes) == std::string::npos)
+    const char* wordStart = *input;
+    while (!orthography.WhitespaceSet.Contains(utf8Character.data(), bytes))
     {
-        nextWord.append(utf8Character.data(), bytes);
         *input += bytes;
         if (**input == '\0')
         {
@@ -251,7 +249,7 @@ std::string GrabNextWhitespaceWord(const char** input, const OrthographyInformat
             break;
         }
     }
-    return nextWord;
+    return std::string(wordStart, *input - wordStart);
 }
 
 std::string GrabNextNonWhitespaceWord(const char** input)
@@ -47,6 +47,7 @@ namespace Impl {
             m_maxMatchLen = std::max(m_maxMatchLen, s.length());
             SubstringsMatcherBase::UpdateSearchTree(m_root, s, s, GetValue, UpdateValue);
         });
+        Freeze();
     }
 
     SubstringsMatcher::SubstringsMatcher(const std::initializer_list<std::string>& substrings)
@@ -56,6 +57,7 @@ namespace Impl {
             m_maxMatchLen = std::max(m_maxMatchLen, s.length());
             SubstringsMatcherBase::UpdateSearchTree(m_root, s, s, GetValue, UpdateValue);
         });
+        Freeze();
     }
 
 }}}}}
@@ -0,0 +1,89 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "thread_pool.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+CSpxThreadPool::CSpxThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+    {
+        // hardware_concurrency() may return 0 if it cannot tell.
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        m_threads.emplace_back(&CSpxThreadPool::WorkerLoop, this);
+    }
+}
+
+CSpxThreadPool::~CSpxThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+std::shared_ptr<CSpxThreadPool> CSpxThreadPool::Default()
+{
+    static auto pool = std::make_shared<CSpxThreadPool>();
+    return pool;
+}
+
+void CSpxThreadPool::Post(std::function<void()> work)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stopping)
+        {
+            throw std::runtime_error("CSpxThreadPool: the pool is shutting down");
+        }
+        m_queue.push_back(std::move(work));
+    }
+    m_workAvailable.notify_one();
+}
+
+void CSpxThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> work;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workAvailable.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+
+            // Drain the queue before stopping so no future is left without a value.
+            if (m_queue.empty())
+            {
+                return;
+            }
+            work = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        work();
+    }
+}
+
+}}}}}
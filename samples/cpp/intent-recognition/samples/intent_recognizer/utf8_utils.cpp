@@ -5,9 +5,15 @@
 
 #include "stdafx.h"
 
+#include <algorithm>
 #include <array>
 #include <string>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INTENT_UTF8_SSE2 1
+#endif
+
 #include "utf8_utils.h"
 
 namespace Microsoft {
@@ -16,20 +22,20 @@ namespace Standalone {
 namespace Intent {
 namespace Utils {
 
-size_t ExtractLastUtf8Character(std::string& input, std::array<char, 4>& utf8Character)
+size_t ExtractLastUtf8Character(const std::string& input, std::array<char, 4>& utf8Character)
 {
     int currentIndex = (int)input.size() - 1;
     auto done = false;
     while (!done && currentIndex >= 0)
     {
         // Check if this is ascii or the first byte of a multi-byte character.
-        if ((unsigned char)input.at(currentIndex) < 128 ||
-            (unsigned char)input.at(currentIndex) >= 192)
+        if ((unsigned char)input[currentIndex] < 128 ||
+            (unsigned char)input[currentIndex] >= 192)
         {
             done = true;
         }
         // Check if this is part of a multi-byte character.
-        else if ((unsigned char)input.at(currentIndex) >= 128 && (unsigned char)input.at(currentIndex) < 192)
+        else if ((unsigned char)input[currentIndex] >= 128 && (unsigned char)input[currentIndex] < 192)
         {
             currentIndex--;
         }
@@ -41,7 +47,8 @@ size_t ExtractLastUtf8Character(std::string& input, std::array<char, 4>& utf8Cha
         return 0;
     }
 
-    return ExtractUtf8Character(input.substr(currentIndex).c_str(), utf8Character);
+    // input is null terminated, so a truncated last character is caught the same as at the end of any string.
+    return ExtractUtf8Character(input.c_str() + currentIndex, utf8Character);
 }
 
 size_t ExtractUtf8Character(const char* input, std::array<char, 4>& utf8CharacterArray)
@@ -99,4 +106,177 @@ size_t ExtractMultibyteUtf8Character(const char* input, std::array<char, 4>& utf
     return byteCount;
 }
 
+size_t CountLeadingAscii(const char* input, size_t length)
+{
+    size_t count = 0;
+#if defined(INTENT_UTF8_SSE2)
+    // The top bit of each byte is set for all bytes of non-ASCII characters.
+    while (count + 16 <= length &&
+        _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + count))) == 0)
+    {
+        count += 16;
+    }
+#endif
+    while (count < length && (unsigned char)input[count] < 128)
+    {
+        count++;
+    }
+    return count;
+}
+
+bool IsWellFormedUtf8(const std::string& input)
+{
+    auto bytes = reinterpret_cast<const unsigned char*>(input.data());
+    auto length = input.length();
+    for (size_t i = CountLeadingAscii(input.data(), length); i < length;)
+    {
+        auto lead = bytes[i];
+        if (lead < 128)
+        {
+            i++;
+            continue;
+        }
+
+        // The second byte is limited for some leads, the others are any continuation byte.
+        size_t count;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            count = 2;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            count = 3;
+            low = lead == 0xE0 ? 0xA0 : low;
+            high = lead == 0xED ? 0x9F : high;
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            count = 4;
+            low = lead == 0xF0 ? 0x90 : low;
+            high = lead == 0xF4 ? 0x8F : high;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (i + count > length || bytes[i + 1] < low || bytes[i + 1] > high)
+        {
+            return false;
+        }
+        for (size_t j = 2; j < count; j++)
+        {
+            if ((bytes[i + j] & 0xC0) != 0x80)
+            {
+                return false;
+            }
+        }
+        i += count;
+    }
+    return true;
+}
+
+namespace {
+
+// The number of bytes of a well formed character starting with lead, 0 if lead can't start one.
+size_t WellFormedLength(unsigned char lead)
+{
+    if (lead < 128)
+    {
+        return 1;
+    }
+    else if (lead >= 192 && lead < 224)
+    {
+        return 2;
+    }
+    else if (lead >= 224 && lead < 240)
+    {
+        return 3;
+    }
+    else if (lead >= 240 && lead < 248)
+    {
+        return 4;
+    }
+    return 0;
+}
+
+bool IsWellFormed(const char* character, size_t bytes)
+{
+    if (WellFormedLength((unsigned char)character[0]) != bytes)
+    {
+        return false;
+    }
+    for (size_t i = 1; i < bytes; i++)
+    {
+        if (((unsigned char)character[i] & 192) != 128)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t Pack(const char* character, size_t bytes)
+{
+    uint32_t packed = 0;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        packed = (packed << 8) | (unsigned char)character[i];
+    }
+    return packed;
+}
+
+}
+
+CharacterSet::CharacterSet(const std::string& characters) : m_characters{ characters }
+{
+    // A single byte is found wherever it occurs, even inside a malformed character.
+    for (char c : characters)
+    {
+        auto byte = (unsigned char)c;
+        if (byte < 128)
+        {
+            m_ascii[byte / 64] |= uint64_t{ 1 } << (byte % 64);
+        }
+    }
+
+    for (size_t i = 0; i < characters.size();)
+    {
+        auto bytes = WellFormedLength((unsigned char)characters[i]);
+        if (bytes == 0 || i + bytes > characters.size() || !IsWellFormed(characters.c_str() + i, bytes))
+        {
+            // Characters could then be found across the boundaries of the ones in the string, leave it to find.
+            m_malformed = true;
+            m_multibyte.clear();
+            return;
+        }
+        if (bytes > 1)
+        {
+            m_multibyte.push_back(Pack(characters.c_str() + i, bytes));
+        }
+        i += bytes;
+    }
+
+    std::sort(m_multibyte.begin(), m_multibyte.end());
+    m_multibyte.erase(std::unique(m_multibyte.begin(), m_multibyte.end()), m_multibyte.end());
+}
+
+bool CharacterSet::Contains(const char* character, size_t bytes) const
+{
+    if (bytes == 1)
+    {
+        return Contains(*character);
+    }
+
+    // Searching for a well formed character in a well formed string only finds it where a character of the string
+    // starts, so the two sets have the same answer. Anything else, including no bytes at all, is left to find.
+    if (m_malformed || bytes == 0 || bytes > 4 || !IsWellFormed(character, bytes))
+    {
+        return m_characters.find(character, 0, bytes) != std::string::npos;
+    }
+    return std::binary_search(m_multibyte.begin(), m_multibyte.end(), Pack(character, bytes));
+}
+
 }}}}}
\ No newline at end of file
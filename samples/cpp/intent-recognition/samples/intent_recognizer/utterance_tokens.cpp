@@ -0,0 +1,171 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+
+#include "stdafx.h"
+
+#include <array>
+#include <limits>
+#include <string.h>
+
+#include "pattern_matching_utils.h"
+#include "utf8_utils.h"
+#include "utterance_tokens.h"
+
+namespace Microsoft {
+namespace SpeechSDK {
+namespace Standalone {
+namespace Intent {
+namespace Impl {
+
+void CSpxUtteranceTokens::Init(const char* utterance, const OrthographyInformation& orthography)
+{
+    m_utterance = utterance;
+    m_orthography = &orthography;
+    m_characters.clear();
+
+    auto length = strlen(utterance);
+    if (length >= std::numeric_limits<uint32_t>::max())
+    {
+        return;
+    }
+    m_characters.assign(length + 1, Character{ NotCharacter, false, 0, 0 });
+    m_characters[length] = Character{ 0, false, static_cast<uint32_t>(length), static_cast<uint32_t>(length) };
+
+    // Find where the characters start the way the Utils functions step through them.
+    std::array<char, 4> utf8Character = { 0,0,0,0 };
+    for (size_t i = 0; i < length;)
+    {
+        // Runs of ASCII are single byte characters, there is nothing to decode.
+        auto asciiEnd = i + Utils::CountLeadingAscii(utterance + i, length - i);
+        for (; i < asciiEnd; i++)
+        {
+            m_characters[i].Bytes = 1;
+            m_characters[i].WordBoundary = orthography.WordBoundary == std::array<char, 4>{ { utterance[i], 0, 0, 0 } };
+        }
+        if (i == length)
+        {
+            break;
+        }
+
+        auto bytes = Utils::ExtractUtf8Character(utterance + i, utf8Character);
+        if (bytes == 0 || i + bytes > length)
+        {
+            // Malformed, keep to the Utils functions for all of it.
+            m_characters.clear();
+            return;
+        }
+        m_characters[i].Bytes = static_cast<uint8_t>(bytes);
+        m_characters[i].WordBoundary = Utils::IsWordBoundary(utterance + i, orthography);
+        i += bytes;
+    }
+
+    // What follows a character decides where skipping and words stop, so fill those in from the end.
+    for (auto start = length; start-- > 0;)
+    {
+        auto& character = m_characters[start];
+        if (character.Bytes == NotCharacter)
+        {
+            continue;
+        }
+        const auto& next = m_characters[start + character.Bytes];
+
+        bool punctuation;
+        bool whitespace;
+        if (character.Bytes == 1)
+        {
+            punctuation = orthography.InputPunctuationSet.Contains(utterance[start]);
+            whitespace = orthography.WhitespaceSet.Contains(utterance[start]);
+        }
+        else
+        {
+            punctuation = orthography.InputPunctuationSet.Contains(utterance + start, character.Bytes);
+            whitespace = orthography.WhitespaceSet.Contains(utterance + start, character.Bytes);
+        }
+
+        character.SkipTo = (punctuation || whitespace) ? next.SkipTo : static_cast<uint32_t>(start);
+
+        // Without whitespace in the orthography every character is a word.
+        if (orthography.Whitespace.empty())
+        {
+            character.WordEnd = static_cast<uint32_t>(start + character.Bytes);
+        }
+        else
+        {
+            character.WordEnd = whitespace ? static_cast<uint32_t>(start) : next.WordEnd;
+        }
+    }
+}
+
+const CSpxUtteranceTokens::Character* CSpxUtteranceTokens::Find(const char* location) const
+{
+    if (location == nullptr || m_characters.empty())
+    {
+        return nullptr;
+    }
+
+    auto offset = static_cast<size_t>(location - m_utterance);
+    if (location < m_utterance || offset >= m_characters.size() || m_characters[offset].Bytes == NotCharacter)
+    {
+        return nullptr;
+    }
+    return &m_characters[offset];
+}
+
+void CSpxUtteranceTokens::SkipPunctuationAndWhitespace(const char*& location) const
+{
+    auto character = Find(location);
+    if (character == nullptr)
+    {
+        Utils::SkipInputPunctuationAndWhitespace(location, *m_orthography);
+        return;
+    }
+    location = m_utterance + character->SkipTo;
+}
+
+size_t CSpxUtteranceTokens::GrabNextWord(const char** location) const
+{
+    auto character = Find(*location);
+    if (character == nullptr)
+    {
+        return Utils::GrabNextWord(location, *m_orthography).length();
+    }
+
+    const auto& wordStart = m_characters[character->SkipTo];
+    *location = m_utterance + wordStart.WordEnd;
+    return wordStart.WordEnd - character->SkipTo;
+}
+
+bool CSpxUtteranceTokens::IsWordBoundary(const char* location) const
+{
+    auto character = Find(location);
+    if (character == nullptr)
+    {
+        return Utils::IsWordBoundary(location, *m_orthography);
+    }
+    return character->WordBoundary;
+}
+
+size_t CSpxUtteranceTokens::GetCharacterBytes(const char* location) const
+{
+    auto character = Find(location);
+    if (character == nullptr)
+    {
+        return Utils::GrabNextNonWhitespaceWord(location).length();
+    }
+    return character->Bytes;
+}
+
+bool CSpxUtteranceTokens::IsCharacter(const char* location, const char* character, size_t bytes) const
+{
+    auto found = Find(location);
+    if (found == nullptr)
+    {
+        auto value = Utils::GrabNextNonWhitespaceWord(location);
+        return value.length() == bytes && memcmp(value.data(), character, bytes) == 0;
+    }
+    return found->Bytes == bytes && memcmp(location, character, bytes) == 0;
+}
+
+}}}}}
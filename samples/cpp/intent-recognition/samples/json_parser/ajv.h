@@ -23,7 +23,9 @@
 #include <ajv/json_reader.h>
 #include <ajv/json_reader_view.h>
 #include <ajv/json_parser.h>
+#include <ajv/json_stream_reader.h>
 #include <ajv/json_builder.h>
+#include <ajv/json_stream_writer.h>
 
 #include <ajv/json.h>
 #include <ajv/json_tests.h>
@@ -28,6 +28,12 @@ namespace ajv {
 #define AJV_SMALL
 #endif
 
+// SSE2 is part of every x64 CPU, use it to scan string bodies and whitespace 16 bytes at a time. Other CPUs, or
+// builds defining AJV_NO_SIMD, scan one byte at a time.
+#if !defined(AJV_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define AJV_SSE2
+#endif
+
 #ifdef AJV_SMALL
 
 #ifdef AVJ_FN_NO_INLINE
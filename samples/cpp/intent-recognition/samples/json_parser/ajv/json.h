@@ -19,6 +19,8 @@ namespace ajv
         static AJV_FN_NO_INLINE_(JsonBuilder) Build(const char* psz) { return JsonBuilder::Build(psz); }
         static AJV_FN_NO_INLINE_(JsonBuilder) Build(const std::string& json) { return JsonBuilder::Build(json); }
         static AJV_FN_NO_INLINE_(JsonBuilder) Build(JsonKind kind) { return JsonBuilder(kind); }
+
+        static AJV_FN_NO_INLINE_(JsonStreamWriter) Write(std::string& json) { return JsonStreamWriter(json); }
     }
 }
 
@@ -128,6 +128,7 @@ namespace ajv {
 
             using JsonReader::AsString;
             using JsonReader::AsStringPtr;
+            using JsonReader::AsStringView;
 
             using JsonReader::AsBool;
 
@@ -240,6 +241,7 @@ namespace ajv {
         std::string AsString(bool decode, const char* defaultValue = "") const { return m_root.AsString(decode, defaultValue); }
         std::string AsString(const char* defaultValue = "") const { return m_root.AsString(defaultValue); }
         const char* AsStringPtr(size_t* size = nullptr) const { return m_root.AsStringPtr(size); }
+        const char* AsStringView(size_t* size, std::string& scratch) const { return m_root.AsStringView(size, scratch); }
 
         bool AsBool(bool defaultValue = false) const { return m_root.AsBool(defaultValue); }
 
@@ -573,6 +575,7 @@ namespace ajv {
 
     AJV_FN_NO_INLINE JsonBuilder::JsonBuilder() : JsonParser(), m_root(m_readerRoot, -1)
     {
+        m_memberIndexing = false;
     }
 
     AJV_FN_NO_INLINE JsonBuilder::JsonBuilder(JsonKind kind) : JsonBuilder()
@@ -589,6 +592,7 @@ namespace ajv {
 
     AJV_FN_NO_INLINE JsonBuilder::JsonBuilder(const char* psz) : JsonParser(psz), m_root(m_readerRoot, -1)
     {
+        m_memberIndexing = false;
     }
 
     AJV_FN_NO_INLINE JsonBuilder::~JsonBuilder()
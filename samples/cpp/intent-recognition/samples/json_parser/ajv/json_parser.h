@@ -73,6 +73,7 @@ namespace ajv {
 
         std::string AsString(const char* defaultValue = "") const { return m_readerRoot.AsString(defaultValue); }
         const char* AsStringPtr(size_t* size = nullptr) const { return m_readerRoot.AsStringPtr(size); }
+        const char* AsStringView(size_t* size, std::string& scratch) const { return m_readerRoot.AsStringView(size, scratch); }
 
         bool AsBool(bool defaultValue = false) const { return m_readerRoot.AsBool(defaultValue); }
         double AsNumber(double defaultValue = 0) const { return m_readerRoot.AsNumber(defaultValue); }
@@ -134,6 +135,7 @@ namespace ajv {
 
          m_itemAlloc = 0;
          m_items.resize(m_itemCountResize);
+         ResetMemberIndexes();
 
          m_readerRoot = InitRoot(other.AsJson().c_str());
          return *this;
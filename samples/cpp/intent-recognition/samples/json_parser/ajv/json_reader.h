@@ -78,6 +78,9 @@ namespace ajv {
         std::string AsString(bool decode, const char* defaultValue = "") const;
         const char* AsStringPtr(size_t* size = nullptr) const;
 
+        // the string as written when it has no escapes, otherwise decoded into scratch; either way valid while both are
+        const char* AsStringView(size_t* size, std::string& scratch) const;
+
         bool AsBool(bool defaultValue = false) const;
         double AsNumber(double defaultValue = 0) const;
         int64_t AsInt64(int64_t defaultValue = 0) const;
@@ -198,6 +201,15 @@ namespace ajv {
         return ptr;
     }
 
+    AJV_FN_NO_INLINE_(const char*) JsonReader::AsStringView(size_t* size, std::string& scratch) const
+    {
+        size_t cch = 0;
+        auto ptr = AsStringPtr(&cch);
+        if (ptr != nullptr) ptr = JsonString::Encoder::DecodeView(ptr, &cch, scratch);
+        if (size != nullptr) *size = ptr != nullptr ? cch : 0;
+        return ptr;
+    }
+
     AJV_FN_NO_INLINE_(bool) JsonReader::AsBool(bool defaultValue) const
     {
         auto value = false;
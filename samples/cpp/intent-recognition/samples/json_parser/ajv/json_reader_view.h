@@ -75,6 +75,7 @@ namespace ajv {
 
         std::string AsString(const char* defaultValue = "") const { return m_readerRoot.AsString(defaultValue); }
         const char* AsStringPtr(size_t* size = nullptr) const { return m_readerRoot.AsStringPtr(size); }
+        const char* AsStringView(size_t* size, std::string& scratch) const { return m_readerRoot.AsStringView(size, scratch); }
 
         bool AsBool(bool defaultValue = false) const { return m_readerRoot.AsBool(defaultValue); }
         double AsNumber(double defaultValue = 0) const { return m_readerRoot.AsNumber(defaultValue); }
@@ -0,0 +1,328 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+#ifndef __AJV_JSON_STREAM_READER_H
+#define __AJV_JSON_STREAM_READER_H
+
+#include <string>
+
+#include <ajv/common.h>
+#include <ajv/json_string.h>
+
+namespace ajv {
+
+    // Parses json that arrives in pieces, e.g. while it is read from a file or a socket. Each piece is passed to Feed()
+    // and names and values are reported to the Handler as soon as they are complete, so the document is never held in
+    // memory as a whole; only a name or value split across two pieces is copied. It accepts the same json as
+    // JsonView::Parse.
+    class JsonStreamReader : protected JsonString::Helpers
+    {
+    public:
+
+        class Handler
+        {
+        public:
+
+            virtual ~Handler() = default;
+
+            virtual void StartObject() {}
+            virtual void EndObject() {}
+            virtual void StartArray() {}
+            virtual void EndArray() {}
+
+            // names and strings are passed as written between their quotes, JsonString::Encoder::Decode unescapes them;
+            // numbers, booleans and null are passed as written
+            virtual void Name(const char* /* ptr */, size_t /* size */) {}
+            virtual void Value(JsonKind /* kind */, const char* /* ptr */, size_t /* size */) {}
+        };
+
+        explicit JsonStreamReader(Handler& handler) : m_handler(handler) {}
+
+        // returns false as soon as the json seen so far can't be valid
+        bool Feed(const char* ptr, size_t size);
+
+        // call after the last piece, returns true if it was a single valid json value
+        bool End();
+
+        bool IsOk() const { return m_state != State::Error; }
+        bool IsComplete() const { return m_state == State::Complete; }
+
+    private:
+
+        enum class State
+        {
+            BeforeValue, BeforeValueOrEndArray, BeforeName, BeforeNameOrEndObject, BeforeColon, AfterValue,
+            String, StringEscape, StringHexDigits, StringUtf8Continuation,
+            NumberMinus, NumberZero, NumberInteger, NumberFractionFirst, NumberFraction, NumberExponentSign, NumberExponentFirst, NumberExponent,
+            Literal,
+            Complete, Error
+        };
+
+        const char* StartValue(const char* ptr);
+        const char* Close(const char* ptr, char kind);
+        const char* Fail();
+
+        void StartToken(const char* ptr);
+        void EndToken(const char* end, JsonKind kind, bool isName);
+
+        static bool IsPlainStringChar(char ch) { return (unsigned char)ch >= ' ' && (unsigned char)ch < 0x80 && ch != '\"' && ch != '\\'; }
+        static bool IsNumberEnd(State state) { return state == State::NumberZero || state == State::NumberInteger || state == State::NumberFraction || state == State::NumberExponent; }
+
+        Handler& m_handler;
+        State m_state{ State::BeforeValue };
+
+        // open containers, '{' or '[', innermost last
+        std::string m_open;
+        static constexpr size_t m_maxOpenItems{ 1024 };
+
+        bool m_stringIsName{ false };
+        int m_remaining{ 0 };
+
+        const char* m_literal{ nullptr };
+
+        // the start of the current name or value in the current piece, and its text from earlier pieces
+        const char* m_tokenStart{ nullptr };
+        std::string m_token;
+    };
+
+    AJV_FN_NO_INLINE_(bool) JsonStreamReader::Feed(const char* ptr, size_t size)
+    {
+        auto end = ptr + size;
+        if (m_tokenStart != nullptr) m_tokenStart = ptr;
+
+        while (m_state != State::Error && ptr < end)
+        {
+            auto ch = *ptr;
+            switch (m_state)
+            {
+            case State::BeforeValue:
+            case State::BeforeValueOrEndArray:
+                if (IsWhiteSpace(ch)) { ptr++; break; }
+                ptr = m_state == State::BeforeValueOrEndArray && IsEndArray(ch)
+                    ? Close(ptr, '[')
+                    : StartValue(ptr);
+                break;
+
+            case State::BeforeName:
+            case State::BeforeNameOrEndObject:
+                if (IsWhiteSpace(ch)) { ptr++; break; }
+                if (m_state == State::BeforeNameOrEndObject && IsEndObject(ch)) { ptr = Close(ptr, '{'); break; }
+                if (!IsStartString(ch) || m_open.length() >= m_maxOpenItems) { ptr = Fail(); break; }
+                m_stringIsName = true;
+                m_state = State::String;
+                StartToken(++ptr);
+                break;
+
+            case State::BeforeColon:
+                if (IsWhiteSpace(ch)) { ptr++; break; }
+                if (ch != ':') { ptr = Fail(); break; }
+                m_state = State::BeforeValue;
+                ptr++;
+                break;
+
+            case State::AfterValue:
+                if (IsWhiteSpace(ch)) { ptr++; break; }
+                if (m_open.empty()) { ptr = Fail(); break; }
+                if (ch == ',')
+                {
+                    m_state = IsStartObject(m_open.back()) ? State::BeforeName : State::BeforeValue;
+                    ptr++;
+                    break;
+                }
+                ptr = IsEndArray(ch) ? Close(ptr, '[')
+                    : IsEndObject(ch) ? Close(ptr, '{')
+                    : Fail();
+                break;
+
+            case State::String:
+                while (ptr < end && IsPlainStringChar(*ptr)) ptr++;
+                if (ptr >= end) break;
+
+                ch = *ptr;
+                if (IsEndString(ch))
+                {
+                    EndToken(ptr, JsonKind::String, m_stringIsName);
+                    m_state = m_stringIsName ? State::BeforeColon : State::AfterValue;
+                    ptr++;
+                }
+                else if (ch == '\\')
+                {
+                    m_state = State::StringEscape;
+                    ptr++;
+                }
+                else if (IsCharEscape2Required(ch) || Utf8::IsInvalid(ch))
+                {
+                    ptr = Fail();
+                }
+                else
+                {
+                    // like JsonView, continuation bytes are skipped without looking at them
+                    m_remaining = Utf8::Is1Start(ch) ? 0 : Utf8::Is2Start(ch) ? 1 : Utf8::Is3Start(ch) ? 2 : 3;
+                    if (m_remaining > 0) m_state = State::StringUtf8Continuation;
+                    ptr++;
+                }
+                break;
+
+            case State::StringEscape:
+                if (ch == 'u') { m_state = State::StringHexDigits; m_remaining = 4; ptr++; break; }
+                if (!IsCharEscape2Char2(ch)) { ptr = Fail(); break; }
+                m_state = State::String;
+                ptr++;
+                break;
+
+            case State::StringHexDigits:
+                if (!IsHexDigit(ch)) { ptr = Fail(); break; }
+                if (--m_remaining == 0) m_state = State::String;
+                ptr++;
+                break;
+
+            case State::StringUtf8Continuation:
+                if (--m_remaining == 0) m_state = State::String;
+                ptr++;
+                break;
+
+            case State::NumberMinus:
+                m_state = ch == '0' ? State::NumberZero : IsDigit(ch) ? State::NumberInteger : State::Error;
+                ptr = m_state == State::Error ? Fail() : ptr + 1;
+                break;
+
+            case State::NumberZero:
+            case State::NumberInteger:
+            case State::NumberFraction:
+            case State::NumberExponent:
+                if (IsDigit(ch) && m_state != State::NumberZero) { ptr++; break; }
+                if (ch == '.' && m_state != State::NumberFraction && m_state != State::NumberExponent) { m_state = State::NumberFractionFirst; ptr++; break; }
+                if ((ch == 'e' || ch == 'E') && m_state != State::NumberExponent) { m_state = State::NumberExponentSign; ptr++; break; }
+
+                // the number ended before this character, which is looked at again after it
+                EndToken(ptr, JsonKind::Number, false);
+                m_state = State::AfterValue;
+                break;
+
+            case State::NumberFractionFirst:
+                m_state = IsDigit(ch) ? State::NumberFraction : State::Error;
+                ptr = m_state == State::Error ? Fail() : ptr + 1;
+                break;
+
+            case State::NumberExponentSign:
+                if (ch == '-' || ch == '+') { m_state = State::NumberExponentFirst; ptr++; break; }
+                // fall through
+            case State::NumberExponentFirst:
+                m_state = IsDigit(ch) ? State::NumberExponent : State::Error;
+                ptr = m_state == State::Error ? Fail() : ptr + 1;
+                break;
+
+            case State::Literal:
+                if (ch != m_literal[m_remaining]) { ptr = Fail(); break; }
+                ptr++;
+                if (m_literal[++m_remaining] == '\0')
+                {
+                    EndToken(ptr, m_literal[0] == 'n' ? JsonKind::Null : JsonKind::Boolean, false);
+                    m_state = State::AfterValue;
+                }
+                break;
+
+            case State::Complete:
+            case State::Error:
+                ptr = Fail();
+                break;
+            }
+        }
+
+        if (m_tokenStart != nullptr) m_token.append(m_tokenStart, end - m_tokenStart);
+        return IsOk();
+    }
+
+    AJV_FN_NO_INLINE_(bool) JsonStreamReader::End()
+    {
+        if (IsNumberEnd(m_state))
+        {
+            // the number's text was copied at the end of the last piece
+            EndToken(m_tokenStart, JsonKind::Number, false);
+            m_state = State::AfterValue;
+        }
+
+        auto complete = m_state == State::AfterValue && m_open.empty();
+        m_state = complete ? State::Complete : State::Error;
+        return complete;
+    }
+
+    AJV_FN_NO_INLINE_(const char*) JsonStreamReader::StartValue(const char* ptr)
+    {
+        if (m_open.length() >= m_maxOpenItems) return Fail();
+
+        auto ch = *ptr;
+        if (IsStartArray(ch) || IsStartObject(ch))
+        {
+            m_open += ch;
+            m_state = IsStartArray(ch) ? State::BeforeValueOrEndArray : State::BeforeNameOrEndObject;
+            if (IsStartArray(ch)) m_handler.StartArray(); else m_handler.StartObject();
+            return ptr + 1;
+        }
+        else if (IsStartString(ch))
+        {
+            m_stringIsName = false;
+            m_state = State::String;
+            StartToken(ptr + 1);
+            return ptr + 1;
+        }
+        else if (ch == 't' || ch == 'f' || ch == 'n')
+        {
+            m_literal = ch == 't' ? "true" : ch == 'f' ? "false" : "null";
+            m_remaining = 1;
+            m_state = State::Literal;
+            StartToken(ptr);
+            return ptr + 1;
+        }
+        else if (ch == '-' || IsDigit(ch))
+        {
+            m_state = ch == '-' ? State::NumberMinus : ch == '0' ? State::NumberZero : State::NumberInteger;
+            StartToken(ptr);
+            return ptr + 1;
+        }
+
+        return Fail();
+    }
+
+    AJV_FN_NO_INLINE_(const char*) JsonStreamReader::Close(const char* ptr, char kind)
+    {
+        if (m_open.empty() || m_open.back() != kind) return Fail();
+
+        m_open.pop_back();
+        m_state = State::AfterValue;
+        if (IsStartArray(kind)) m_handler.EndArray(); else m_handler.EndObject();
+        return ptr + 1;
+    }
+
+    AJV_FN_NO_INLINE_(const char*) JsonStreamReader::Fail()
+    {
+        m_state = State::Error;
+        m_tokenStart = nullptr;
+        return nullptr;
+    }
+
+    AJV_FN_NO_INLINE_(void) JsonStreamReader::StartToken(const char* ptr)
+    {
+        m_tokenStart = ptr;
+        m_token.clear();
+    }
+
+    AJV_FN_NO_INLINE_(void) JsonStreamReader::EndToken(const char* end, JsonKind kind, bool isName)
+    {
+        // tokens that started in an earlier piece were copied, add the rest of them
+        const char* ptr = m_tokenStart;
+        auto size = (size_t)(end - m_tokenStart);
+        if (!m_token.empty())
+        {
+            m_token.append(m_tokenStart, size);
+            ptr = m_token.c_str();
+            size = m_token.length();
+        }
+
+        if (isName) m_handler.Name(ptr, size); else m_handler.Value(kind, ptr, size);
+        m_tokenStart = nullptr;
+    }
+}
+
+#endif // __AJV_JSON_STREAM_READER_H
@@ -0,0 +1,190 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+#ifndef __AJV_JSON_STREAM_WRITER_H
+#define __AJV_JSON_STREAM_WRITER_H
+
+#include <stdio.h>
+#include <string>
+#include <type_traits>
+
+#include <ajv/common.h>
+#include <ajv/json_string.h>
+
+namespace ajv {
+
+    // Appends json text to the caller's string as names and values are written, front to back. Unlike JsonBuilder
+    // there is no item tree to render afterwards and values are encoded straight into the string, so writing into a
+    // string with enough capacity doesn't allocate at all. Members can't be revisited, skipped or reordered.
+    class JsonStreamWriter : protected JsonString::Helpers
+    {
+    public:
+
+        explicit JsonStreamWriter(std::string& json) : m_json(json) {}
+
+        JsonStreamWriter& StartObject() { return Open('{'); }
+        JsonStreamWriter& EndObject() { return Close('{', '}'); }
+
+        JsonStreamWriter& StartArray() { return Open('['); }
+        JsonStreamWriter& EndArray() { return Close('[', ']'); }
+
+        JsonStreamWriter& Name(const char* name) { return Name(name, strlen(name)); }
+        JsonStreamWriter& Name(const std::string& name) { return Name(name.c_str(), name.length()); }
+        JsonStreamWriter& Name(const char* name, size_t cch);
+
+        JsonStreamWriter& Value(const char* value) { return Value(value, strlen(value)); }
+        JsonStreamWriter& Value(const std::string& value) { return Value(value.c_str(), value.length()); }
+        JsonStreamWriter& Value(const char* value, size_t cch);
+
+        JsonStreamWriter& Value(bool value) { return Json(value ? "true" : "false", value ? 4 : 5); }
+        JsonStreamWriter& Value(std::nullptr_t) { return Json("null", 4); }
+
+        // numbers are formatted like std::to_string, the same text JsonBuilder writes for them
+        template<class T>
+        typename std::enable_if<std::is_arithmetic<T>::value, JsonStreamWriter&>::type Value(T value);
+
+        // appends a value that is already json text
+        JsonStreamWriter& Json(const char* json, size_t cch);
+
+        // false once something was written out of order (e.g. a value without a name in an object)
+        bool IsOk() const { return !m_error; }
+
+        // true when a single top level value was written and everything opened was closed
+        bool IsComplete() const { return !m_error && m_depth == 0 && m_hasValue[0]; }
+
+    private:
+
+        bool StartValue();
+        JsonStreamWriter& Open(char kind);
+        JsonStreamWriter& Close(char kind, char end);
+        void AppendQuoted(const char* ptr, size_t cch);
+
+        std::string& m_json;
+
+        static constexpr int m_maxDepth{ 64 };
+        char m_open[m_maxDepth + 1] = {};
+        bool m_hasValue[m_maxDepth + 1] = {};
+        int m_depth{ 0 };
+
+        bool m_afterName{ false };
+        bool m_error{ false };
+    };
+
+    AJV_FN_NO_INLINE_(JsonStreamWriter&) JsonStreamWriter::Name(const char* name, size_t cch)
+    {
+        if (m_error) return *this;
+
+        // names are only valid in objects, and only where a value isn't expected
+        if (m_depth == 0 || m_open[m_depth] != '{' || m_afterName)
+        {
+            m_error = true;
+            return *this;
+        }
+
+        if (m_hasValue[m_depth]) m_json += ',';
+        m_hasValue[m_depth] = true;
+
+        AppendQuoted(name, cch);
+        m_json += ':';
+        m_afterName = true;
+
+        return *this;
+    }
+
+    AJV_FN_NO_INLINE_(JsonStreamWriter&) JsonStreamWriter::Value(const char* value, size_t cch)
+    {
+        if (StartValue()) AppendQuoted(value, cch);
+        return *this;
+    }
+
+    template<class T>
+    typename std::enable_if<std::is_arithmetic<T>::value, JsonStreamWriter&>::type JsonStreamWriter::Value(T value)
+    {
+        char buffer[64];
+        auto cch = std::is_floating_point<T>::value ? snprintf(buffer, sizeof(buffer), "%f", (double)value)
+            : std::is_signed<T>::value ? snprintf(buffer, sizeof(buffer), "%lld", (long long)value)
+            : snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)value);
+        return Json(buffer, cch > 0 ? (size_t)cch : 0);
+    }
+
+    AJV_FN_NO_INLINE_(JsonStreamWriter&) JsonStreamWriter::Json(const char* json, size_t cch)
+    {
+        if (StartValue()) m_json.append(json, cch);
+        return *this;
+    }
+
+    AJV_FN_NO_INLINE_(bool) JsonStreamWriter::StartValue()
+    {
+        if (m_error) return false;
+
+        if (m_depth == 0)
+        {
+            // only one top level value
+            m_error = m_hasValue[0];
+            m_hasValue[0] = true;
+        }
+        else if (m_open[m_depth] == '{')
+        {
+            // object members need their name first
+            m_error = !m_afterName;
+            m_afterName = false;
+        }
+        else
+        {
+            if (m_hasValue[m_depth]) m_json += ',';
+            m_hasValue[m_depth] = true;
+        }
+
+        return !m_error;
+    }
+
+    AJV_FN_NO_INLINE_(JsonStreamWriter&) JsonStreamWriter::Open(char kind)
+    {
+        if (!StartValue()) return *this;
+
+        if (m_depth == m_maxDepth)
+        {
+            m_error = true;
+            return *this;
+        }
+
+        m_json += kind;
+        m_depth++;
+        m_open[m_depth] = kind;
+        m_hasValue[m_depth] = false;
+
+        return *this;
+    }
+
+    AJV_FN_NO_INLINE_(JsonStreamWriter&) JsonStreamWriter::Close(char kind, char end)
+    {
+        if (m_error) return *this;
+
+        if (m_depth == 0 || m_open[m_depth] != kind || m_afterName)
+        {
+            m_error = true;
+            return *this;
+        }
+
+        m_json += end;
+        m_depth--;
+
+        return *this;
+    }
+
+    AJV_FN_NO_INLINE_(void) JsonStreamWriter::AppendQuoted(const char* ptr, size_t cch)
+    {
+        // encode in place, behind the opening quote
+        auto start = m_json.length();
+        auto encodedSize = JsonString::Encoder::EncodedSize(ptr, cch);
+        m_json.resize(start + 1 + encodedSize);
+        m_json[start] = '\"';
+
+        auto cchEncoded = JsonString::Encoder::Encode(ptr, cch, &m_json[start + 1], encodedSize);
+        m_json.resize(start + 1 + cchEncoded);
+        m_json += '\"';
+    }
+}
+
+#endif // __AJV_JSON_STREAM_WRITER_H
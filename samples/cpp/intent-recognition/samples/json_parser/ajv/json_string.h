@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <string.h>
 #include <ajv/common.h>
 
 namespace ajv {
@@ -170,11 +171,21 @@ namespace ajv {
                     return std::string(buffer.get(), Decode(ptr, size, buffer.get(), size));
                 }
 
+                static AJV_FN_NO_INLINE_(const char*) DecodeView(const char* ptr, size_t* size, std::string& scratch)
+                {
+                    // if decoding isn't needed, the string is used where it is
+                    if (!JsonString::Encoder::Encoded(ptr, *size)) return ptr;
+
+                    // decoded strings are never longer, so decode straight into the caller's scratch string
+                    scratch.resize(*size);
+                    *size = Decode(ptr, *size, &scratch[0], *size);
+                    scratch.resize(*size);
+                    return scratch.c_str();
+                }
+
                 static bool IsEscaped(const char* ptr, size_t cch)
                 {
-                    auto end = ptr + cch;
-                    while (ptr < end && *ptr != '\\') ptr++;
-                    return ptr < end;
+                    return cch > 0 && memchr(ptr, '\\', cch) != nullptr;
                 }
 
                 static bool IsInvalid(unsigned char ch) { return ch == 0 || (ch >= 0x80 && ch <= 0xbf) || ch >= 0xf5; }
@@ -381,6 +392,9 @@ namespace ajv {
 
             static std::string Decode(const char* src, size_t srcSize) { return Utf8::Decode(src, srcSize); }
             static size_t Decode(const char* src, size_t srcSize, char* dest, size_t destSize) { return Utf8::Decode(src, srcSize, dest, destSize); }
+
+            // returns src when it has no escapes, otherwise decodes it into scratch and returns that; *size is updated
+            static const char* DecodeView(const char* src, size_t* size, std::string& scratch) { return Utf8::DecodeView(src, size, scratch); }
         };
     };
 }
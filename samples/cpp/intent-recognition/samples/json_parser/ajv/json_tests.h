@@ -1731,6 +1731,201 @@ TEST_CASE("ajv::JsonParser... object basics", "[ajv][basics][parser][object]") {
         REQUIRE(strncmp(buyerName.AsStringPtr(&size), "your name", size) == 0);
         REQUIRE(strncmp(sellerName.AsStringPtr(&size), "rob", size) == 0);
     }
+
+    SECTION("object with many members")
+    {
+        // wide objects are looked up through a hash index of their names, it must find what the linear search finds
+        std::string json = "{";
+        for (int i = 0; i < 100; i++)
+        {
+            json += "\"name" + std::to_string(i) + "\":" + std::to_string(i) + ",";
+        }
+        json += "\"name50\":-1, \"nam\\u0065\":-2}";
+
+        auto parsed = ajv::JsonParser::Parse(json);
+        REQUIRE(parsed.IsOk());
+        REQUIRE(parsed.ValueCount() == 102);
+
+        for (int i = 99; i >= 0; i--)
+        {
+            auto name = "name" + std::to_string(i);
+            REQUIRE(parsed[name].AsInt() == i); // duplicates resolve to the first one
+        }
+        REQUIRE(parsed["nam\\u0065"].AsInt() == -2); // names are compared as they are written
+        REQUIRE(parsed["name100"].IsEmpty());
+        REQUIRE(parsed["name"].IsEmpty());
+        REQUIRE(parsed["name10"].AsInt() == 10);
+
+        auto moved = std::move(parsed);
+        REQUIRE(moved["name99"].AsInt() == 99);
+
+        auto copied = moved;
+        REQUIRE(copied["name98"].AsInt() == 98);
+
+        auto builder = ajv::json::Build(json);
+        auto writer = builder.Writer();
+        REQUIRE(builder["name99"].AsInt() == 99);
+        writer["name100"] = 100;
+        REQUIRE(builder["name100"].AsInt() == 100); // builders change objects after lookups
+    }
+
+    SECTION("string views")
+    {
+        auto json = "{\"plain\":\"rob\", \"escaped\":\"r\\u00f6b\\n\", \"empty\":\"\", \"number\":1}";
+
+        auto parsed = ajv::JsonParser::Parse(json, strlen(json));
+        REQUIRE(parsed.IsOk());
+
+        std::string scratch;
+        size_t size = 0;
+        auto plain = parsed["plain"].AsStringView(&size, scratch); // strings without escapes point into the original
+        REQUIRE(plain == parsed["plain"].AsStringPtr());
+        REQUIRE(std::string(plain, size) == "rob");
+        REQUIRE(scratch.empty());
+
+        auto escaped = parsed["escaped"].AsStringView(&size, scratch); // others are decoded into the scratch string
+        REQUIRE(escaped == scratch.c_str());
+        REQUIRE(std::string(escaped, size) == "r\xc3\xb6" "b\n");
+        REQUIRE(std::string(escaped, size) == parsed["escaped"].AsString());
+
+        REQUIRE(parsed["empty"].AsStringView(&size, scratch) != nullptr);
+        REQUIRE(size == 0);
+        REQUIRE(parsed["number"].AsStringView(&size, scratch) == nullptr);
+        REQUIRE(size == 0);
+        REQUIRE(parsed["missing"].AsStringView(&size, scratch) == nullptr);
+
+        auto name = parsed.NameAt(1).AsStringView(&size, scratch);
+        REQUIRE(std::string(name, size) == "escaped");
+
+        auto builder = ajv::json::Build(json);
+        escaped = builder["escaped"].AsStringView(&size, scratch);
+        REQUIRE(std::string(escaped, size) == "r\xc3\xb6" "b\n");
+        plain = builder.Writer()["plain"].AsStringView(&size, scratch);
+        REQUIRE(std::string(plain, size) == "rob");
+    }
+}
+
+TEST_CASE("ajv::JsonStreamWriter... basics", "[ajv][basics][writer]") {
+
+    SECTION("same json as JsonBuilder")
+    {
+        auto builder = ajv::json::Build();
+        builder[0]["id"] = "quote \" backslash \\ tab \t unicode \xc3\xa9";
+        builder[0]["count"] = 42;
+        builder[0]["negative"] = -7;
+        builder[0]["ratio"] = 0.5;
+        builder[0]["empty"] = "";
+        builder[0]["list"][0] = true;
+        builder[0]["list"][1] = nullptr;
+        builder[0]["na\"me"]["inner"] = "value";
+        builder[1] = "second";
+
+        std::string json;
+        auto writer = ajv::json::Write(json);
+        writer.StartArray();
+        writer.StartObject();
+        writer.Name("id").Value("quote \" backslash \\ tab \t unicode \xc3\xa9");
+        writer.Name("count").Value(42);
+        writer.Name("negative").Value(-7);
+        writer.Name("ratio").Value(0.5);
+        writer.Name("empty").Value("");
+        writer.Name("list").StartArray().Value(true).Value(nullptr).EndArray();
+        writer.Name("na\"me").StartObject().Name("inner").Value(std::string("value")).EndObject();
+        writer.EndObject();
+        writer.Value("second");
+        writer.EndArray();
+
+        REQUIRE(writer.IsComplete());
+        REQUIRE(json == builder.AsJson());
+        REQUIRE(ajv::json::Parse(json)[0]["na\\\"me"]["inner"].AsString() == "value");
+    }
+
+    SECTION("appends to the caller's string")
+    {
+        std::string json = "prefix:";
+        json.reserve(64);
+        auto data = json.data();
+
+        auto writer = ajv::json::Write(json);
+        writer.StartObject().Name("a").Value(1u).EndObject();
+
+        REQUIRE(writer.IsComplete());
+        REQUIRE(json == "prefix:{\"a\":1}");
+        REQUIRE(json.data() == data); // wrote in place
+    }
+
+    SECTION("out of order")
+    {
+        std::string json;
+        REQUIRE(!ajv::json::Write(json).StartObject().Value(1).IsOk()); // value without a name
+        REQUIRE(!ajv::json::Write(json).StartArray().Name("a").IsOk()); // name in an array
+        REQUIRE(!ajv::json::Write(json).StartObject().Name("a").EndObject().IsOk()); // name without a value
+        REQUIRE(!ajv::json::Write(json).StartArray().EndObject().IsOk()); // mismatched end
+        REQUIRE(!ajv::json::Write(json).Value(1).Value(2).IsOk()); // two top level values
+        REQUIRE(!ajv::json::Write(json).StartArray().IsComplete()); // still open
+    }
+}
+
+TEST_CASE("ajv::JsonStreamReader... basics", "[ajv][basics][stream]") {
+
+    // writes the events back as json, so they can be compared with what JsonBuilder renders from a JsonView
+    class Rewriter : public ajv::JsonStreamReader::Handler
+    {
+    public:
+        std::string json;
+        void StartObject() override { Separate(); json += '{'; m_first = true; }
+        void EndObject() override { json += '}'; m_first = false; }
+        void StartArray() override { Separate(); json += '['; m_first = true; }
+        void EndArray() override { json += ']'; m_first = false; }
+        void Name(const char* ptr, size_t size) override { Separate(); json += '\"'; json.append(ptr, size); json += "\":"; m_first = true; }
+        void Value(ajv::JsonKind kind, const char* ptr, size_t size) override
+        {
+            Separate();
+            if (kind == ajv::JsonKind::String) json += '\"';
+            json.append(ptr, size);
+            if (kind == ajv::JsonKind::String) json += '\"';
+        }
+    private:
+        void Separate() { if (!m_first && !json.empty()) json += ','; m_first = false; }
+        bool m_first{ true };
+    };
+
+    SECTION("same values as JsonView, however the json is split")
+    {
+        for (auto check : { "{ \"name\" : \"rob\", \"list\": [1, -2.5e+3, true, false, null, [], {}], \"esc\\u00e9\": \"\\\"\\n\\ud83d\\ude00\xc3\xa9\" }",
+            "[\"a\",[\"b\",[\"c\"]],{\"d\":{\"e\":0}}]", "\"string\"", " 0 ", "-0.5", "true", "null" })
+        {
+            auto expected = ajv::json::Build(check).AsJson();
+            for (size_t pieceSize = 1; pieceSize <= strlen(check); pieceSize++)
+            {
+                Rewriter rewriter;
+                ajv::JsonStreamReader reader(rewriter);
+                for (size_t at = 0; at < strlen(check); at += pieceSize)
+                {
+                    REQUIRE(reader.Feed(check + at, std::min(pieceSize, strlen(check) - at)));
+                }
+                CAPTURE(check, pieceSize);
+                REQUIRE(reader.End());
+                REQUIRE(rewriter.json == expected);
+            }
+        }
+    }
+
+    SECTION("rejects what JsonView rejects")
+    {
+        for (auto check : { "", " ", "{", "[1,]", "{\"a\":1,}", "{\"a\" 1}", "{1:2}", "01", "-", "1.", "1e", "+1", "tru", "nul",
+            "\"\\x\"", "\"\\u12g4\"", "\"\xff\"", "\"\t\"", "[1 2]", "{} {}", "[}", "\"open" })
+        {
+            ajv::JsonView view;
+            REQUIRE(view.Parse(check, strlen(check)) <= 0);
+
+            ajv::JsonStreamReader::Handler ignore;
+            ajv::JsonStreamReader reader(ignore);
+            for (auto ptr = check; *ptr != '\0'; ptr++) reader.Feed(ptr, 1);
+            CAPTURE(check);
+            REQUIRE(!reader.End());
+        }
+    }
 }
 
 #endif
@@ -5,9 +5,18 @@
 #ifndef __AJV_JSON_VIEW_H
 #define __AJV_JSON_VIEW_H
 
+#include <mutex>
 #include <stdlib.h>
+#include <unordered_map>
 #include <vector>
 
+#ifdef AJV_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
 #include <ajv/common.h>
 #include <ajv/json_string.h>
 
@@ -53,7 +62,13 @@ namespace ajv {
 
         int InitItemUnspecified();
 
+        int FindIndexedName(int object, const char* find, size_t len) const;
+        std::vector<int> BuildMemberIndex(int object) const;
+        static size_t HashName(const char* name, size_t len);
+        void ResetMemberIndexes();
+
         static const char* SkipWhiteSpace(const char* psz, const char* zend);
+        static const char* SkipPlainStringChars(const char* psz, const char* zend);
         static const char* SkipCharsInRange(const char* psz, const char* zend, char ch1, char ch2);
         const char* ParseElement(const char* psz, const char* zend);
         const char* ParseValue(const char* psz, const char* zend);
@@ -98,6 +113,13 @@ namespace ajv {
 
         static constexpr int m_maxOpenItems{ 1024 };
         int m_openItems{ 0 };
+
+        // Objects with more members than this get a hash index of their names on the first lookup that gets past
+        // them. Builders change objects after parsing, so they turn it off.
+        static constexpr int m_memberIndexThreshold{ 16 };
+        bool m_memberIndexing{ true };
+        mutable std::unordered_map<int, std::vector<int>> m_memberIndexes;
+        mutable std::mutex m_memberIndexLock;
     };
 
     AJV_FN_NO_INLINE JsonView::JsonView()
@@ -111,7 +133,8 @@ namespace ajv {
 
     AJV_FN_NO_INLINE JsonView::JsonView(const JsonView& other) :
         m_items(other.m_items),
-        m_itemCount(other.m_itemCount)
+        m_itemCount(other.m_itemCount),
+        m_memberIndexing(other.m_memberIndexing)
     {
     }
     
@@ -119,21 +142,28 @@ namespace ajv {
     {
         m_items = other.m_items;
         m_itemCount = other.m_itemCount;
+        m_memberIndexing = other.m_memberIndexing;
+        ResetMemberIndexes();
         return *this;
     }
 
     AJV_FN_NO_INLINE JsonView::JsonView(JsonView&& other) :
         m_items(std::move(other.m_items)),
-        m_itemCount(other.m_itemCount)
+        m_itemCount(other.m_itemCount),
+        m_memberIndexing(other.m_memberIndexing)
     {
         other.m_itemCount = 0;
+        other.ResetMemberIndexes();
     }
 
     AJV_FN_NO_INLINE JsonView& JsonView::operator=(JsonView&& other)
     {
         m_items = std::move(other.m_items);
         m_itemCount = other.m_itemCount;
+        m_memberIndexing = other.m_memberIndexing;
         other.m_itemCount = 0;
+        other.ResetMemberIndexes();
+        ResetMemberIndexes();
         return *this;
     }
 
@@ -195,8 +225,15 @@ namespace ajv {
             if (find != nullptr)
             {
                 auto len = strlen(find);
-                while (iname > 0)
+                for (int scanned = 0; iname > 0; scanned++)
                 {
+                    // none of the first few names match, look up the rest with the object's index
+                    if (scanned == m_memberIndexThreshold && m_memberIndexing)
+                    {
+                        iname = FindIndexedName(parent, find, len);
+                        break;
+                    }
+
                     auto check = m_items[iname].start + 1;
                     auto match = strncmp(check, find, len) == 0 && IsStartString(check[len]);
                     if (match) break;
@@ -228,6 +265,68 @@ namespace ajv {
         return -1;
     }
 
+    AJV_FN_NO_INLINE_(int) JsonView::FindIndexedName(int object, const char* find, size_t len) const
+    {
+        std::lock_guard<std::mutex> lock(m_memberIndexLock);
+
+        auto& index = m_memberIndexes[object];
+        if (index.empty()) index = BuildMemberIndex(object);
+
+        auto mask = index.size() - 1;
+        for (auto slot = HashName(find, len) & mask; index[slot] > 0; slot = (slot + 1) & mask)
+        {
+            auto& check = m_items[index[slot]];
+            auto match = (size_t)(check.end - check.start - 1) == len && strncmp(check.start + 1, find, len) == 0;
+            if (match) return index[slot];
+        }
+        return 0;
+    }
+
+    AJV_FN_NO_INLINE_(std::vector<int>) JsonView::BuildMemberIndex(int object) const
+    {
+        // open addressing, at most half full, holding the first of any duplicate names like the linear search does
+        size_t count = 0;
+        for (auto iname = m_items[object].firstInObject; iname > 0; iname = m_items[iname].nextInObject) count++;
+
+        size_t size = 2;
+        while (size < 2 * count) size *= 2;
+
+        std::vector<int> index(size, 0);
+        auto mask = size - 1;
+        for (auto iname = m_items[object].firstInObject; iname > 0; iname = m_items[iname].nextInObject)
+        {
+            auto name = m_items[iname].start + 1;
+            auto len = (size_t)(m_items[iname].end - name);
+
+            auto slot = HashName(name, len) & mask;
+            while (index[slot] > 0)
+            {
+                auto& check = m_items[index[slot]];
+                if ((size_t)(check.end - check.start - 1) == len && strncmp(check.start + 1, name, len) == 0) break;
+                slot = (slot + 1) & mask;
+            }
+            if (index[slot] == 0) index[slot] = iname;
+        }
+        return index;
+    }
+
+    AJV_FN_NO_INLINE_(size_t) JsonView::HashName(const char* name, size_t len)
+    {
+        // FNV-1a
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < len; i++)
+        {
+            hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    AJV_FN_NO_INLINE_(void) JsonView::ResetMemberIndexes()
+    {
+        std::lock_guard<std::mutex> lock(m_memberIndexLock);
+        m_memberIndexes.clear();
+    }
+
     AJV_FN_NO_INLINE_(int) JsonView::Next(int item) const
     {
         if (item < 0 || item >= m_itemCount) return -1;
@@ -527,8 +626,40 @@ namespace ajv {
         return item;
     }
 
+#ifdef AJV_SSE2
+    inline int FirstBitSet(unsigned int mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
     AJV_FN_NO_INLINE_(const char*) JsonView::SkipWhiteSpace(const char* psz, const char* zend)
     {
+#ifdef AJV_SSE2
+        // Most values follow their separator directly, only look at 16 bytes once there is whitespace to skip.
+        if (psz < zend && IsWhiteSpace(*psz))
+        {
+            auto space = _mm_set1_epi8(' ');
+            auto tab = _mm_set1_epi8('\t');
+            auto newLine = _mm_set1_epi8('\n');
+            auto carriageReturn = _mm_set1_epi8('\r');
+            while (psz + 16 <= zend)
+            {
+                auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psz));
+                auto white = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, newLine), _mm_cmpeq_epi8(chunk, carriageReturn)));
+                auto notWhite = ~(unsigned int)_mm_movemask_epi8(white) & 0xffff;
+                if (notWhite != 0) return psz + FirstBitSet(notWhite);
+                psz += 16;
+            }
+        }
+#endif
         while (psz < zend && IsWhiteSpace(*psz))
         {
             psz++;
@@ -536,6 +667,31 @@ namespace ajv {
         return psz;
     }
 
+    AJV_FN_NO_INLINE_(const char*) JsonView::SkipPlainStringChars(const char* psz, const char* zend)
+    {
+        // Skips printable ASCII other than '\"' and '\\', i.e. the characters ParseString accepts as they are.
+#ifdef AJV_SSE2
+        auto quote = _mm_set1_epi8('\"');
+        auto backslash = _mm_set1_epi8('\\');
+        auto space = _mm_set1_epi8(' ');
+        while (psz + 16 <= zend)
+        {
+            auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(psz));
+            // A signed compare also flags bytes >= 0x80, these go through the UTF-8 checks one character at a time.
+            auto special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                _mm_cmplt_epi8(chunk, space));
+            auto mask = (unsigned int)_mm_movemask_epi8(special);
+            if (mask != 0) return psz + FirstBitSet(mask);
+            psz += 16;
+        }
+#endif
+        while (psz < zend && (unsigned char)*psz >= ' ' && (unsigned char)*psz < 0x80 && *psz != '\"' && *psz != '\\')
+        {
+            psz++;
+        }
+        return psz;
+    }
+
     AJV_FN_NO_INLINE_(const char*) JsonView::SkipCharsInRange(const char* psz, const char* zend, char ch1, char ch2)
     {
         while (psz < zend && *psz >= ch1 && *psz <= ch2)
@@ -665,8 +821,11 @@ namespace ajv {
         auto item = InitItem(psz++);
         if (item <= m_itemEnd) return ParseError(psz, zend);
 
-        while (psz < zend && *psz != '\"')
+        while (psz < zend)
         {
+            psz = SkipPlainStringChars(psz, zend);
+            if (psz >= zend || *psz == '\"') break;
+
             auto ch = *psz;
             if (ch == '\\')
             {
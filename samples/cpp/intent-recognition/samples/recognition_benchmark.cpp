@@ -0,0 +1,405 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See https://aka.ms/csspeech/license for the full license information.
+//
+#include "intent_recognizer/stdafx.h"
+
+#if !defined(_MSC_VER)
+#include <sys/resource.h>
+#else
+#include <windows.h>
+#include <psapi.h>
+#undef min
+#undef max
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <ajv.h>
+#include <intentapi_cxx.h>
+
+#include "catch2/catch_amalgamated.hpp"
+
+using namespace Microsoft::SpeechSDK::Standalone::Intent;
+
+// Throughput and latency of IntentRecognizer on a synthetic model, written to a JSON file so that results of
+// different builds can be compared. Hidden from the default run, use "[benchmark]" on the command line and build in
+// Release. The model and the run are configured with environment variables:
+//
+//   INTENT_BENCHMARK_INTENTS      number of intents (default 50)
+//   INTENT_BENCHMARK_PATTERNS     patterns per intent (default 4)
+//   INTENT_BENCHMARK_LISTS        number of strict list entities (default 4)
+//   INTENT_BENCHMARK_PHRASES      phrases per list entity (default 1000)
+//   INTENT_BENCHMARK_UTTERANCES   number of synthetic utterances (default 2000)
+//   INTENT_BENCHMARK_CORPUS       file with one utterance per line, replayed instead of the synthetic utterances
+//   INTENT_BENCHMARK_THREADS      highest thread count, runs use 1, 2, 4, ... up to it (default: hardware threads)
+//   INTENT_BENCHMARK_OUTPUT       JSON result file (default intent_benchmark.json)
+
+namespace {
+
+// Counts every allocation of the process, so the benchmark can report allocations per utterance.
+std::atomic<size_t> AllocationCount{ 0 };
+
+}
+
+void* operator new(size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+
+struct BenchmarkConfig
+{
+    size_t Intents;
+    size_t PatternsPerIntent;
+    size_t Lists;
+    size_t PhrasesPerList;
+    size_t Utterances;
+    std::string Corpus;
+    size_t MaxThreads;
+    std::string Output;
+};
+
+size_t GetSizeSetting(const char* name, size_t defaultValue)
+{
+#pragma warning(suppress : 4996) // getenv
+    auto value = getenv(name);
+    return value != nullptr && *value != '\0' ? static_cast<size_t>(std::strtoull(value, nullptr, 10)) : defaultValue;
+}
+
+std::string GetStringSetting(const char* name, const std::string& defaultValue)
+{
+#pragma warning(suppress : 4996) // getenv
+    auto value = getenv(name);
+    return value != nullptr && *value != '\0' ? value : defaultValue;
+}
+
+BenchmarkConfig ReadBenchmarkConfig()
+{
+    BenchmarkConfig config;
+    config.Intents = std::max<size_t>(1, GetSizeSetting("INTENT_BENCHMARK_INTENTS", 50));
+    config.PatternsPerIntent = std::max<size_t>(1, GetSizeSetting("INTENT_BENCHMARK_PATTERNS", 4));
+    config.Lists = std::max<size_t>(1, GetSizeSetting("INTENT_BENCHMARK_LISTS", 4));
+    config.PhrasesPerList = std::max<size_t>(1, GetSizeSetting("INTENT_BENCHMARK_PHRASES", 1000));
+    config.Utterances = std::max<size_t>(1, GetSizeSetting("INTENT_BENCHMARK_UTTERANCES", 2000));
+    config.Corpus = GetStringSetting("INTENT_BENCHMARK_CORPUS", "");
+    config.MaxThreads = std::max<size_t>(1, GetSizeSetting("INTENT_BENCHMARK_THREADS", std::thread::hardware_concurrency()));
+    config.Output = GetStringSetting("INTENT_BENCHMARK_OUTPUT", "intent_benchmark.json");
+    return config;
+}
+
+size_t GetPeakResidentSetKb()
+{
+#ifdef _MSC_VER
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        // Linux reports kilobytes, macOS bytes.
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+        return static_cast<size_t>(usage.ru_maxrss);
+#endif
+    }
+    return 0;
+#endif
+}
+
+// Utterances are built from a small vocabulary so that patterns share words, like real command sets do.
+class SyntheticModel
+{
+public:
+    explicit SyntheticModel(const BenchmarkConfig& config) : m_random(42)
+    {
+        for (size_t i = 0; i < 200; i++)
+        {
+            m_words.push_back("word" + std::to_string(i));
+        }
+
+        m_model = PatternMatchingModel::FromModelId("benchmark");
+        for (size_t list = 0; list < config.Lists; list++)
+        {
+            PatternMatchingEntity entity{ "list" + std::to_string(list), EntityType::List, EntityMatchMode::Strict, {} };
+            for (size_t phrase = 0; phrase < config.PhrasesPerList; phrase++)
+            {
+                entity.Phrases.push_back(Words(1 + phrase % 3) + " item" + std::to_string(phrase));
+            }
+            m_model->Entities.push_back(entity);
+        }
+        m_model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
+
+        for (size_t intent = 0; intent < config.Intents; intent++)
+        {
+            PatternMatchingIntent patterns{ {}, "intent" + std::to_string(intent) };
+            for (size_t pattern = 0; pattern < config.PatternsPerIntent; pattern++)
+            {
+                auto lead = Words(2);
+                auto list = "list" + std::to_string(Pick(config.Lists));
+                switch (pattern % 4)
+                {
+                case 0:
+                    patterns.Phrases.push_back(lead + " {" + list + "}");
+                    m_templates.push_back({ lead + " ", list, "" });
+                    break;
+                case 1:
+                    patterns.Phrases.push_back(lead + " [please] {" + list + "} now");
+                    m_templates.push_back({ lead + " please ", list, " now" });
+                    break;
+                case 2:
+                    patterns.Phrases.push_back(lead + " to {number}");
+                    m_templates.push_back({ lead + " to ", "", std::to_string(Pick(1000)) });
+                    break;
+                default:
+                    patterns.Phrases.push_back(lead + " {anything}");
+                    m_templates.push_back({ lead + " ", "", Words(3) });
+                    break;
+                }
+            }
+            m_model->Intents.push_back(patterns);
+        }
+    }
+
+    std::shared_ptr<PatternMatchingModel> GetModel() const { return m_model; }
+
+    std::vector<std::string> CreateUtterances(size_t count)
+    {
+        std::vector<std::string> utterances;
+        for (size_t i = 0; i < count; i++)
+        {
+            // One in four utterances matches nothing.
+            if (i % 4 == 3)
+            {
+                utterances.push_back(Words(5));
+                continue;
+            }
+
+            auto& utteranceTemplate = m_templates[Pick(m_templates.size())];
+            auto utterance = utteranceTemplate.Prefix;
+            if (!utteranceTemplate.List.empty())
+            {
+                auto& phrases = FindEntity(utteranceTemplate.List).Phrases;
+                utterance += phrases[Pick(phrases.size())];
+            }
+            utterances.push_back(utterance + utteranceTemplate.Suffix);
+        }
+        return utterances;
+    }
+
+private:
+
+    struct UtteranceTemplate
+    {
+        std::string Prefix;
+        std::string List;
+        std::string Suffix;
+    };
+
+    size_t Pick(size_t count)
+    {
+        return std::uniform_int_distribution<size_t>(0, count - 1)(m_random);
+    }
+
+    std::string Words(size_t count)
+    {
+        std::string words;
+        for (size_t i = 0; i < count; i++)
+        {
+            words += (i > 0 ? " " : "") + m_words[Pick(m_words.size())];
+        }
+        return words;
+    }
+
+    const PatternMatchingEntity& FindEntity(const std::string& id) const
+    {
+        return *std::find_if(m_model->Entities.begin(), m_model->Entities.end(), [&id](const PatternMatchingEntity& entity) { return entity.Id == id; });
+    }
+
+    std::mt19937 m_random;
+    std::vector<std::string> m_words;
+    std::vector<UtteranceTemplate> m_templates;
+    std::shared_ptr<PatternMatchingModel> m_model;
+};
+
+std::vector<std::string> ReadCorpus(const std::string& path)
+{
+    std::vector<std::string> utterances;
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty())
+        {
+            utterances.push_back(line);
+        }
+    }
+    return utterances;
+}
+
+struct BenchmarkRun
+{
+    size_t Threads;
+    double LoadMs;
+    size_t Utterances;
+    size_t Matched;
+    double Seconds;
+    double LatencyP50Us;
+    double LatencyP99Us;
+    double AllocationsPerUtterance;
+    size_t PeakResidentSetKb;
+};
+
+double Percentile(const std::vector<double>& sorted, double percentile)
+{
+    auto index = static_cast<size_t>(percentile * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Every thread replays the whole corpus, each utterance waits for its result so latency includes the hand-off to the
+// recognizer's workers.
+BenchmarkRun RunCorpus(const std::shared_ptr<PatternMatchingModel>& model, const std::vector<std::string>& utterances, size_t threadCount)
+{
+    // The first recognition builds the model, it is measured on its own.
+    auto loadStart = std::chrono::steady_clock::now();
+    auto recognizer = IntentRecognizer::FromLanguage("en-US", threadCount);
+    recognizer->ApplyLanguageModels({ model });
+    recognizer->RecognizeOnceAsync(utterances.front()).get();
+    auto loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+
+    std::vector<std::vector<double>> latencies(threadCount);
+    std::atomic<size_t> matched{ 0 };
+    std::vector<std::thread> threads;
+
+    auto allocationsBefore = AllocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]()
+            {
+                auto& threadLatencies = latencies[t];
+                threadLatencies.reserve(utterances.size());
+                size_t threadMatched = 0;
+                for (size_t i = 0; i < utterances.size(); i++)
+                {
+                    // Threads start at different places so they don't all recognize the same utterance at once.
+                    auto& utterance = utterances[(i + t * utterances.size() / threadCount) % utterances.size()];
+                    auto utteranceStart = std::chrono::steady_clock::now();
+                    auto result = recognizer->RecognizeOnceAsync(utterance).get();
+                    threadLatencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - utteranceStart).count());
+                    threadMatched += result != nullptr && !result->IntentId.empty() ? 1 : 0;
+                }
+                matched += threadMatched;
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto allocations = AllocationCount.load() - allocationsBefore;
+
+    std::vector<double> allLatencies;
+    for (auto& threadLatencies : latencies)
+    {
+        allLatencies.insert(allLatencies.end(), threadLatencies.begin(), threadLatencies.end());
+    }
+    std::sort(allLatencies.begin(), allLatencies.end());
+
+    BenchmarkRun run;
+    run.Threads = threadCount;
+    run.LoadMs = loadMs;
+    run.Utterances = allLatencies.size();
+    run.Matched = matched;
+    run.Seconds = seconds;
+    run.LatencyP50Us = Percentile(allLatencies, 0.50);
+    run.LatencyP99Us = Percentile(allLatencies, 0.99);
+    run.AllocationsPerUtterance = static_cast<double>(allocations) / allLatencies.size();
+    run.PeakResidentSetKb = GetPeakResidentSetKb();
+    return run;
+}
+
+}
+
+TEST_CASE("IntentRecognizer::Benchmarks::Recognition suite", "[.][benchmark]")
+{
+    auto config = ReadBenchmarkConfig();
+
+    SyntheticModel synthetic(config);
+    auto utterances = config.Corpus.empty() ? synthetic.CreateUtterances(config.Utterances) : ReadCorpus(config.Corpus);
+    REQUIRE(!utterances.empty());
+
+    std::vector<BenchmarkRun> runs;
+    for (size_t threads = 1; ; threads = std::min(threads * 2, config.MaxThreads))
+    {
+        runs.push_back(RunCorpus(synthetic.GetModel(), utterances, threads));
+        auto& run = runs.back();
+        REQUIRE(run.Matched > 0);
+        std::cout << std::fixed << std::setprecision(1)
+            << "Recognition suite, " << run.Threads << " thread(s): " << run.Utterances / run.Seconds << " utterances/s, p50 "
+            << run.LatencyP50Us << " us, p99 " << run.LatencyP99Us << " us, " << run.AllocationsPerUtterance
+            << " allocations/utterance, peak RSS " << run.PeakResidentSetKb << " KB\n";
+        if (threads == config.MaxThreads)
+        {
+            break;
+        }
+    }
+
+    auto json = ajv::json::Build();
+    json["config"]["intents"] = config.Intents;
+    json["config"]["patternsPerIntent"] = config.PatternsPerIntent;
+    json["config"]["lists"] = config.Lists;
+    json["config"]["phrasesPerList"] = config.PhrasesPerList;
+    json["config"]["corpus"] = config.Corpus.empty() ? "synthetic" : config.Corpus;
+    json["config"]["utterances"] = utterances.size();
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        auto writer = json["runs"][static_cast<int>(i)];
+        writer["threads"] = runs[i].Threads;
+        writer["loadMs"] = runs[i].LoadMs;
+        writer["utterances"] = runs[i].Utterances;
+        writer["matched"] = runs[i].Matched;
+        writer["seconds"] = runs[i].Seconds;
+        writer["utterancesPerSecond"] = runs[i].Utterances / runs[i].Seconds;
+        writer["latencyP50Us"] = runs[i].LatencyP50Us;
+        writer["latencyP99Us"] = runs[i].LatencyP99Us;
+        writer["allocationsPerUtterance"] = runs[i].AllocationsPerUtterance;
+        writer["peakResidentSetKb"] = runs[i].PeakResidentSetKb;
+    }
+
+    std::ofstream output(config.Output);
+    output << json.AsJson() << "\n";
+    REQUIRE(output.good());
+    std::cout << "Recognition suite results written to " << config.Output << "\n";
+}
@@ -4,6 +4,11 @@
 //
 #include "intent_recognizer/stdafx.h"
 
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 #include <speechapi_cxx.h> // from Speech SDK
 #include <intentapi_cxx.h> // from this project
 
@@ -693,6 +698,41 @@ TEST_CASE("IntentRecognizer::PatternMatching::ListEntity", "[en]")
         RequireNoEntity(intentResult, "appName");
     }
 
+    SECTION("ListEntity with many phrases")
+    {
+        // Large lists are normalized in parts on the worker threads, the result must not depend on that.
+        auto model = PatternMatchingModel::FromModelId("MyTestModel");
+        std::vector<std::shared_ptr<LanguageUnderstandingModel>> models;
+
+        std::vector<std::string> phrases;
+        for (int i = 0; i < 10000; i++)
+        {
+            phrases.push_back("App  " + std::to_string(i));
+        }
+        phrases.push_back("the very long application name");
+
+        model->Intents.push_back({ {"Open {appName} now"}, "Open" });
+        model->Entities.push_back({ "appName", EntityType::List, EntityMatchMode::Strict, phrases });
+        models.push_back(model);
+        intentRecognizer->ApplyLanguageModels(models);
+
+        auto intentResult = intentRecognizer->RecognizeOnceAsync("Open app 0 now").get();
+        RequireIntentId(intentResult, "Open");
+        RequireEntity(intentResult, "appName", "app 0");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open app 9999 now").get();
+        RequireIntentId(intentResult, "Open");
+        RequireEntity(intentResult, "appName", "app 9999");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open the very long application name now").get();
+        RequireIntentId(intentResult, "Open");
+        RequireEntity(intentResult, "appName", "the very long application name");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open app 10000 now").get();
+        RequireIntentId(intentResult, "");
+
+        // Invalid patterns are still reported by ApplyLanguageModels.
+        model->Intents.push_back({ {"Close {appName"}, "Close" });
+        REQUIRE_THROWS_AS(intentRecognizer->ApplyLanguageModels(models), std::invalid_argument);
+    }
+
     SECTION("ListEntity fuzzy mode")
     {
         std::string modelId = "MyTestModel";
@@ -791,6 +831,40 @@ TEST_CASE("IntentRecognizer::PatternMatching::ListEntity", "[en]")
         RequireEntity(intentResult, "list", "left shift");
         RequireEntity(intentResult, "any", "left arrow");
     }
+
+    SECTION("Large strict lists")
+    {
+        std::string modelId = "MyTestModel";
+        auto model = PatternMatchingModel::FromModelId(modelId);
+        std::vector<std::shared_ptr<LanguageUnderstandingModel>> models;
+
+        std::vector<std::string> phrases;
+        for (int i = 0; i < 5000; i++)
+        {
+            phrases.push_back("contact " + std::to_string(i) + " mobile");
+        }
+        phrases.push_back("Contact Zero");
+        phrases.push_back("contact zero home");
+
+        model->Intents.push_back({ {"call {contact} now"}, "Call" });
+        models.push_back(model);
+        model->Entities.push_back({ "contact", EntityType::List, EntityMatchMode::Strict, phrases });
+        intentRecognizer->ApplyLanguageModels(models);
+
+        auto intentResult = intentRecognizer->RecognizeOnceAsync("call contact 4999 mobile now").get();
+        RequireIntentId(intentResult, "Call");
+        RequireEntity(intentResult, "contact", "contact 4999 mobile");
+        intentResult = intentRecognizer->RecognizeOnceAsync("call CONTACT ZERO now").get();
+        RequireIntentId(intentResult, "Call");
+        RequireEntity(intentResult, "contact", "contact zero");
+        intentResult = intentRecognizer->RecognizeOnceAsync("call contact zero home now").get();
+        RequireIntentId(intentResult, "Call");
+        RequireEntity(intentResult, "contact", "contact zero home");
+        intentResult = intentRecognizer->RecognizeOnceAsync("call contact 5000 mobile now").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("call someone else now").get();
+        RequireIntentId(intentResult, "");
+    }
 }
 
 TEST_CASE("IntentRecognizer::PatternMatching::Entity priority", "[en]")
@@ -867,6 +941,257 @@ TEST_CASE("IntentRecognizer::PatternMatching::Model from JSON file", "[en]")
         RequireIntentId(intentResult, "Brew");
         RequireEntity(intentResult, "number", "5");
     }
+
+    SECTION("Models from JSON streams are the same as from the file, invalid JSON gives no model")
+    {
+        std::ifstream file(INTENT_JSON_FILE);
+        std::string json{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        auto fromFile = PatternMatchingModel::FromJSONFile(INTENT_JSON_FILE);
+        std::istringstream stream(json);
+        auto fromStream = PatternMatchingModel::FromJSONFileStream(stream);
+        REQUIRE(fromFile != nullptr);
+        REQUIRE(fromStream != nullptr);
+        REQUIRE(fromStream->GetModelId() == fromFile->GetModelId());
+        REQUIRE(fromStream->Intents.size() == fromFile->Intents.size());
+        for (size_t i = 0; i < fromFile->Intents.size(); i++)
+        {
+            REQUIRE(fromStream->Intents[i].Id == fromFile->Intents[i].Id);
+            REQUIRE(fromStream->Intents[i].Phrases == fromFile->Intents[i].Phrases);
+        }
+        REQUIRE(fromStream->Entities.size() == fromFile->Entities.size());
+        for (size_t i = 0; i < fromFile->Entities.size(); i++)
+        {
+            REQUIRE(fromStream->Entities[i].Id == fromFile->Entities[i].Id);
+            REQUIRE(fromStream->Entities[i].Type == fromFile->Entities[i].Type);
+            REQUIRE(fromStream->Entities[i].Phrases == fromFile->Entities[i].Phrases);
+        }
+
+        for (auto invalid : { json.substr(0, json.size() / 2), json + "}", std::string("[]"), std::string() })
+        {
+            std::istringstream invalidStream(invalid);
+            REQUIRE(PatternMatchingModel::FromJSONFileStream(invalidStream) == nullptr);
+        }
+    }
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Compiled model file", "[en]")
+{
+    const std::string compiledFile = "compiled_model_test.bin";
+
+    auto model = PatternMatchingModel::FromModelId("MyTestModel");
+    model->Intents.push_back({ {"Open {appName}", "Start {appName} [please]"}, "Open" });
+    model->Intents.push_back({ {"Set volume to {number}"}, "Volume" });
+    model->Intents.push_back({ {"Search for {query}"}, "Search" });
+    model->Entities.push_back({ "appName", EntityType::List, EntityMatchMode::Strict, {"Microsoft Word", "visual  studio", "visual studio code", "  "} });
+    model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
+    model->Entities.push_back({ "query", EntityType::Any, EntityMatchMode::Basic, {} });
+    model->SaveCompiledFile(compiledFile);
+
+    auto compiled = PatternMatchingModel::FromCompiledFile(compiledFile);
+    REQUIRE(compiled != nullptr);
+    REQUIRE(compiled->GetModelId() == "MyTestModel");
+    REQUIRE(compiled->Intents.size() == 3);
+    REQUIRE(compiled->Intents[0].Phrases.size() == 2);
+    REQUIRE(compiled->Entities.size() == 3);
+    // The list phrases stay in the compiled file.
+    REQUIRE(compiled->Entities[0].Phrases.empty());
+
+    SECTION("Compiled models recognize like the model they were compiled from")
+    {
+        auto recognizer = IntentRecognizer::FromLanguage();
+        auto compiledRecognizer = IntentRecognizer::FromLanguage();
+        recognizer->ApplyLanguageModels({ model });
+        compiledRecognizer->ApplyLanguageModels({ compiled });
+
+        for (auto& utterance : { "open microsoft word", "Start Visual Studio Code please", "open visual", "open notepad",
+            "set volume to twenty five", "search for the weather", "something else" })
+        {
+            auto expected = recognizer->RecognizeOnceAsync(utterance).get();
+            auto actual = compiledRecognizer->RecognizeOnceAsync(utterance).get();
+            REQUIRE(actual->IntentId == expected->IntentId);
+            REQUIRE(actual->GetEntities() == expected->GetEntities());
+        }
+
+        auto intentResult = compiledRecognizer->RecognizeOnceAsync("Start Visual Studio Code please").get();
+        RequireIntentId(intentResult, "Open");
+        RequireEntity(intentResult, "appName", "visual studio code");
+    }
+
+    SECTION("Phrases added after loading extend the compiled list")
+    {
+        compiled->Entities[0].Phrases.push_back("notepad");
+        auto recognizer = IntentRecognizer::FromLanguage();
+        recognizer->ApplyLanguageModels({ compiled });
+
+        auto intentResult = recognizer->RecognizeOnceAsync("open notepad").get();
+        RequireIntentId(intentResult, "Open");
+        RequireEntity(intentResult, "appName", "notepad");
+        intentResult = recognizer->RecognizeOnceAsync("open microsoft word").get();
+        RequireEntity(intentResult, "appName", "microsoft word");
+
+        // Saving a loaded model keeps both.
+        compiled->SaveCompiledFile(compiledFile);
+        auto recompiled = PatternMatchingModel::FromCompiledFile(compiledFile);
+        REQUIRE(recompiled != nullptr);
+        recognizer->ApplyLanguageModels({ recompiled });
+        intentResult = recognizer->RecognizeOnceAsync("open notepad").get();
+        RequireEntity(intentResult, "appName", "notepad");
+        intentResult = recognizer->RecognizeOnceAsync("open visual studio").get();
+        RequireEntity(intentResult, "appName", "visual studio");
+    }
+
+    SECTION("Phrases of the compiled list can be removed")
+    {
+        auto recognizer = IntentRecognizer::FromLanguage();
+        recognizer->ApplyLanguageModels({ compiled });
+        REQUIRE(recognizer->UpdateListEntity("MyTestModel", "appName", { "Microsoft Word" }, { "notepad" }));
+
+        auto intentResult = recognizer->RecognizeOnceAsync("open microsoft word").get();
+        RequireIntentId(intentResult, "");
+        intentResult = recognizer->RecognizeOnceAsync("open notepad").get();
+        RequireEntity(intentResult, "appName", "notepad");
+        intentResult = recognizer->RecognizeOnceAsync("open visual studio").get();
+        RequireEntity(intentResult, "appName", "visual studio");
+
+        REQUIRE(recognizer->UpdateListEntity("MyTestModel", "appName", {}, { "microsoft word" }));
+        intentResult = recognizer->RecognizeOnceAsync("open microsoft word").get();
+        RequireEntity(intentResult, "appName", "microsoft word");
+    }
+
+    SECTION("Files that are not compiled models are rejected")
+    {
+        {
+            std::ofstream file(compiledFile, std::ios::binary | std::ios::trunc);
+            file << "{ \"name\": \"not a compiled model\" }";
+        }
+        REQUIRE(PatternMatchingModel::FromCompiledFile(compiledFile) == nullptr);
+        REQUIRE(PatternMatchingModel::FromCompiledFile("does_not_exist.bin") == nullptr);
+    }
+
+    std::remove(compiledFile.c_str());
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Model updates", "[en]")
+{
+    auto intentRecognizer = IntentRecognizer::FromLanguage();
+
+    auto model = PatternMatchingModel::FromModelId("MyTestModel");
+    model->Intents.push_back({ {"Open {appName}"}, "Open" });
+    model->Intents.push_back({ {"Close {appName}"}, "Close" });
+    model->Entities.push_back({ "appName", EntityType::List, EntityMatchMode::Strict, {"microsoft word", "visual studio"} });
+    model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
+    intentRecognizer->ApplyLanguageModels({ model });
+
+    SECTION("List entity phrases")
+    {
+        REQUIRE(intentRecognizer->UpdateListEntity("MyTestModel", "appName", { "Visual  Studio" }, { "Notepad" }));
+
+        auto intentResult = intentRecognizer->RecognizeOnceAsync("Open visual studio").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open notepad").get();
+        RequireIntentId(intentResult, "Open");
+        RequireEntity(intentResult, "appName", "notepad");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open microsoft word").get();
+        RequireEntity(intentResult, "appName", "microsoft word");
+
+        // Enough phrases to move them into the part of the list that copies share.
+        std::vector<std::string> added;
+        for (int i = 0; i < 5000; i++)
+        {
+            added.push_back("app " + std::to_string(i));
+        }
+        REQUIRE(intentRecognizer->UpdateListEntity("MyTestModel", "appName", {}, added));
+        REQUIRE(intentRecognizer->UpdateListEntity("MyTestModel", "appName", { "app 1", "notepad" }, { "visual studio" }));
+
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open app 4999").get();
+        RequireEntity(intentResult, "appName", "app 4999");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open app 1").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open notepad").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open visual studio").get();
+        RequireEntity(intentResult, "appName", "visual studio");
+
+        REQUIRE(intentRecognizer->UpdateListEntity("MyTestModel", "appName", {}, { "app 1" }));
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open app 1").get();
+        RequireEntity(intentResult, "appName", "app 1");
+
+        // Only list entities of applied models can be updated.
+        REQUIRE_FALSE(intentRecognizer->UpdateListEntity("MyTestModel", "number", {}, { "one" }));
+        REQUIRE_FALSE(intentRecognizer->UpdateListEntity("MyTestModel", "missing", {}, { "one" }));
+        REQUIRE_FALSE(intentRecognizer->UpdateListEntity("OtherModel", "appName", {}, { "one" }));
+    }
+
+    SECTION("Intents and their phrases")
+    {
+        REQUIRE(intentRecognizer->AddIntentPhrases("MyTestModel", { {"Launch {appName}"}, "Open" }));
+        auto intentResult = intentRecognizer->RecognizeOnceAsync("Launch visual studio").get();
+        RequireIntentId(intentResult, "Open");
+
+        REQUIRE(intentRecognizer->RemoveIntentPhrases("MyTestModel", "Open", { "Open {appName}" }));
+        REQUIRE_FALSE(intentRecognizer->RemoveIntentPhrases("MyTestModel", "Open", { "Open {appName}" }));
+        intentResult = intentRecognizer->RecognizeOnceAsync("Open visual studio").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Launch visual studio").get();
+        RequireIntentId(intentResult, "Open");
+
+        REQUIRE(intentRecognizer->ReplaceIntent("MyTestModel", { {"Shut {appName}", "Quit {appName}"}, "Close" }));
+        intentResult = intentRecognizer->RecognizeOnceAsync("Close visual studio").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Quit visual studio").get();
+        RequireIntentId(intentResult, "Close");
+        RequireEntity(intentResult, "appName", "visual studio");
+
+        REQUIRE(intentRecognizer->ReplaceIntent("MyTestModel", { {"Set volume to {number}"}, "Volume" }));
+        intentResult = intentRecognizer->RecognizeOnceAsync("Set volume to five").get();
+        RequireIntentId(intentResult, "Volume");
+        RequireEntity(intentResult, "number", "5");
+
+        REQUIRE(intentRecognizer->RemoveIntent("MyTestModel", "Close"));
+        REQUIRE_FALSE(intentRecognizer->RemoveIntent("MyTestModel", "Close"));
+        REQUIRE_FALSE(intentRecognizer->RemoveIntent("OtherModel", "Open"));
+        intentResult = intentRecognizer->RecognizeOnceAsync("Quit visual studio").get();
+        RequireIntentId(intentResult, "");
+
+        // Many removals rebuild the automaton from the intents that are left.
+        for (int i = 0; i < 20; i++)
+        {
+            REQUIRE(intentRecognizer->AddIntentPhrases("MyTestModel", { {"Go to page " + std::to_string(i)}, "Page" + std::to_string(i) }));
+        }
+        for (int i = 0; i < 20; i += 2)
+        {
+            REQUIRE(intentRecognizer->RemoveIntent("MyTestModel", "Page" + std::to_string(i)));
+        }
+        intentResult = intentRecognizer->RecognizeOnceAsync("Go to page 13").get();
+        RequireIntentId(intentResult, "Page13");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Go to page 12").get();
+        RequireIntentId(intentResult, "");
+        intentResult = intentRecognizer->RecognizeOnceAsync("Launch microsoft word").get();
+        RequireIntentId(intentResult, "Open");
+    }
+
+    SECTION("Recognitions see a model before or after an update")
+    {
+        std::atomic<bool> done{ false };
+        std::thread updater([&]() {
+            for (int i = 0; i < 200; i++)
+            {
+                intentRecognizer->UpdateListEntity("MyTestModel", "appName", {}, { "notepad" });
+                intentRecognizer->UpdateListEntity("MyTestModel", "appName", { "notepad" }, {});
+            }
+            done = true;
+        });
+
+        while (!done)
+        {
+            auto intentResult = intentRecognizer->RecognizeOnceAsync("Open notepad").get();
+            REQUIRE((intentResult->IntentId.empty() || intentResult->GetEntities().at("appName") == "notepad"));
+            intentResult = intentRecognizer->RecognizeOnceAsync("Open visual studio").get();
+            RequireEntity(intentResult, "appName", "visual studio");
+        }
+        updater.join();
+    }
 }
 
 TEST_CASE("IntentRecognizer::PatternMatching::Optional patterns", "[en]")
@@ -3742,6 +4067,233 @@ TEST_CASE("IntentRecognizer::PatternMatching::Resolve ties in priority based on
     RequireEntity(intentResult, "shareList", "share window list");
 }
 
+TEST_CASE("IntentRecognizer::PatternMatching::Patterns sharing a prefix", "[en]")
+{
+    auto intentRecognizer = IntentRecognizer::FromLanguage();
+
+    intentRecognizer->AddIntent("open the window", "OpenWindow");
+    intentRecognizer->AddIntent("open the door", "OpenDoor");
+    intentRecognizer->AddIntent("open the {thing}", "OpenThing");
+    intentRecognizer->AddIntent("open [the] settings", "OpenSettings");
+    intentRecognizer->AddIntent("open (left|right) panel", "OpenPanel");
+
+    auto intentResult = intentRecognizer->RecognizeOnceAsync("open the window").get();
+    RequireIntentId(intentResult, "OpenWindow");
+    intentResult = intentRecognizer->RecognizeOnceAsync("Open the door.").get();
+    RequireIntentId(intentResult, "OpenDoor");
+    intentResult = intentRecognizer->RecognizeOnceAsync("open the garage").get();
+    RequireIntentId(intentResult, "OpenThing");
+    RequireEntity(intentResult, "thing", "garage");
+    intentResult = intentRecognizer->RecognizeOnceAsync("open settings").get();
+    RequireIntentId(intentResult, "OpenSettings");
+    intentResult = intentRecognizer->RecognizeOnceAsync("open the settings").get();
+    RequireIntentId(intentResult, "OpenSettings");
+    intentResult = intentRecognizer->RecognizeOnceAsync("open right panel").get();
+    RequireIntentId(intentResult, "OpenPanel");
+    intentResult = intentRecognizer->RecognizeOnceAsync("close the window").get();
+    RequireIntentId(intentResult, "");
+
+    // Patterns added after matching started are picked up as well.
+    intentRecognizer->AddIntent("open the garage", "OpenGarage");
+    intentResult = intentRecognizer->RecognizeOnceAsync("open the garage").get();
+    RequireIntentId(intentResult, "OpenGarage");
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Patterns sharing an entity", "[en]")
+{
+    // Entity parses are shared by all patterns of an utterance, each pattern must still get the right values.
+    auto intentRecognizer = IntentRecognizer::FromLanguage();
+    auto model = PatternMatchingModel::FromModelId("MyTestModel");
+    std::vector<std::shared_ptr<LanguageUnderstandingModel>> models;
+
+    model->Intents.push_back({ {"call {contact} at {number}", "call {contact} [please]"}, "Call" });
+    model->Intents.push_back({ {"{contact} at {number}"}, "Contact" });
+    model->Intents.push_back({ {"{number} times", "call {number}"}, "Number" });
+    model->Intents.push_back({ {"call {contact} {number} times"}, "Repeat" });
+    model->Entities.push_back({ "contact", EntityType::List, EntityMatchMode::Strict, {"bob", "bob smith", "alice"} });
+    model->Entities.push_back({ "number", EntityType::PrebuiltInteger, EntityMatchMode::Basic, {} });
+    models.push_back(model);
+    intentRecognizer->ApplyLanguageModels(models);
+
+    auto intentResult = intentRecognizer->RecognizeOnceAsync("call bob smith at twenty two").get();
+    RequireIntentId(intentResult, "Call");
+    RequireEntity(intentResult, "contact", "bob smith");
+    RequireEntity(intentResult, "number", "22");
+    intentResult = intentRecognizer->RecognizeOnceAsync("call bob smith three times.").get();
+    RequireIntentId(intentResult, "Repeat");
+    RequireEntity(intentResult, "contact", "bob smith");
+    RequireEntity(intentResult, "number", "3");
+    intentResult = intentRecognizer->RecognizeOnceAsync("call alice please").get();
+    RequireIntentId(intentResult, "Call");
+    RequireEntity(intentResult, "contact", "alice");
+    intentResult = intentRecognizer->RecognizeOnceAsync("call forty two").get();
+    RequireIntentId(intentResult, "Number");
+    RequireEntity(intentResult, "number", "42");
+    intentResult = intentRecognizer->RecognizeOnceAsync("call carol at five").get();
+    RequireIntentId(intentResult, "");
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Concurrent recognition", "[en]")
+{
+    auto intentRecognizer = IntentRecognizer::FromLanguage();
+
+    intentRecognizer->AddIntent("open the {thing}", "OpenThing");
+    intentRecognizer->AddIntent("close the window", "CloseWindow");
+
+    // Start a batch of recognitions and keep adding intents while they run.
+    std::vector<std::future<std::shared_ptr<IntentRecognitionResult>>> openResults;
+    std::vector<std::future<std::shared_ptr<IntentRecognitionResult>>> closeResults;
+    for (int i = 0; i < 32; i++)
+    {
+        openResults.push_back(intentRecognizer->RecognizeOnceAsync("open the door"));
+        closeResults.push_back(intentRecognizer->RecognizeOnceAsync("close the window"));
+        intentRecognizer->AddIntent("turn " + std::to_string(i) + " {thing}", "Turn" + std::to_string(i));
+    }
+
+    for (auto& result : openResults)
+    {
+        auto intentResult = result.get();
+        RequireIntentId(intentResult, "OpenThing");
+        RequireEntity(intentResult, "thing", "door");
+    }
+    for (auto& result : closeResults)
+    {
+        RequireIntentId(result.get(), "CloseWindow");
+    }
+
+    auto intentResult = intentRecognizer->RecognizeOnceAsync("turn 31 the lights").get();
+    RequireIntentId(intentResult, "Turn31");
+    RequireEntity(intentResult, "thing", "the lights");
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Batch recognition", "[en]")
+{
+    auto workerThreads = GENERATE(as<size_t>{}, 1, 3);
+    auto intentRecognizer = IntentRecognizer::FromLanguage("en-US", workerThreads);
+
+    intentRecognizer->AddIntent("open the {thing}", "OpenThing");
+    intentRecognizer->AddIntent("close the window", "CloseWindow");
+
+    SECTION("Results are in input order")
+    {
+        std::vector<std::string> texts;
+        for (int i = 0; i < 10; i++)
+        {
+            texts.push_back("open the door " + std::to_string(i));
+            texts.push_back("close the window");
+            texts.push_back("something else");
+        }
+
+        auto results = intentRecognizer->RecognizeBatchAsync(texts).get();
+        REQUIRE(results.size() == texts.size());
+        for (int i = 0; i < 10; i++)
+        {
+            RequireIntentId(results[i * 3], "OpenThing");
+            RequireEntity(results[i * 3], "thing", "door " + std::to_string(i));
+            RequireIntentId(results[i * 3 + 1], "CloseWindow");
+            RequireIntentId(results[i * 3 + 2], "");
+        }
+    }
+
+    SECTION("Empty batch")
+    {
+        auto results = intentRecognizer->RecognizeBatchAsync({}).get();
+        REQUIRE(results.empty());
+    }
+
+    SECTION("Single recognitions use the same workers")
+    {
+        auto intentResult = intentRecognizer->RecognizeOnceAsync("close the window").get();
+        RequireIntentId(intentResult, "CloseWindow");
+    }
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Parallel model matching", "[en]")
+{
+    auto intentRecognizer = IntentRecognizer::FromLanguage("en-US", 3);
+
+    // Every model matches "close the window", models 2 and 4 exactly, model 5 with fewer bytes than the others.
+    std::vector<std::shared_ptr<LanguageUnderstandingModel>> models;
+    for (int i = 0; i < 6; i++)
+    {
+        auto index = std::to_string(i);
+        auto model = PatternMatchingModel::FromModelId("Model" + index);
+        model->Intents.push_back({ { "open the {thing}" }, "OpenThing" + index });
+        model->Intents.push_back({ { i == 5 ? "close {thing}" : "close the {thing}" }, "CloseThing" + index });
+        if (i == 2 || i == 4)
+        {
+            model->Intents.push_back({ { "close the window" }, "CloseWindow" + index });
+        }
+        models.push_back(model);
+    }
+    intentRecognizer->ApplyLanguageModels(models);
+
+    std::vector<std::string> texts = { "open the door", "close the window", "close the door", "something else" };
+    std::vector<std::shared_ptr<IntentRecognitionResult>> expected;
+    for (auto& text : texts)
+    {
+        expected.push_back(intentRecognizer->RecognizeOnceAsync(text).get());
+    }
+    RequireIntentId(expected[1], "CloseWindow2");
+    RequireAlternateCount(expected[1], 3);
+
+    SECTION("Results are the same as matching one model after the other")
+    {
+        intentRecognizer->SetParallelModelMatching(true);
+        for (int repeat = 0; repeat < 8; repeat++)
+        {
+            for (size_t i = 0; i < texts.size(); i++)
+            {
+                auto intentResult = intentRecognizer->RecognizeOnceAsync(texts[i]).get();
+                REQUIRE(intentResult->IntentId == expected[i]->IntentId);
+                REQUIRE(intentResult->GetDetailedResult() == expected[i]->GetDetailedResult());
+            }
+        }
+
+        auto results = intentRecognizer->RecognizeBatchAsync(texts).get();
+        REQUIRE(results.size() == texts.size());
+        for (size_t i = 0; i < texts.size(); i++)
+        {
+            REQUIRE(results[i]->GetDetailedResult() == expected[i]->GetDetailedResult());
+        }
+    }
+
+    SECTION("Stop at the first exact match")
+    {
+        auto parallel = GENERATE(false, true);
+        intentRecognizer->SetParallelModelMatching(parallel);
+        intentRecognizer->SetStopAtExactMatch(true);
+
+        auto intentResult = intentRecognizer->RecognizeOnceAsync("close the window").get();
+        RequireIntentId(intentResult, "CloseWindow2");
+        RequireAlternateCount(intentResult, 2);
+        REQUIRE(intentResult->GetDetailedResult().find("CloseThing5") == std::string::npos);
+
+        // Without an exact match every model is matched.
+        intentResult = intentRecognizer->RecognizeOnceAsync("close the door").get();
+        REQUIRE(intentResult->GetDetailedResult() == expected[2]->GetDetailedResult());
+    }
+}
+
+TEST_CASE("IntentRecognizer::PatternMatching::Detailed result of copies", "[en]")
+{
+    auto intentRecognizer = IntentRecognizer::FromLanguage();
+    intentRecognizer->AddIntent("open the {thing}", "OpenThing");
+    intentRecognizer->AddIntent("open the door", "OpenDoor");
+
+    // The detailed result is built on first access, copies made before and after must see the same one.
+    auto intentResult = intentRecognizer->RecognizeOnceAsync("open the door").get();
+    IntentRecognitionResult copyBefore(*intentResult);
+    auto detailedResult = intentResult->GetDetailedResult();
+    IntentRecognitionResult copyAfter(*intentResult);
+
+    REQUIRE(copyBefore.IntentId == "OpenDoor");
+    REQUIRE(copyBefore.GetDetailedResult() == detailedResult);
+    REQUIRE(copyAfter.GetDetailedResult() == detailedResult);
+    RequireAlternateCount(intentResult, 2);
+    REQUIRE(detailedResult.find("\"intentId\":\"OpenThing\"") != std::string::npos);
+}
+
 TEST_CASE("IntentRecognizer::PatternMatching::DE Punctuation", "[de][speech]")
 {
     REQUIRE(exists(INTENT_DEDE_UTTERANCE));